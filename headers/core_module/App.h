@@ -8,6 +8,21 @@ class App;
 class ButtonComponent;
 class TextboxComponent;
 class NotificationManager;
+class Compositor;
+class FrameProfiler;
+class TraceRecorder;
+class GlyphAtlas;
+class TileRenderer;
+class SpanWriter;
+class CoverageBlender;
+class PixelFormat;
+class CurveFlattener;
+class FixedPoint;
+class CanvasFormat;
+class SpanList;
+class ConicSpans;
+class Stroker;
+class DisplayList;
 class Colors;
 class House;
 class Tree;
@@ -25,6 +40,7 @@ class Sun;
 #include <list>
 #include <vector>
 #include <memory>
+#include <functional>
 
 // C standard library.
 #include <cstdio>
@@ -37,14 +53,29 @@ class Sun;
 #include <SDL_ttf.h>
 
 // Header files.
+#include "CanvasFormat.h"
 #include "Colors.h"
+#include "FixedPoint.h"
 #include "Utils.h"
 #include "ErrorHandler.h"
 #include "FontManager.h"
+#include "GlyphAtlas.h"
 #include "Notification.h"
 #include "NotificationManager.h"
+#include "Compositor.h"
+#include "FrameProfiler.h"
+#include "TraceRecorder.h"
 #include "Point.h"
+#include "SpanWriter.h"
+#include "CoverageBlender.h"
+#include "PixelFormat.h"
+#include "CurveFlattener.h"
+#include "SpanList.h"
+#include "ConicSpans.h"
+#include "Stroker.h"
+#include "TileRenderer.h"
 #include "Primitives.h"
+#include "DisplayList.h"
 #include "ButtonComponent.h"
 #include "TextboxComponent.h"
 #include "ImageComponent.h"
@@ -87,6 +118,7 @@ class App {
         SDL_Window* window;
         SDL_Surface* window_surface;
         SDL_Surface* drawing_surface;
+        SDL_Surface* paint_surface;
         bool running;
         int screen_width;
         int screen_height;
@@ -95,6 +127,19 @@ class App {
         std::string window_title;
         MouseState mouse_state = MouseState::NORMAL_MODE;
         NotificationManager *notification_manager = nullptr;
+        Compositor *compositor = nullptr;
+        TileRenderer *tile_renderer = nullptr;
+        bool show_damage_stats = false;
+        Uint32 last_stats_update = 0;
+
+        // Frame pacing: a frame is rendered only when the screen is invalidated or an
+        // animation is running, at most once per frame_interval milliseconds.
+        bool redraw_requested = true;
+        Uint32 frame_interval = 0;
+        Uint32 last_frame_time = 0;
+        void invalidate();
+        int get_frame_wait();
+        void wait_for_events();
 
         // General graphical interface attributes and methods.
         static float new_drawing_button_relative_x_percent;
@@ -121,15 +166,31 @@ class App {
         void render_menu_screen();
         void render_new_project_screen();
         void render_rendering_screen();
+        void repaint_canvas(const SDL_Rect& rect);
+        void compose_window(const SDL_Rect& rect, const SDL_Rect& canvas_rect);
+        SDL_Rect get_canvas_rect();
+#ifdef BRUSHY_PROFILER
+        SDL_Point get_profiler_hud_position();
+#endif
         bool recreate_drawing_surface(int new_width, int new_height);
 
+        // Paint layer attributes and methods (pencil, eraser and bucket).
+        static int paint_stroke_width;
+        bool paint_stroke_active = false;
+        SDL_Point last_paint_point = {0, 0};
+        void paint_stroke(int cx, int cy, Uint32 color);
+        void paint_fill(int cx, int cy, Uint32 color);
+
         // Drawing component list attributes.
-        std::list<Point> points;
-        std::list<Point> eraser_points;
-        std::list<Point> fill_points;
         std::list<std::array<Point,2>> lines;
         std::vector<std::unique_ptr<Shape>> shapes;
 
+        // Shapes compiled for the current canvas size and universe (see update_display_list).
+        DisplayList display_list;
+        int display_list_canvas_w = 0, display_list_canvas_h = 0;
+        int display_list_universe_w = 0, display_list_universe_h = 0;
+        void update_display_list();
+
         // Drag and drop functionality attributes.
         bool mouse_down = false;
         bool temporary_in_list = false;
@@ -0,0 +1,39 @@
+#ifndef CANVAS_FORMAT_H
+#define CANVAS_FORMAT_H
+
+#include <SDL.h>
+
+/**
+ * @brief The one pixel layout used by every canvas the renderer draws into.
+ *
+ * Canvas pixels are premultiplied ARGB8888: alpha in bits 24-31, then red, green
+ * and blue, each color channel already multiplied by alpha. The drawing surface,
+ * the paint layer and every view or scratch surface of the primitives use it, so
+ * the kernels hard-code these shifts instead of asking SDL_PixelFormat for masks.
+ * Colors are packed once, when they are chosen or loaded; conversion to another
+ * format only happens when the canvas is presented or exported.
+ */
+class CanvasFormat {
+    public:
+        static const Uint32 pixel_format = SDL_PIXELFORMAT_ARGB8888;
+
+        static const int alpha_shift = 24;
+        static const int red_shift = 16;
+        static const int green_shift = 8;
+        static const int blue_shift = 0;
+
+        static const Uint32 alpha_mask = 0xFF000000;
+        static const Uint32 opaque_black = 0xFF000000;
+        static const Uint32 transparent = 0x00000000;
+
+        static SDL_Surface* create_surface(int width, int height);
+        static SDL_Surface* convert(SDL_Surface* canvas, Uint32 target_format);
+
+        static Uint32 pack(Uint8 r, Uint8 g, Uint8 b, Uint8 a = SDL_ALPHA_OPAQUE);
+        static Uint32 pack(SDL_Color color);
+        static SDL_Color unpack(Uint32 pixel);
+
+        static void composite(SDL_Surface* layer, SDL_Surface* canvas, const SDL_Rect& rect);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include "App.h"
+
+/**
+ * @brief Tracks the damaged regions of the rendering screen.
+ *
+ * Mutations report the rectangle they touched (in canvas or window
+ * coordinates). Each frame the pending damage is frozen, clipped and
+ * merged, so the renderer only re-rasterizes and presents those areas.
+ */
+class Compositor {
+    public:
+        struct FrameStats {
+            float damaged_percent;      // Percentage of the canvas redrawn in the last frame.
+            float average_percent;      // Rolling average of damaged_percent.
+            int canvas_rects;           // Canvas rectangles redrawn in the last frame.
+            int window_rects;           // Window rectangles presented in the last frame.
+            int shapes_redrawn;         // Lines and shape commands re-rasterized in the last frame.
+        };
+
+        Compositor();
+
+        void damage_canvas(const SDL_Rect& rect);
+        void damage_window(const SDL_Rect& rect);
+        void damage_all();
+
+        bool has_pending_canvas_damage() const;
+        void begin_frame(int window_width, int window_height, const SDL_Rect& canvas_rect);
+        void end_frame();
+        void add_shapes_redrawn(int count);
+
+        const std::vector<SDL_Rect>& get_canvas_damage() const;
+        const std::vector<SDL_Rect>& get_window_damage() const;
+        const FrameStats& get_stats() const;
+        std::string get_stats_text() const;
+
+    private:
+        static const int max_rects = 16;
+        static const int history_size = 60;
+
+        std::vector<SDL_Rect> pending_canvas;
+        std::vector<SDL_Rect> pending_window;
+        bool pending_full;
+
+        std::vector<SDL_Rect> frame_canvas;
+        std::vector<SDL_Rect> frame_window;
+        int frame_canvas_area;
+        int frame_canvas_total;
+        int frame_shapes_redrawn;
+
+        FrameStats stats;
+        float history[history_size];
+        int history_count;
+        int history_index;
+
+        static void add_rect(std::vector<SDL_Rect>& rects, SDL_Rect rect);
+        static int rect_area(const SDL_Rect& rect);
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef CONIC_SPANS_H
+#define CONIC_SPANS_H
+
+#include "App.h"
+
+/**
+ * @brief Scanline extents of filled circles and ellipses.
+ *
+ * Each generator walks the conic once and writes one [xL, xR] run per row into a
+ * SpanList, top to bottom, which the caller fills (SpanList::fill) or keeps for
+ * later repaints. circle and ellipse cover the pixels of the aliased (Bresenham)
+ * outlines and everything inside them; rotated_ellipse takes the pixels whose
+ * centers lie inside the ellipse.
+ */
+class ConicSpans {
+    public:
+        static void circle(SpanList& spans, int cx, int cy, int radius);
+        static void ellipse(SpanList& spans, int cx, int cy, int rx, int ry);
+        static void rotated_ellipse(SpanList& spans, int cx, int cy, int rx, int ry, float angle_rad);
+
+        static int half_width(long long radius_sq, long long dy);
+};
+
+#endif
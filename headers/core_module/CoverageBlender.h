@@ -0,0 +1,36 @@
+#ifndef COVERAGE_BLENDER_H
+#define COVERAGE_BLENDER_H
+
+#include "App.h"
+
+/**
+ * @brief Blends one solid color over canvas pixels by a coverage value.
+ *
+ * The color is packed once, when the blender is created for a primitive. Each
+ * blend then works directly on the packed pixel: the red/blue and alpha/green byte
+ * pairs are weighted in two 16-bit lanes (0x00FF00FF masks) with 8-bit fixed-point
+ * weights. Pixels are premultiplied ARGB8888 (CanvasFormat), so the result is a
+ * premultiplied source-over: source times coverage plus destination times one
+ * minus coverage times source alpha, alpha channel included.
+ */
+class CoverageBlender {
+    public:
+        explicit CoverageBlender(Uint32 color);
+        explicit CoverageBlender(SDL_Color color);
+
+        void blend(Uint32* pixel, Uint8 coverage) const;
+        void blend(Uint32* pixel, float coverage) const;
+        void blend_run(Uint32* row, int x0, const Uint8* coverage, int count) const;
+
+        static Uint8 to_coverage(float coverage);
+
+    private:
+        Uint32 packed_rb;       // Source red/blue lanes (mask 0x00FF00FF).
+        Uint32 packed_ag;       // Source alpha/green lanes, shifted down by 8 bits.
+        Uint32 pixel;           // Source pixel, written as is at full coverage when opaque.
+        int alpha_scale;        // Source alpha in the range 0-256.
+
+        void init(Uint32 color);
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef CURVE_FLATTENER_H
+#define CURVE_FLATTENER_H
+
+#include "App.h"
+
+/**
+ * @brief Turns cubic Bézier curves into polylines.
+ *
+ * The number of segments comes from Wang's formula, which bounds the distance
+ * between the curve and its polyline by the given tolerance (in pixels). The
+ * points are then generated by forward differencing: three additions per point,
+ * no recursion and no allocation besides the caller's buffer, which is meant to
+ * be reused between calls. Stroking (Primitives::draw_polyline) and filling
+ * (Primitives::fill_polygon) both consume the same buffer.
+ */
+class CurveFlattener {
+    public:
+        static constexpr float default_tolerance = 0.5f;
+        static const int max_segments = 1024;
+
+        static int cubic_segments(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3, float tolerance = default_tolerance);
+        static void flatten_cubic(std::vector<SDL_FPoint>& polyline, float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3, float tolerance = default_tolerance);
+};
+
+#endif
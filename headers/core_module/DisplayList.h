@@ -0,0 +1,104 @@
+#ifndef DISPLAY_LIST_H
+#define DISPLAY_LIST_H
+
+#include "App.h"
+
+// Declared in Primitives.h, which may be the header being processed when this one is reached.
+enum class FillRule;
+
+/**
+ * @brief Shapes compiled into a flat list of canvas-space drawing commands.
+ *
+ * Shape::compile converts the universe coordinates, evaluates the trigonometry and
+ * flattens the curves once, and records the Primitives calls it would make as plain
+ * structs. Replaying the list is a loop over those structs with a switch per command:
+ * no virtual calls and no coordinate math. Polygon vertices and polyline or stroke
+ * points live in shared pools that the commands index.
+ *
+ * Commands are grouped per shape, so the owner can drop the last shapes and append
+ * new ones without recompiling the others. Every command carries conservative canvas
+ * bounds, used to cull it against the clip rectangle and to bin it into tiles.
+ *
+ * The replay order groups commands of the same kind (triangles with triangles,
+ * ellipses with ellipses...) to keep one kernel hot at a time. A command only moves
+ * ahead of commands whose bounds it does not overlap, so the pixels are the same as
+ * in recording order.
+ */
+class DisplayList {
+    public:
+        enum class Op : Uint8 {
+            FILL_TRIANGLE,
+            FILL_RECTANGLE,
+            FILL_POLYGON,
+            ELLIPSE,
+            ROTATED_ELLIPSE,
+            CIRCLE,
+            FIXED_LINE,
+            LINE,
+            POLYLINE,
+            STROKE
+        };
+
+        struct Command {
+            Op op;
+            bool anti_aliasing;
+            bool filled;            // CIRCLE, ELLIPSE, ROTATED_ELLIPSE. STROKE: closed.
+            FillRule rule;          // FILL_POLYGON.
+            Uint32 color;
+            SDL_Rect bounds;        // Every pixel the command may touch.
+            Sint32 p[8];            // 24.8 vertices (x, y pairs) or integer pixels and radii.
+            float angle;            // ROTATED_ELLIPSE, in radians.
+            Uint32 first, count;    // FILL_POLYGON: vertex pool. POLYLINE, STROKE: point pool.
+            Stroker::Style style;   // STROKE.
+        };
+
+        // How far back (in replay order) a new command may move to join its kind.
+        static const int batch_window = 64;
+
+        void clear();
+        void end_shape();
+        size_t get_shape_count() const;
+        void truncate_shapes(size_t shape_count);
+
+        void set_batching(bool enabled);
+        bool get_batching() const;
+
+        void add_triangle(FixedPoint::Vertex v0, FixedPoint::Vertex v1, FixedPoint::Vertex v2, Uint32 color);
+        void add_rectangle(FixedPoint::Vertex v0, FixedPoint::Vertex v1, FixedPoint::Vertex v2, FixedPoint::Vertex v3, Uint32 color);
+        void add_polygon(const std::vector<FixedPoint::Vertex>& vertices, Uint32 color);
+        void add_polygon(const std::vector<FixedPoint::Vertex>& vertices, Uint32 color, FillRule rule);
+        void add_ellipse(int cx, int cy, int rx, int ry, Uint32 color, bool anti_aliasing, bool filled);
+        void add_rotated_ellipse(int cx, int cy, int rx, int ry, float angle_rad, Uint32 color, bool filled);
+        void add_circle(int cx, int cy, int radius, Uint32 color, bool anti_aliasing, bool filled);
+        void add_line(FixedPoint::Vertex a, FixedPoint::Vertex b, Uint32 color);
+        void add_line(int x1, int y1, int x2, int y2, Uint32 color, bool anti_aliasing);
+        void add_curve(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, Uint32 color, bool anti_aliasing);
+        void add_stroke(const std::vector<SDL_FPoint>& points, Uint32 color, const Stroker::Style& style, bool closed);
+
+        // Commands in replay order.
+        size_t size() const;
+        const Command& get_command(size_t index) const;
+        const SDL_Rect& get_bounds(size_t index) const;
+
+        int execute(SDL_Surface* surface) const;
+        void execute(SDL_Surface* surface, size_t index) const;
+
+    private:
+        struct ShapeEnd {
+            size_t commands, vertices, points;
+        };
+
+        std::vector<Command> commands;              // Recording order.
+        std::vector<Uint32> order;                  // Replay order (indices into commands).
+        std::vector<FixedPoint::Vertex> vertices;
+        std::vector<SDL_FPoint> points;
+        std::vector<ShapeEnd> shape_ends;
+        bool batching = true;
+
+        Command& push(Op op, Uint32 color, const SDL_Rect& bounds);
+        void run(SDL_Surface* surface, const Command& command) const;
+        static SDL_Rect points_bounds(const SDL_FPoint* points, size_t count, float margin);
+        static SDL_Rect fixed_bounds(const FixedPoint::Vertex* vertices, size_t count);
+};
+
+#endif
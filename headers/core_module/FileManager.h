@@ -13,7 +13,6 @@ class FileManager {
     public:
         static bool load_scene(
             const std::string& file_path,
-            SDL_Surface* target_surface,
             std::vector<std::unique_ptr<Shape>>& shapes,
             int* out_width,
             int* out_height,
@@ -0,0 +1,40 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <SDL.h>
+
+/**
+ * @brief 24.8 fixed-point canvas coordinates.
+ *
+ * A coordinate is an integer count of 1/256 pixel. Pixel (x, y) covers the square
+ * [x, x + 1) x [y, y + 1) and is sampled at its center, so a vertex can sit anywhere
+ * inside a pixel instead of being snapped to its corner. Conversion from double
+ * happens once per vertex (Utils::universe_to_canvas_fixed); the rasterizers then
+ * work on integers only, so the same input gives the same pixels on every compiler,
+ * optimization level and thread count.
+ */
+class FixedPoint {
+    public:
+        static const int fraction_bits = 8;
+        static const Sint32 one = 1 << fraction_bits;
+        static const Sint32 half = one / 2;
+
+        // Coordinates are clamped to +-2^15 px, so the products of two coordinates
+        // taken by the edge functions fit comfortably in 64 bits.
+        static const Sint32 max_magnitude = 1 << (15 + fraction_bits);
+
+        struct Vertex {
+            Sint32 x, y;
+        };
+
+        static Sint32 from_double(double value);
+        static Sint32 from_int(int value);
+        static Vertex vertex(double x, double y);
+
+        static int floor_to_int(Sint32 value);
+        static int ceil_to_int(Sint32 value);
+        static int round_to_int(Sint32 value);
+        static float to_float(Sint32 value);
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include "App.h"
+
+/**
+ * @brief Per-stage frame timings, shown live by a HUD (F3).
+ *
+ * PROFILE_SCOPE(STAGE) times the rest of the enclosing block with the performance
+ * counter and adds it to the stage. A stage may run several times in one frame (once
+ * per damaged rectangle); PROFILE_END_FRAME() closes the frame and stores the total
+ * of every stage that ran in a rolling history, from which min, average and 99th
+ * percentile are computed.
+ *
+ * The profiler only exists when BRUSHY_PROFILER is defined (Debug target). Otherwise
+ * the macros expand to nothing and no timing code is compiled. Main thread only.
+ */
+#ifdef BRUSHY_PROFILER
+
+class FrameProfiler {
+    public:
+        enum class Stage {
+            FRAME,              // Whole frame: rendering and presentation.
+            EVENTS,             // handle_events.
+            NOTIFICATIONS,      // Notification update.
+            DISPLAY_LIST,       // Compiling new shapes into the display list.
+            CLEAR,              // Canvas background fill.
+            LINES,              // Line segments.
+            SHAPES,             // Display list replay.
+            TILES,              // Parallel rasterization (clear, lines and shapes).
+            PAINT_LAYER,        // Pencil, eraser and bucket layer composited over the shapes.
+            BLIT,               // Window background and canvas blit.
+            INTERFACE,          // App bar, buttons and notification drawing.
+            PRESENT,            // SDL_UpdateWindowSurface(Rects).
+            COUNT
+        };
+
+        struct Stats {
+            float min_ms, avg_ms, p99_ms;
+            int samples;
+        };
+
+        class Scope {
+            public:
+                explicit Scope(Stage stage);
+                ~Scope();
+
+            private:
+                Stage stage;
+                Uint64 start;
+        };
+
+        static void add(Stage stage, Uint64 ticks);
+        static void end_frame();
+        static Stats get_stats(Stage stage);
+        static const char* get_name(Stage stage);
+
+        static void toggle_hud();
+        static bool get_hud_visible();
+        static SDL_Rect get_hud_rect(int x, int y);
+        static void draw_hud(SDL_Surface* surface, int x, int y);
+
+    private:
+        static const int history_size = 240;   // Frames kept per stage.
+
+        struct History {
+            float samples[history_size];        // Milliseconds per frame.
+            int count, index;
+            Uint64 frame_ticks;                 // Accumulated in the current frame.
+            bool ran;
+        };
+
+        static History histories[(int)Stage::COUNT];
+        static bool hud_visible;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage) FrameProfiler::Scope PROFILE_CONCAT(profile_scope_, __LINE__)(FrameProfiler::Stage::stage)
+#define PROFILE_END_FRAME() FrameProfiler::end_frame()
+
+#else
+
+#define PROFILE_SCOPE(stage) ((void)0)
+#define PROFILE_END_FRAME() ((void)0)
+
+#endif
+
+#endif
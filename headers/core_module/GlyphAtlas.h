@@ -0,0 +1,65 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <unordered_map>
+#include "App.h"
+
+/**
+ * @brief Cached text rendering for the interface fonts.
+ *
+ * Each font gets an atlas: an 8-bit coverage image where every glyph is rasterized
+ * once by SDL_ttf, the first time it is drawn. Strings are laid out once too (glyphs,
+ * pen positions and kerning) and the run is cached per font. Drawing a label is then
+ * one coverage blit per glyph, blended in the requested color through PixelFormat,
+ * with no surface created or freed. The color is applied at blit time, so the same
+ * run serves every color.
+ *
+ * Interface thread only. clear() must run before the fonts are closed.
+ */
+class GlyphAtlas {
+    public:
+        static void draw_text(SDL_Surface* target, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
+        static bool size_text(TTF_Font* font, const std::string& text, int* width, int* height);
+        static void clear();
+
+    private:
+        struct Glyph {
+            bool loaded;
+            int atlas_x, atlas_y;       // Coverage mask in the atlas.
+            int w, h;
+            int offset_x, offset_y;     // Mask position relative to the pen, from the top of the line.
+            int advance;
+        };
+
+        struct Placement {
+            const Glyph* glyph;
+            int x, y;
+        };
+
+        struct Run {
+            std::vector<Placement> glyphs;
+            int width, height;
+        };
+
+        struct Atlas {
+            TTF_Font* font;
+            std::vector<Uint8> pixels;  // atlas_width x height coverage values.
+            int height;
+            int shelf_x, shelf_y, shelf_h;
+            Glyph latin1[256];
+            std::unordered_map<Uint32, Glyph> others;
+            std::unordered_map<std::string, Run> runs;
+        };
+
+        static const int atlas_width = 512;
+        static const size_t max_runs = 256;    // Per font; the cache is dropped when full (typed text).
+
+        static std::unordered_map<TTF_Font*, std::unique_ptr<Atlas>> atlases;
+
+        static Atlas& atlas_for(TTF_Font* font);
+        static const Glyph& glyph_for(Atlas& atlas, Uint32 codepoint);
+        static const Run& run_for(Atlas& atlas, const std::string& text);
+        static Uint32 next_codepoint(const std::string& text, size_t* index);
+};
+
+#endif
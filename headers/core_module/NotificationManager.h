@@ -17,6 +17,8 @@ public:
     void draw(SDL_Surface* surface);
     void handle_event(SDL_Event* e);
     void set_fonts(TTF_Font* title, TTF_Font* message);
+    bool take_damage(SDL_Rect* rect);
+    int get_wait_timeout() const;
 
 private:
     std::queue<Notification> queue_;
@@ -29,8 +31,15 @@ private:
     TTF_Font* font_title_;
     TTF_Font* font_message_;
 
+    // Damage tracking (area of the window touched by the notification animation).
+    bool had_current_;
+    SDL_Rect last_rect_;
+    bool has_damage_;
+    SDL_Rect damage_;
+
+    void add_damage(const SDL_Rect& rect);
+
     void update_current();
-    void draw_rounded_rect_surface(SDL_Surface* surface,int x, int y, int w, int h, SDL_Color color, int radius, bool filled);
     void draw_notification(SDL_Surface* target, const Notification& n);
 };
 
@@ -0,0 +1,249 @@
+#ifndef PIXEL_FORMAT_H
+#define PIXEL_FORMAT_H
+
+#include <cstring>
+#include "App.h"
+
+/**
+ * @brief Compile-time pixel layouts for the Primitives kernels.
+ *
+ * Each policy says how a canvas color (CanvasFormat) is encoded into one pixel of a
+ * surface layout, how a pixel is read back, and how runs are written. The kernels
+ * are templates on the policy, so the inner loops contain no format checks and no
+ * SDL_MapRGBA/SDL_GetRGBA calls; PixelFormat::dispatch picks the policy once per
+ * draw call from surface->format. Surfaces of other layouts are left untouched.
+ * Policies that depend on the surface (palette, channel shifts) read them from the
+ * SDL_PixelFormat passed to encode and decode.
+ */
+class PixelFormat {
+    public:
+        /**
+         * @brief The canvas layout. Also used for XRGB8888 (SDL_PIXELFORMAT_RGB888)
+         * surfaces, whose top byte SDL ignores.
+         */
+        struct ARGB8888 {
+            typedef Uint32 Pixel;
+            static const int bytes_per_pixel = 4;
+            static const bool blends = true;
+
+            static Pixel encode(Uint32 color, const SDL_PixelFormat*) { return color; }
+            static Uint32 decode(const Uint8* p, const SDL_PixelFormat*) { return *(const Uint32*)p; }
+            static void store(Uint8* p, Pixel pixel) { *(Uint32*)p = pixel; }
+            static void fill_row(Uint8* row, int x0, int x1, Pixel pixel) { SpanWriter::fill_row((Uint32*)row, x0, x1, pixel); }
+        };
+
+        /**
+         * @brief 24-bit packed RGB (SDL_PIXELFORMAT_RGB24: red, green and blue bytes in
+         * memory order), used for BMP export.
+         */
+        struct RGB888 {
+            typedef Uint32 Pixel;       // 0x00RRGGBB.
+            static const int bytes_per_pixel = 3;
+            static const bool blends = true;
+
+            static Pixel encode(Uint32 color, const SDL_PixelFormat*) { return color & 0x00FFFFFF; }
+
+            static Uint32 decode(const Uint8* p, const SDL_PixelFormat*) {
+                return CanvasFormat::alpha_mask | ((Uint32)p[0] << 16) | ((Uint32)p[1] << 8) | p[2];
+            }
+
+            static void store(Uint8* p, Pixel pixel) {
+                p[0] = (Uint8)(pixel >> 16);
+                p[1] = (Uint8)(pixel >> 8);
+                p[2] = (Uint8)pixel;
+            }
+
+            static void fill_row(Uint8* row, int x0, int x1, Pixel pixel) {
+                for (Uint8* p = row + x0 * 3; x0 <= x1; ++x0, p += 3) RGB888::store(p, pixel);
+            }
+        };
+
+        /**
+         * @brief 16-bit RGB565, used for thumbnails. Channels are truncated on write
+         * and widened by bit replication on read.
+         */
+        struct RGB565 {
+            typedef Uint16 Pixel;
+            static const int bytes_per_pixel = 2;
+            static const bool blends = true;
+
+            static Pixel encode(Uint32 color, const SDL_PixelFormat*) {
+                return (Pixel)(((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F));
+            }
+
+            static Uint32 decode(const Uint8* p, const SDL_PixelFormat*) {
+                const Uint32 pixel = *(const Uint16*)p;
+                const Uint32 r = (pixel >> 11) & 0x1F, g = (pixel >> 5) & 0x3F, b = pixel & 0x1F;
+                return CanvasFormat::alpha_mask | (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+            }
+
+            static void store(Uint8* p, Pixel pixel) { *(Uint16*)p = pixel; }
+
+            static void fill_row(Uint8* row, int x0, int x1, Pixel pixel) {
+                std::fill((Uint16*)row + x0, (Uint16*)row + x1 + 1, pixel);
+            }
+        };
+
+        /**
+         * @brief 8-bit indexed (SDL_PIXELFORMAT_INDEX8). The color is matched to the
+         * palette once per draw call. Nothing can be blended into a palette, so pixels
+         * at least half covered get the color and the others are left as is; translucent
+         * colors are drawn opaque.
+         */
+        struct Indexed8 {
+            typedef Uint8 Pixel;
+            static const int bytes_per_pixel = 1;
+            static const bool blends = false;
+
+            static Pixel encode(Uint32 color, const SDL_PixelFormat* format) { return PixelFormat::nearest_index(color, format->palette); }
+
+            static Uint32 decode(const Uint8* p, const SDL_PixelFormat* format) {
+                const SDL_Palette* palette = format->palette;
+                const SDL_Color& c = palette->colors[*p < palette->ncolors ? *p : 0];
+                return CanvasFormat::pack(c.r, c.g, c.b);
+            }
+
+            static void store(Uint8* p, Pixel pixel) { *p = pixel; }
+            static void fill_row(Uint8* row, int x0, int x1, Pixel pixel) { memset(row + x0, pixel, x1 - x0 + 1); }
+        };
+
+        /**
+         * @brief Any other 32-bit layout with 8-bit channels (ABGR8888, RGBA8888,
+         * BGRA8888, BGRX8888...), packed through the channel shifts of the surface
+         * format. Alpha is kept only when the layout has an alpha channel.
+         */
+        struct Masked32 {
+            typedef Uint32 Pixel;
+            static const int bytes_per_pixel = 4;
+            static const bool blends = true;
+
+            static Pixel encode(Uint32 color, const SDL_PixelFormat* format) {
+                return (((color >> 16) & 0xFF) << format->Rshift) | (((color >> 8) & 0xFF) << format->Gshift) |
+                       ((color & 0xFF) << format->Bshift) | (((color >> 24) << format->Ashift) & format->Amask);
+            }
+
+            static Uint32 decode(const Uint8* p, const SDL_PixelFormat* format) {
+                const Uint32 pixel = *(const Uint32*)p;
+                const Uint32 a = format->Amask ? (pixel & format->Amask) >> format->Ashift : 0xFF;
+                return (a << 24) | (((pixel & format->Rmask) >> format->Rshift) << 16) |
+                       (((pixel & format->Gmask) >> format->Gshift) << 8) | ((pixel & format->Bmask) >> format->Bshift);
+            }
+
+            static void store(Uint8* p, Pixel pixel) { *(Uint32*)p = pixel; }
+            static void fill_row(Uint8* row, int x0, int x1, Pixel pixel) { SpanWriter::fill_row((Uint32*)row, x0, x1, pixel); }
+        };
+
+        enum class Layout {
+            ARGB8888,
+            RGB888,
+            RGB565,
+            INDEXED8,
+            MASKED32,
+            UNSUPPORTED
+        };
+
+        static Layout layout_of(const SDL_Surface* surface);
+        static Uint8 nearest_index(Uint32 color, const SDL_Palette* palette);
+        static Uint32 read(const SDL_Surface* surface, int x, int y);
+        static void write(SDL_Surface* surface, int x, int y, Uint32 color);
+
+        /**
+         * @brief One color bound to one surface, in the layout of the Format policy.
+         *
+         * Built once per draw call: the color is encoded (and, for blending, prepared
+         * by a CoverageBlender) before the kernel runs. The pointer-level methods do not
+         * clip; plot and fill_span clip to the surface clip rectangle.
+         */
+        template <class Format>
+        class Writer {
+            public:
+                typedef typename Format::Pixel Pixel;
+
+                Writer(SDL_Surface* surface, Uint32 color)
+                    : clip(surface->clip_rect),
+                      pixels((Uint8*)surface->pixels),
+                      pitch(surface->pitch),
+                      format(surface->format),
+                      color(color),
+                      solid(Format::encode(color, surface->format)),
+                      opaque((color & CanvasFormat::alpha_mask) == CanvasFormat::alpha_mask),
+                      blender(color) {}
+
+                Uint8* row(int y) const { return this->pixels + y * this->pitch; }
+                Uint8* at(int x, int y) const { return this->row(y) + x * Format::bytes_per_pixel; }
+
+                void put(Uint8* p) const { Format::store(p, this->solid); }
+                void fill_row(Uint8* row, int x0, int x1) const { Format::fill_row(row, x0, x1, this->solid); }
+
+                void plot(int x, int y) const {
+                    if (x < clip.x || y < clip.y || x >= clip.x + clip.w || y >= clip.y + clip.h) return;
+                    this->put(this->at(x, y));
+                }
+
+                void fill_span(int x0, int x1, int y) const {
+                    if (y < clip.y || y >= clip.y + clip.h) return;
+                    x0 = std::max(x0, clip.x);
+                    x1 = std::min(x1, clip.x + clip.w - 1);
+                    if (x0 > x1) return;
+                    Format::fill_row(this->row(y), x0, x1, this->solid);
+                }
+
+                void blend(Uint8* p, Uint8 coverage) const {
+                    if (coverage == 0) return;
+                    if (!Format::blends) {
+                        if (coverage >= 128) this->put(p);
+                        return;
+                    }
+
+                    Uint32 pixel = Format::decode(p, this->format);
+                    this->blender.blend(&pixel, coverage);
+                    Format::store(p, Format::encode(pixel, this->format));
+                }
+
+                void blend(Uint8* p, float coverage) const { this->blend(p, CoverageBlender::to_coverage(coverage)); }
+
+                // Same contract as CoverageBlender::blend_run: the run is already clipped.
+                void blend_run(int y, int x0, const Uint8* coverage, int count) const {
+                    Uint8* p = this->at(x0, y);
+                    for (int i = 0; i < count; ++i, p += Format::bytes_per_pixel) {
+                        if (coverage[i] == 255 && this->opaque) {
+                            this->put(p);
+                        } else {
+                            this->blend(p, coverage[i]);
+                        }
+                    }
+                }
+
+                const SDL_Rect clip;
+                Uint8* const pixels;
+                const int pitch;
+                const SDL_PixelFormat* const format;
+                const Uint32 color;         // Canvas color (premultiplied ARGB8888).
+                const Pixel solid;          // The color in this layout.
+                const bool opaque;
+                const CoverageBlender blender;
+        };
+
+        /**
+         * @brief Runs kernel(writer) with the Writer of the surface layout.
+         *
+         * @param surface Destination surface.
+         * @param color   Canvas color the writer is bound to.
+         * @param kernel  Callable taking a const Writer<Format>& (a generic lambda).
+         */
+        template <class Kernel>
+        static void dispatch(SDL_Surface* surface, Uint32 color, Kernel&& kernel) {
+            if (!surface) return;
+
+            switch (PixelFormat::layout_of(surface)) {
+                case Layout::ARGB8888: kernel(Writer<ARGB8888>(surface, color)); break;
+                case Layout::RGB888:   kernel(Writer<RGB888>(surface, color)); break;
+                case Layout::RGB565:   kernel(Writer<RGB565>(surface, color)); break;
+                case Layout::INDEXED8: kernel(Writer<Indexed8>(surface, color)); break;
+                case Layout::MASKED32: kernel(Writer<Masked32>(surface, color)); break;
+                case Layout::UNSUPPORTED: break;
+            }
+        }
+};
+
+#endif
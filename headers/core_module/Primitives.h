@@ -3,35 +3,58 @@
 
 #include "App.h"
 
+// Which points are inside a self-intersecting or nested polygon (see fill_polygon).
+enum class FillRule {
+    EVEN_ODD,
+    NON_ZERO
+};
+
 class Primitives {
     private:
-        static void draw_horizontal_line(SDL_Surface* surface, int x1, int x2, int y, Uint32 color);
-        static void draw_vertical_line(SDL_Surface* surface,int x, int y1, int y2, Uint32 color);
-        static void draw_bresenham_line(SDL_Surface* surface, int x1, int y1, int x2, int y2, Uint32 color);
-        static void draw_xiaolin_wu_line(SDL_Surface* surface, int x1, int y1, int x2, int y2, Uint32 color);
-        static void draw_bresenham_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, Uint32 color, bool filled);
+        // Kernels: templates on the pixel layout (see PixelFormat), called once the
+        // public entry point has dispatched on surface->format.
+        template <class Format> static void draw_line(const PixelFormat::Writer<Format>& out, int x1, int y1, int x2, int y2, bool anti_aliasing);
+        template <class Format> static void draw_fixed_line(const PixelFormat::Writer<Format>& out, FixedPoint::Vertex a, FixedPoint::Vertex b);
+        template <class Format> static void draw_horizontal_line(const PixelFormat::Writer<Format>& out, int x1, int x2, int y);
+        template <class Format> static void draw_vertical_line(const PixelFormat::Writer<Format>& out, int x, int y1, int y2);
+        template <class Format> static void draw_bresenham_line(const PixelFormat::Writer<Format>& out, int x1, int y1, int x2, int y2);
+        template <class Format> static void draw_xiaolin_wu_line(const PixelFormat::Writer<Format>& out, int x1, int y1, int x2, int y2);
+        template <class Format> static void draw_antialiased_circle(const PixelFormat::Writer<Format>& out, int cx, int cy, int radius, bool filled);
+        template <class Format> static void draw_bresenham_circle(const PixelFormat::Writer<Format>& out, int cx, int cy, int radius);
+        template <class Format> static void draw_bresenham_ellipse(const PixelFormat::Writer<Format>& out, int cx, int cy, int rx, int ry);
+        template <class Format> static void draw_analytic_ellipse(const PixelFormat::Writer<Format>& out, int cx, int cy, int rx, int ry, float angle_rad, bool filled, float outline_tolerance);
+        template <class Format> static void fill_triangle(const PixelFormat::Writer<Format>& out, const long long v[6], long long unit);
+        template <class Format> static void fill_quad(const PixelFormat::Writer<Format>& out, const long long xs[4], const long long ys[4], long long unit);
+        template <class Format> static void draw_rounded_rect(const PixelFormat::Writer<Format>& out, const SDL_Rect& rect, int radius, int border_thickness);
         static void draw_supersampled_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, Uint32 color, bool filled);
-        static void draw_bezier_curve(SDL_Surface* surface, int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, Uint32 color, bool anti_aliasing);
-        static void draw_flat_curve(SDL_Surface* surface, int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, Uint32 color, bool anti_aliasing);
+        static void draw_analytic_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, float angle_rad, Uint32 color, bool filled, float outline_tolerance);
     public:
         static void set_pixel(SDL_Surface* surface, int x, int y, Uint32 color);
+        static void fill_span(SDL_Surface* surface, int x0, int x1, int y, Uint32 color);
         static Uint32 get_pixel(SDL_Surface* surface, int x, int y);
         static void blend_pixel(SDL_Surface* surface, int px, int py, SDL_Color line_color, float intensity);
         static void draw_line(SDL_Surface* surface, int x1, int y1, int x2, int y2, Uint32 color, bool anti_aliasing);
+        static void draw_line(SDL_Surface* surface, FixedPoint::Vertex a, FixedPoint::Vertex b, Uint32 color);
         static void draw_curve(SDL_Surface* surface, int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, Uint32 color, bool anti_aliasing);
+        static void draw_polyline(SDL_Surface* surface, const std::vector<SDL_FPoint>& points, Uint32 color, bool anti_aliasing);
         static void draw_circle(SDL_Surface* surface, int cx, int cy, int radius, Uint32 color, bool anti_aliasing, bool filled);
         static void draw_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, Uint32 color, bool anti_aliasing, bool filled);
         static void draw_rotated_ellipse(SDL_Surface* surface,int cx, int cy, int rx, int ry,float angle_rad, Uint32 color, bool filled);
         static void draw_text(SDL_Surface* target, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color);
-        static void fill_polygon(SDL_Surface* s, const std::vector<SDL_Point>& pts, Uint32 color);
-        static void flood_fill(SDL_Surface* surface, int x, int y, Uint32 fillColor);
+        static void fill_polygon(SDL_Surface* s, const std::vector<SDL_Point>& pts, Uint32 color, FillRule rule = FillRule::EVEN_ODD);
+        static void fill_polygon(SDL_Surface* s, const std::vector<FixedPoint::Vertex>& pts, Uint32 color, FillRule rule = FillRule::EVEN_ODD);
+        static void flood_fill(SDL_Surface* surface, int x, int y, Uint32 fill_color, int tolerance = 0, bool eight_connected = false);
+        static SDL_Rect flood_fill_into(SDL_Surface* source, SDL_Surface* target, int x, int y, Uint32 fill_color, int tolerance = 0, bool eight_connected = false);
         static void draw_triangle(SDL_Surface* surface,int x0, int y0,int x1, int y1,int x2, int y2,Uint32 color);
+        static void draw_triangle(SDL_Surface* surface, FixedPoint::Vertex v0, FixedPoint::Vertex v1, FixedPoint::Vertex v2, Uint32 color);
         static void draw_rectangle(SDL_Surface* surface,
                                   int x0, int y0,
                                   int x1, int y1,
                                   int x2, int y2,
                                   int x3, int y3,
                                   Uint32 color);
+        static void draw_rectangle(SDL_Surface* surface, FixedPoint::Vertex v0, FixedPoint::Vertex v1, FixedPoint::Vertex v2, FixedPoint::Vertex v3, Uint32 color);
+        static void draw_rounded_rect(SDL_Surface* surface, const SDL_Rect& rect, int radius, SDL_Color color, int border_thickness = 0);
 };
 
 #endif
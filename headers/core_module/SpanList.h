@@ -0,0 +1,33 @@
+#ifndef SPAN_LIST_H
+#define SPAN_LIST_H
+
+#include "App.h"
+
+/**
+ * @brief Solid pixel runs of a shape, one [x0, x1] interval per row.
+ *
+ * Generators (see ConicSpans) write the runs once; filling them is then one
+ * clipped row fill per span. The list does not depend on the surface or
+ * its clip rectangle, so a shape that does not change can keep its list and fill
+ * it again on every repaint, also at an offset if the shape was only moved.
+ */
+class SpanList {
+    public:
+        struct Span {
+            int y;
+            int x0, x1;         // Both inclusive.
+        };
+
+        void clear();
+        void add(int y, int x0, int x1);
+        bool empty() const;
+        const std::vector<Span>& get_spans() const;
+        SDL_Rect get_bounds() const;
+
+        void fill(SDL_Surface* surface, Uint32 color, int dx = 0, int dy = 0) const;
+
+    private:
+        std::vector<Span> spans;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef SPAN_WRITER_H
+#define SPAN_WRITER_H
+
+#include "App.h"
+
+/**
+ * @brief Solid fills of horizontal pixel runs on 32-bit surfaces.
+ *
+ * Every filled primitive ends up writing runs of one color along a row. This class
+ * owns that inner loop: the kernel is chosen once at startup (AVX2, SSE2 or plain
+ * scalar code, depending on the CPU and the compiler) and callers only pass an
+ * already clipped row pointer and range.
+ */
+class SpanWriter {
+    public:
+        static void fill_row(Uint32* row, int x0, int x1, Uint32 color);
+        static void fill_rect(SDL_Surface* surface, const SDL_Rect& rect, Uint32 color);
+        static const char* get_kernel_name();
+
+        static void fill_row_scalar(Uint32* row, int x0, int x1, Uint32 color);
+
+    private:
+        typedef void (*RowKernel)(Uint32* row, int x0, int x1, Uint32 color);
+
+        struct Kernel {
+            RowKernel fill_row;
+            const char* name;
+        };
+
+        static const Kernel& get_kernel();
+        static Kernel select_kernel();
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef STROKER_H
+#define STROKER_H
+
+#include "App.h"
+
+/**
+ * @brief Thick, anti-aliased strokes of polylines, with joins and caps.
+ *
+ * The stroke is split into convex pieces: a butt-ended box per segment, plus a
+ * disk (round join or cap) or a small polygon (bevel or miter join) at the
+ * vertices. Each pixel gets its coverage from the signed distance to the pieces
+ * that reach its row, 0.5 - d clamped to [0, 1], and the union keeps the largest
+ * coverage, so overlapping pieces never blend twice. Only a band of about one
+ * pixel around each piece is evaluated.
+ *
+ * Points are pixel centers: (x, y) is the center of pixel (x, y), as for the
+ * one-pixel lines of Primitives.
+ */
+class Stroker {
+    public:
+        enum class Join {
+            ROUND,
+            MITER,
+            BEVEL
+        };
+
+        enum class Cap {
+            BUTT,
+            ROUND
+        };
+
+        struct Style {
+            float width;
+            Join join;
+            Cap cap;
+            float miter_limit;      // Longest miter, as a multiple of half the width.
+            bool anti_aliasing;     // False: pixels whose centers are inside, at full coverage.
+        };
+
+        static Style default_style(float width);
+
+        static SDL_Rect stroke_polyline(SDL_Surface* surface, const std::vector<SDL_FPoint>& points, Uint32 color, const Style& style, bool closed = false);
+        static SDL_Rect stroke_line(SDL_Surface* surface, float x0, float y0, float x1, float y1, Uint32 color, const Style& style);
+
+    private:
+        enum class PieceKind {
+            BOX,
+            DISK,
+            POLYGON
+        };
+
+        static const int max_polygon = 8;
+
+        struct Piece {
+            PieceKind kind;
+            float ax, ay, bx, by;   // BOX: segment; DISK: center in (ax, ay).
+            float radius;           // BOX and DISK: half width.
+            int count;              // POLYGON: edges, as half-planes nx * x + ny * y <= c.
+            float nx[max_polygon], ny[max_polygon], c[max_polygon];
+            float corner_x[4], corner_y[4];
+            float min_x, min_y, max_x, max_y;
+
+            float distance(float px, float py) const;
+            bool row_range(float py, float* x0, float* x1) const;
+        };
+
+        static void add_box(std::vector<Piece>& pieces, SDL_FPoint a, SDL_FPoint b, float radius);
+        static void add_disk(std::vector<Piece>& pieces, SDL_FPoint center, float radius);
+        static void add_polygon(std::vector<Piece>& pieces, const SDL_FPoint* vertices, int count);
+        static void add_join(std::vector<Piece>& pieces, SDL_FPoint vertex, SDL_FPoint d0, SDL_FPoint d1, float overlap, const Style& style);
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef TILE_RENDERER_H
+#define TILE_RENDERER_H
+
+#include "App.h"
+
+/**
+ * @brief Parallel, tile-binned rasterization of the drawing surface.
+ *
+ * The area to render is split into square tiles and every item (shape, line) is
+ * binned into the tiles its canvas bounds overlap. A pool of SDL threads then
+ * takes tiles one at a time and draws the tile's items, in the caller's order,
+ * into a private view of the surface clipped to the tile. The primitives never
+ * touch pixels outside the clip and give the same pixels for any clip, so the
+ * result is bit-identical to drawing everything serially.
+ */
+class TileRenderer {
+    public:
+        // Draws item 'index' into 'target' (a view of the surface, clipped to one tile).
+        typedef std::function<void(SDL_Surface* target, size_t index)> DrawItem;
+
+        // With the automatic tile size, the area is split into about tiles_per_thread tiles
+        // per thread (for load balance), no smaller than min_tile_size, and into a single
+        // tile with one thread. Items crossing tiles are drawn once per tile, so fewer tiles
+        // mean less repeated work.
+        static const int tiles_per_thread = 4;
+        static const int min_tile_size = 64;
+
+        TileRenderer(int thread_count = 0);
+        ~TileRenderer();
+
+        void set_thread_count(int thread_count);
+        int get_thread_count() const;
+        void set_tile_size(int tile_size);
+        int get_tile_size() const;
+        int get_tile_size_for(const SDL_Rect& area) const;
+
+        int render(SDL_Surface* surface, const SDL_Rect& rect, Uint32 background, const std::vector<SDL_Rect>& bounds, const DrawItem& draw_item);
+
+    private:
+        struct Worker {
+            TileRenderer* owner;
+            SDL_Thread* thread;
+            SDL_Surface* view;
+        };
+
+        int thread_count;
+        int tile_size;          // 0 for the automatic size.
+
+        // Workers 1..thread_count-1 are pool threads; worker 0 is the calling thread.
+        std::vector<Worker> workers;
+        SDL_sem* work_ready;
+        SDL_sem* work_done;
+        bool quit;
+
+        // Current job, written by render() before the workers are released.
+        SDL_Surface* surface;
+        Uint32 background;
+        const DrawItem* draw_item;
+        std::vector<SDL_Rect> tiles;
+        std::vector<std::vector<int>> bins;
+        SDL_atomic_t next_tile;
+        SDL_atomic_t items_drawn;
+
+        void start_workers();
+        void stop_workers();
+        void update_views(SDL_Surface* surface);
+        void run_tiles(Worker& worker);
+        static int SDLCALL worker_main(void* data);
+};
+
+#endif
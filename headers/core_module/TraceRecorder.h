@@ -0,0 +1,76 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include "App.h"
+
+/**
+ * @brief Timeline of rendering and loading activity, exported in the Chrome
+ * trace-event JSON format (Perfetto, chrome://tracing).
+ *
+ * TRACE_SCOPE(name) records one complete event (begin time and duration) for the
+ * rest of the enclosing block. Every thread appends to its own ring buffer and
+ * publishes the new count with an atomic store, so recording takes no lock and
+ * flush() can read the buffers while the threads keep running. A full ring
+ * overwrites its oldest events: each flush writes the most recent buffer_capacity
+ * events of every thread (the number overwritten is reported in the trace).
+ *
+ * Tracing is off unless start() is called (BRUSHY_TRACE=<file>); then a scope
+ * costs a flag test only. Event names must be string literals: the buffers keep
+ * the pointers.
+ */
+class TraceRecorder {
+    public:
+        // Primitive calls below this canvas area (in pixels) are not traced.
+        static const int min_traced_area = 32 * 32;
+
+        class Scope {
+            public:
+                explicit Scope(const char* name, Sint64 size = -1);
+                ~Scope();
+
+            private:
+                const char* name;
+                Sint64 size;
+                Uint64 start;
+        };
+
+        static void start(const std::string& path);
+        static bool get_enabled();
+        static void set_thread_name(const char* name);
+        static void record(const char* name, Uint64 start, Uint64 end, Sint64 size);
+        static bool flush();
+
+    private:
+        struct Event {
+            const char* name;
+            Uint64 start, end;      // Performance counter ticks.
+            Sint64 size;            // Optional "size" argument; negative when absent.
+        };
+
+        struct Buffer {
+            std::vector<Event> events;
+            SDL_atomic_t count;     // Events published by the owning thread since the start.
+            int thread_id;
+            const char* thread_name;
+        };
+
+        static const int buffer_capacity = 1 << 16;    // Events per thread.
+
+        static bool enabled;
+        static std::string path;
+        static Uint64 origin;
+        static std::vector<Buffer*> buffers;
+        static SDL_SpinLock buffers_lock;
+
+        static Buffer* get_thread_buffer();
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceRecorder::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+
+// Traces a primitive call only when it covers at least min_traced_area pixels.
+#define TRACE_SCOPE_AREA(name, area) \
+    TraceRecorder::Scope TRACE_CONCAT(trace_scope_, __LINE__)((area) >= TraceRecorder::min_traced_area ? (name) : nullptr, (area))
+
+#endif
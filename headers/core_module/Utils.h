@@ -3,6 +3,7 @@
 
 #include "App.h"
 #include "Point.h"
+#include "FixedPoint.h"
 
 class Utils {
     public:
@@ -18,7 +19,9 @@ class Utils {
         static Point clamp_canvas(Point p, int canvas_w, int canvas_h);
         static Point canvas_to_universe(Point c,int canvas_w, int canvas_h,int universe_w, int universe_h);
         static Point universe_to_canvas(Point u,int canvas_w, int canvas_h,int universe_w, int universe_h);
+        static FixedPoint::Vertex universe_to_canvas_fixed(const Point& u, int canvas_w, int canvas_h, int universe_w, int universe_h);
         static UniverseRect canvas_drag_to_universe(Point a, Point b,int canvas_w, int canvas_h,int universe_w, int universe_h);
+        static SDL_Rect canvas_bounds(Point* const* points, int count, int padding, int canvas_w, int canvas_h, int universe_w, int universe_h);
         static int clampi(int v, int lo, int hi);
 };
 
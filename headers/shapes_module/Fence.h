@@ -61,10 +61,11 @@ public:
     Fence(int width, int height, int universe_x_origin, int universe_y_origin, Uint32 color_plank, Uint32 color_top);
 
 
-    void draw(SDL_Surface* surface) override;
+    void compile(DisplayList& list, int canvas_w, int canvas_h) override;
     void translate(double dx, double dy) override;
     void rotate_figure(double angle) override;
     void scale(double sx, double sy) override;
+    SDL_Rect get_canvas_bounds(int canvas_w, int canvas_h) override;
     //void reset_transform() override;                                 // volta para identidade
 
 /*
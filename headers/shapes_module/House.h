@@ -50,7 +50,7 @@ public:
 
     House(int width, int height, int universe_x_origin, int universe_y_origin, Uint32 color_walls, Uint32 color_door, Uint32 color_roof);
 
-    void draw(SDL_Surface* surface) override;
+    void compile(DisplayList& list, int canvas_w, int canvas_h) override;
 
     /*
     void change_height(double new_height);
@@ -61,6 +61,7 @@ public:
     //void reset_transform();                                 // volta para identidade
     void translate(double dx, double dy) override;
     void scale(double sx, double sy) override;                   // T = T * Tr
+    SDL_Rect get_canvas_bounds(int canvas_w, int canvas_h) override;
     //void rotate_figure(SDL_Surface* surface, double degrees, Point center); // T = T * R(piv)
     void rotate_figure(double angle) override;
     //void scale(double sx, double sy, Point center);
@@ -1,7 +1,11 @@
 #ifndef SHAPE_H
 #define SHAPE_H
 
+#include <vector>
 #include "Point.h"
+#include "FixedPoint.h"
+
+class DisplayList;
 
 class Shape {
     private:
@@ -11,13 +15,28 @@ class Shape {
         double x_origin = 0.0;
         double y_origin = 0.0;
         float rotated_angle = 0;
+
+        // Outline stroked over the filled parts, in canvas pixels (0: no outline).
+        float outline_width = 0.0f;
+        Uint32 outline_color = 0;
+
         virtual ~Shape() {}
-        virtual void draw(SDL_Surface* surface) = 0;
+        // Records the drawing commands of the shape, in the canvas space of a canvas_w x canvas_h surface.
+        virtual void compile(DisplayList& list, int canvas_w, int canvas_h) = 0;
+        virtual void draw(SDL_Surface* surface);
         virtual void generate_points() = 0;
         virtual void scale(double scale_x, double scale_y) = 0;
         virtual void translate(double translation_x, double translation_y) = 0;
         virtual void rotate_figure(double angle) = 0;
 
+        // Area of the canvas touched by draw(); the default is conservative (whole canvas).
+        virtual SDL_Rect get_canvas_bounds(int canvas_w, int canvas_h) {
+            return {0, 0, canvas_w, canvas_h};
+        }
+
+        void stroke_outline(DisplayList& list, const std::vector<FixedPoint::Vertex>& corners);
+        int outline_padding() const;
+
         void change_height(double new_height){
             this->height = new_height;
             generate_points();
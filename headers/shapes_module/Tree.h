@@ -37,10 +37,11 @@ class Tree : public Shape {
     public:
         Tree(int width, int height, int universe_x_origin, int universe_y_origin, Uint32 color_trunk, Uint32 color_leaves, Uint32 color_apple);
         Uint32 colors[3] = {0,0,0};
-        void draw(SDL_Surface* surface) override;
+        void compile(DisplayList& list, int canvas_w, int canvas_h) override;
         void translate(double dx, double dy) override;
         void rotate_figure(double angle) override;
         void scale(double sx, double sy) override;
+        SDL_Rect get_canvas_bounds(int canvas_w, int canvas_h) override;
 };
 
 #endif
@@ -0,0 +1,1129 @@
+// INCLUDES
+#include <cstring>
+#include "App.h"
+
+
+// Micro-benchmarks for the rasterization primitives.
+//
+// Usage: PrimitivesBenchmark [scene.csv] [iterations] [repetitions]
+// Run it from the project root so the default scene (ExemploCorrigido.csv) is found.
+
+
+// Reference implementation: the per-pixel stack flood fill that Primitives::flood_fill replaced.
+static void legacy_flood_fill(SDL_Surface* surface, int x, int y, Uint32 fill_color) {
+    if (!surface || x < 0 || x >= surface->w || y < 0 || y >= surface->h) {
+        return;
+    }
+
+    Uint32 target_color = Primitives::get_pixel(surface, x, y);
+    if (target_color == fill_color) {
+        return;
+    }
+
+    std::stack<std::pair<int, int>> pixels;
+    pixels.push({x, y});
+
+    while (!pixels.empty()) {
+        std::pair<int, int> current = pixels.top();
+        pixels.pop();
+
+        int px = current.first;
+        int py = current.second;
+
+        if (px < 0 || px >= surface->w || py < 0 || py >= surface->h || Primitives::get_pixel(surface, px, py) != target_color) {
+            continue;
+        }
+
+        Primitives::set_pixel(surface, px, py, fill_color);
+
+        pixels.push({px + 1, py});
+        pixels.push({px - 1, py});
+        pixels.push({px, py + 1});
+        pixels.push({px, py - 1});
+    }
+}
+
+
+// Reference implementation: the per-pixel blend that CoverageBlender replaced
+// (get_pixel, SDL_GetRGBA, float mix, SDL_MapRGBA, set_pixel).
+static void legacy_blend_pixel(SDL_Surface* surface, int px, int py, SDL_Color line_color, float intensity) {
+    Uint32 bgPixel = Primitives::get_pixel(surface, px, py);
+    SDL_Color bgColor;
+    SDL_GetRGBA(bgPixel, surface->format, &bgColor.r, &bgColor.g, &bgColor.b, &bgColor.a);
+
+    float alpha = intensity * (line_color.a / 255.0f);
+
+    Uint8 r = Uint8(bgColor.r * (1 - alpha) + line_color.r * alpha);
+    Uint8 g = Uint8(bgColor.g * (1 - alpha) + line_color.g * alpha);
+    Uint8 b = Uint8(bgColor.b * (1 - alpha) + line_color.b * alpha);
+
+    Primitives::set_pixel(surface, px, py, SDL_MapRGBA(surface->format, r, g, b, 255));
+}
+
+
+// Reference implementation: the 4x4 supersampled ellipse that Primitives::draw_analytic_ellipse
+// replaced. Every pixel of the bounding box takes 16 samples of the implicit function; the box
+// is the one each old function used (axis-aligned: radius + radius / 4 + 2, rotated: a square).
+static void legacy_supersampled_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, float angle_rad, Uint32 color, bool filled, float tolerance) {
+    const CoverageBlender blender(color);
+    std::vector<Uint8> coverage_row;
+    const int samples = 4;
+    const float c = cosf(angle_rad), s = sinf(angle_rad);
+    const int margin_x = angle_rad == 0.0f ? rx + rx / samples + 2 : std::max(rx, ry) + 2;
+    const int margin_y = angle_rad == 0.0f ? ry + ry / samples + 2 : std::max(rx, ry) + 2;
+
+    const SDL_Rect& clip = surface->clip_rect;
+    const int x_start = std::max(clip.x, cx - margin_x);
+    const int x_end = std::min(clip.x + clip.w - 1, cx + margin_x);
+    const int y_start = std::max(clip.y, cy - margin_y);
+    const int y_end = std::min(clip.y + clip.h - 1, cy + margin_y);
+    if (x_start > x_end) return;
+    coverage_row.resize(x_end - x_start + 1);
+
+    for (int y = y_start; y <= y_end; ++y) {
+        for (int x = x_start; x <= x_end; ++x) {
+            int inside = 0;
+            for (int sy = 0; sy < samples; ++sy) {
+                for (int sx = 0; sx < samples; ++sx) {
+                    float dx = (x + (sx + 0.5f) / samples) - cx;
+                    float dy = (y + (sy + 0.5f) / samples) - cy;
+                    float u = c * dx + s * dy;
+                    float v = -s * dx + c * dy;
+                    float val = (u * u) / (rx * rx) + (v * v) / (ry * ry);
+                    if (filled ? (val <= 1.0f) : (fabsf(val - 1.0f) <= tolerance)) inside++;
+                }
+            }
+            coverage_row[x - x_start] = (Uint8)((inside * 255 + 8) / 16);
+        }
+        blender.blend_run((Uint32*)((Uint8*)surface->pixels + y * surface->pitch), x_start, coverage_row.data(), x_end - x_start + 1);
+    }
+}
+
+
+// Reference implementation: the point sampler that draw_curve used for flat curves
+// (3 * max(|dx|, |dy|) steps, six pow() calls per step, four blended pixels per sample).
+static void legacy_bezier_curve(SDL_Surface* surface, int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, Uint32 color) {
+    const CoverageBlender blender(color);
+    const SDL_Rect& clip = surface->clip_rect;
+
+    auto blend_at = [&](int px, int py, float coverage) {
+        if (px < clip.x || py < clip.y || px >= clip.x + clip.w || py >= clip.y + clip.h) return;
+        blender.blend((Uint32*)((Uint8*)surface->pixels + py * surface->pitch) + px, coverage);
+    };
+
+    const int steps = std::max(abs(x3 - x0), abs(y3 - y0)) * 3;
+
+    for (int i = 0; i <= steps; i++) {
+        double u = i / (double)steps;
+        double xu = pow(1 - u, 3) * x0 + 3 * u * pow(1 - u, 2) * x1 + 3 * pow(u, 2) * (1 - u) * x2 + pow(u, 3) * x3;
+        double yu = pow(1 - u, 3) * y0 + 3 * u * pow(1 - u, 2) * y1 + 3 * pow(u, 2) * (1 - u) * y2 + pow(u, 3) * y3;
+        int x_int = int(xu), y_int = int(yu);
+        float fx = float(xu - x_int), fy = float(yu - y_int);
+
+        blend_at(x_int,     y_int,     (1.0f - fx) * (1.0f - fy));
+        blend_at(x_int + 1, y_int,     fx * (1.0f - fy));
+        blend_at(x_int,     y_int + 1, (1.0f - fx) * fy);
+        blend_at(x_int + 1, y_int + 1, fx * fy);
+    }
+}
+
+
+// Reference implementation: the bounding-box walk that draw_triangle replaced (three edge
+// functions evaluated for every pixel of the box, top-left rule, set_pixel per covered pixel).
+static void legacy_triangle(SDL_Surface* surface, int x0, int y0, int x1, int y1, int x2, int y2, Uint32 color) {
+    struct Edge { long long A, B, C; bool top_left; };
+    auto make_edge = [](int ax, int ay, int bx, int by) -> Edge {
+        return { (long long)(by - ay), -(long long)(bx - ax), (long long)bx * ay - (long long)by * ax,
+                 (by - ay < 0) || (by == ay && bx - ax < 0) };
+    };
+
+    const Edge edges[3] = { make_edge(x1, y1, x2, y2), make_edge(x2, y2, x0, y0), make_edge(x0, y0, x1, y1) };
+    const long long area2 = (long long)(y1 - y0) * (x2 - x0) - (long long)(x1 - x0) * (y2 - y0);
+    if (area2 == 0) return;
+    const long long sign = area2 > 0 ? 1 : -1;
+
+    const SDL_Rect& clip = surface->clip_rect;
+    const int minx = std::max(std::min(x0, std::min(x1, x2)), clip.x);
+    const int maxx = std::min(std::max(x0, std::max(x1, x2)), clip.x + clip.w - 1);
+    const int miny = std::max(std::min(y0, std::min(y1, y2)), clip.y);
+    const int maxy = std::min(std::max(y0, std::max(y1, y2)), clip.y + clip.h - 1);
+
+    for (int y = miny; y <= maxy; ++y) {
+        for (int x = minx; x <= maxx; ++x) {
+            bool inside = true;
+            for (const Edge& e : edges) {
+                long long E = sign * (e.A * x + e.B * y + e.C + (e.A >> 1) + (e.B >> 1));
+                if (E < (e.top_left ? 0 : 1)) inside = false;
+            }
+            if (inside) Primitives::set_pixel(surface, x, y, color);
+        }
+    }
+}
+
+
+// Reference implementations of the conic fills that ConicSpans replaced: the aliased circle
+// that redrew every row of the disk at each octant step, the midpoint ellipse with a
+// set_pixel/fill_span pair per step, and the anti-aliased circle that computed a distance
+// for every pixel of its bounding box.
+static void legacy_filled_circle(SDL_Surface* surface, int cx, int cy, int radius, Uint32 color) {
+    int x = radius, y = 0, err = 0;
+
+    while (x >= y) {
+        const int px[8] = {cx + x, cx + y, cx - y, cx - x, cx - x, cx - y, cx + y, cx + x};
+        const int py[8] = {cy + y, cy + x, cy + x, cy + y, cy - y, cy - x, cy - x, cy - y};
+        for (int i = 0; i < 8; ++i) Primitives::set_pixel(surface, px[i], py[i], color);
+
+        for (int row = -radius; row <= radius; row++) {
+            int dx = (int)std::sqrt(radius * radius - row * row);
+            Primitives::draw_line(surface, cx - dx, cy + row, cx + dx, cy + row, color, false);
+        }
+
+        y++;
+        if (err <= 0) err += 2 * y + 1;
+        if (err > 0) { x--; err -= 2 * x + 1; }
+    }
+}
+
+
+static void legacy_filled_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, Uint32 color) {
+    int x = 0, y = ry;
+    int rx2 = rx * rx, ry2 = ry * ry, twoRx2 = 2 * rx2, twoRy2 = 2 * ry2;
+    int px = 0, py = twoRx2 * y;
+
+    auto plot = [&]() {
+        Primitives::set_pixel(surface, cx + x, cy + y, color);
+        Primitives::set_pixel(surface, cx - x, cy + y, color);
+        Primitives::set_pixel(surface, cx - x, cy - y, color);
+        Primitives::set_pixel(surface, cx + x, cy - y, color);
+        Primitives::fill_span(surface, cx - x + 1, cx + x - 1, cy + y, color);
+        Primitives::fill_span(surface, cx - x + 1, cx + x - 1, cy - y, color);
+    };
+
+    int p = (int)(ry2 - (rx2 * ry) + 0.25f * rx2);
+    while (px < py) {
+        plot();
+        x++;
+        px += twoRy2;
+        if (p < 0) {
+            p += ry2 + px;
+        } else {
+            y--;
+            py -= twoRx2;
+            p += ry2 + px - py;
+        }
+    }
+
+    p = (int)(ry2 * (x + 0.5f) * (x + 0.5f) + rx2 * (y - 1) * (y - 1) - rx2 * ry2);
+    while (y >= 0) {
+        plot();
+        y--;
+        py -= twoRx2;
+        if (p > 0) {
+            p += rx2 - py;
+        } else {
+            x++;
+            px += twoRy2;
+            p += rx2 - py + px;
+        }
+    }
+}
+
+
+static void legacy_aa_circle(SDL_Surface* surface, int cx, int cy, int radius, Uint32 color) {
+    const CoverageBlender blender(color);
+    std::vector<Uint8> coverage_row(2 * radius + 3);
+
+    for (int py = cy - radius - 1; py <= cy + radius + 1; py++) {
+        for (int px = cx - radius - 1; px <= cx + radius + 1; px++) {
+            float dx = px - cx, dy = py - cy;
+            coverage_row[px - (cx - radius - 1)] = CoverageBlender::to_coverage(radius + 0.5f - sqrtf(dx * dx + dy * dy));
+        }
+        blender.blend_run((Uint32*)((Uint8*)surface->pixels + py * surface->pitch), cx - radius - 1, coverage_row.data(), 2 * radius + 3);
+    }
+}
+
+
+// Reference implementation: the scanline fill that tested every edge on every row and
+// sorted a freshly allocated crossing list per row (even-odd rule).
+static void legacy_fill_polygon(SDL_Surface* s, const std::vector<SDL_Point>& pts, Uint32 color) {
+    struct Edge { int y_min, y_max; double x_at_ymin, inv_slope; };
+    std::vector<Edge> edges;
+    int ymin = pts[0].y, ymax = pts[0].y;
+
+    for (size_t i = 0; i < pts.size(); ++i) {
+        SDL_Point a = pts[i], b = pts[(i + 1) % pts.size()];
+        ymin = std::min(ymin, a.y);
+        ymax = std::max(ymax, a.y);
+        if (a.y == b.y) continue;
+        if (a.y > b.y) std::swap(a, b);
+        edges.push_back({a.y, b.y, (double)a.x, double(b.x - a.x) / double(b.y - a.y)});
+    }
+
+    ymin = std::max(s->clip_rect.y, ymin);
+    ymax = std::min(s->clip_rect.y + s->clip_rect.h - 1, ymax);
+
+    for (int y = ymin; y <= ymax; ++y) {
+        std::vector<double> xs;
+        double scan_y = y + 0.5;
+        for (const auto& e : edges) {
+            if (scan_y >= e.y_min && scan_y < e.y_max) xs.push_back(e.x_at_ymin + (scan_y - e.y_min) * e.inv_slope);
+        }
+
+        std::sort(xs.begin(), xs.end());
+        for (size_t i = 0; i + 1 < xs.size(); i += 2) {
+            Primitives::fill_span(s, (int)std::ceil(xs[i]), (int)std::floor(xs[i + 1]), y, color);
+        }
+    }
+}
+
+
+static SDL_Surface* create_canvas(int width, int height) {
+    return CanvasFormat::create_surface(width, height);
+}
+
+
+static void copy_pixels(SDL_Surface* dst, const SDL_Surface* src) {
+    for (int y = 0; y < src->h; ++y) {
+        memcpy((Uint8*)dst->pixels + y * dst->pitch, (const Uint8*)src->pixels + y * src->pitch, src->w * 4);
+    }
+}
+
+
+static bool same_pixels(const SDL_Surface* a, const SDL_Surface* b) {
+    for (int y = 0; y < a->h; ++y) {
+        if (memcmp((const Uint8*)a->pixels + y * a->pitch, (const Uint8*)b->pixels + y * b->pitch, a->w * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static double elapsed_ms(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+
+// Times both fills from the same starting image and checks that they paint the same pixels.
+static void bench_flood_fill(const char* name, SDL_Surface* source, int x, int y, Uint32 fill_color, int iterations) {
+    SDL_Surface* legacy = create_canvas(source->w, source->h);
+    SDL_Surface* span = create_canvas(source->w, source->h);
+    double legacy_ms = 0.0, span_ms = 0.0;
+
+    for (int i = 0; i < iterations; ++i) {
+        copy_pixels(legacy, source);
+        Uint64 start = SDL_GetPerformanceCounter();
+        legacy_flood_fill(legacy, x, y, fill_color);
+        legacy_ms += elapsed_ms(start);
+
+        copy_pixels(span, source);
+        start = SDL_GetPerformanceCounter();
+        Primitives::flood_fill(span, x, y, fill_color);
+        span_ms += elapsed_ms(start);
+    }
+
+    legacy_ms /= iterations;
+    span_ms /= iterations;
+
+    printf("%-28s %12.3f %12.3f %9.1fx   %s\n", name, legacy_ms, span_ms,
+           span_ms > 0.0 ? legacy_ms / span_ms : 0.0, same_pixels(legacy, span) ? "yes" : "NO");
+
+    SDL_FreeSurface(legacy);
+    SDL_FreeSurface(span);
+}
+
+
+// Fills the same span on every row of the canvas, cycling through the rows, and
+// reports how many spans per second each kernel writes.
+static void bench_span(const char* name, SDL_Surface* canvas, int width, int iterations) {
+    const int spans = 200000;
+    const Uint32 color = CanvasFormat::pack(247, 30, 113);
+    const int x0 = (canvas->w - width) / 2;
+    Uint8* base = (Uint8*)canvas->pixels;
+    double scalar_ms = 0.0, kernel_ms = 0.0;
+
+    for (int i = 0; i < iterations; ++i) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int s = 0; s < spans; ++s) {
+            SpanWriter::fill_row_scalar((Uint32*)(base + (s % canvas->h) * canvas->pitch), x0, x0 + width - 1, color);
+        }
+        scalar_ms += elapsed_ms(start);
+
+        start = SDL_GetPerformanceCounter();
+        for (int s = 0; s < spans; ++s) {
+            SpanWriter::fill_row((Uint32*)(base + (s % canvas->h) * canvas->pitch), x0, x0 + width - 1, color);
+        }
+        kernel_ms += elapsed_ms(start);
+    }
+
+    const double scalar_rate = scalar_ms > 0.0 ? spans * iterations / (scalar_ms / 1000.0) : 0.0;
+    const double kernel_rate = kernel_ms > 0.0 ? spans * iterations / (kernel_ms / 1000.0) : 0.0;
+
+    printf("%-28s %12.2f %12.2f %9.1fx\n", name, scalar_rate / 1e6, kernel_rate / 1e6,
+           scalar_rate > 0.0 ? kernel_rate / scalar_rate : 0.0);
+}
+
+
+// Blends a coverage ramp over every row of the canvas with the legacy per-pixel path,
+// with CoverageBlender::blend and with CoverageBlender::blend_run, in millions of pixels per second.
+static void bench_blend(SDL_Surface* canvas, int iterations) {
+    const SDL_Color color = {247, 30, 113, 255};
+    const Uint32 mapped = CanvasFormat::pack(color.r, color.g, color.b);
+    const CoverageBlender blender(mapped);
+    const double pixels = (double)canvas->w * canvas->h * iterations;
+    std::vector<Uint8> coverage(canvas->w);
+    double legacy_ms = 0.0, single_ms = 0.0, run_ms = 0.0;
+
+    for (int x = 0; x < canvas->w; ++x) {
+        coverage[x] = (Uint8)(x & 255);
+    }
+
+    for (int i = 0; i < iterations; ++i) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int y = 0; y < canvas->h; ++y) {
+            for (int x = 0; x < canvas->w; ++x) {
+                legacy_blend_pixel(canvas, x, y, color, coverage[x] / 255.0f);
+            }
+        }
+        legacy_ms += elapsed_ms(start);
+
+        start = SDL_GetPerformanceCounter();
+        for (int y = 0; y < canvas->h; ++y) {
+            Uint32* row = (Uint32*)((Uint8*)canvas->pixels + y * canvas->pitch);
+            for (int x = 0; x < canvas->w; ++x) {
+                blender.blend(row + x, coverage[x]);
+            }
+        }
+        single_ms += elapsed_ms(start);
+
+        start = SDL_GetPerformanceCounter();
+        for (int y = 0; y < canvas->h; ++y) {
+            blender.blend_run((Uint32*)((Uint8*)canvas->pixels + y * canvas->pitch), 0, coverage.data(), canvas->w);
+        }
+        run_ms += elapsed_ms(start);
+    }
+
+    printf("%-28s %12.1f\n", "legacy blend_pixel", pixels / (legacy_ms * 1000.0));
+    printf("%-28s %12.1f %9.1fx\n", "CoverageBlender::blend", pixels / (single_ms * 1000.0), legacy_ms / single_ms);
+    printf("%-28s %12.1f %9.1fx\n", "CoverageBlender::blend_run", pixels / (run_ms * 1000.0), legacy_ms / run_ms);
+}
+
+
+// Times the anti-aliased primitives that go through the blender, in ms per call.
+static void bench_aa_primitives(SDL_Surface* canvas, int iterations) {
+    const Uint32 color = CanvasFormat::pack(30, 113, 247);
+    const int cx = canvas->w / 2, cy = canvas->h / 2;
+    double circle_ms = 0.0, ellipse_ms = 0.0, rotated_ms = 0.0, lines_ms = 0.0, curve_ms = 0.0, stroke_ms = 0.0;
+
+    // Zigzag of 100 points across the canvas, stroked 6 px wide with round joins.
+    std::vector<SDL_FPoint> zigzag;
+    for (int k = 0; k < 100; ++k) {
+        zigzag.push_back({50.0f + k * 18.0f, (k % 2) ? 200.0f : 900.0f});
+    }
+
+    for (int i = 0; i < iterations; ++i) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        Primitives::draw_circle(canvas, cx, cy, 300, color, true, true);
+        circle_ms += elapsed_ms(start);
+
+        start = SDL_GetPerformanceCounter();
+        Primitives::draw_ellipse(canvas, cx, cy, 400, 250, color, true, true);
+        ellipse_ms += elapsed_ms(start);
+
+        start = SDL_GetPerformanceCounter();
+        Primitives::draw_rotated_ellipse(canvas, cx, cy, 300, 150, 0.6f, color, true);
+        rotated_ms += elapsed_ms(start);
+
+        start = SDL_GetPerformanceCounter();
+        for (int k = 0; k < 1000; ++k) {
+            Primitives::draw_line(canvas, (k * 37) % canvas->w, 0, (k * 91) % canvas->w, canvas->h - 1, color, true);
+        }
+        lines_ms += elapsed_ms(start);
+
+        start = SDL_GetPerformanceCounter();
+        for (int k = 0; k < 100; ++k) {
+            Primitives::draw_curve(canvas, 100, 900, 500 + k, 100, 1400 - k, 1000, 1800, 200, color, true);
+        }
+        curve_ms += elapsed_ms(start);
+
+        start = SDL_GetPerformanceCounter();
+        Stroker::stroke_polyline(canvas, zigzag, color, Stroker::default_style(6.0f));
+        stroke_ms += elapsed_ms(start);
+    }
+
+    printf("%-28s %12.3f\n", "filled AA circle r=300", circle_ms / iterations);
+    printf("%-28s %12.3f\n", "filled SSAA ellipse 400x250", ellipse_ms / iterations);
+    printf("%-28s %12.3f\n", "filled rotated ellipse", rotated_ms / iterations);
+    printf("%-28s %12.3f\n", "1000 Wu lines", lines_ms / iterations);
+    printf("%-28s %12.3f\n", "100 AA curves", curve_ms / iterations);
+    printf("%-28s %12.3f\n", "6 px stroke, 100 points", stroke_ms / iterations);
+}
+
+
+// Draws one ellipse with the supersampled reference and with the analytic rasterizer, on
+// white canvases, and reports the time of each and the largest and mean channel difference.
+static void bench_ellipse(const char* name, SDL_Surface* legacy, SDL_Surface* analytic, int rx, int ry, float angle_rad, bool filled, int iterations) {
+    const Uint32 white = CanvasFormat::pack(255, 255, 255);
+    const Uint32 color = CanvasFormat::pack(30, 113, 247);
+    const int cx = legacy->w / 2, cy = legacy->h / 2;
+    // Mesma espessura de contorno dos chamadores: draw_ellipse (0.07 / 4) e draw_rotated_ellipse (0.07).
+    const float tolerance = angle_rad == 0.0f ? 0.07f / 4 : 0.07f;
+    double legacy_ms = 0.0, analytic_ms = 0.0;
+
+    for (int i = 0; i < iterations; ++i) {
+        SDL_FillRect(legacy, nullptr, white);
+        Uint64 start = SDL_GetPerformanceCounter();
+        legacy_supersampled_ellipse(legacy, cx, cy, rx, ry, angle_rad, color, filled, tolerance);
+        legacy_ms += elapsed_ms(start);
+
+        SDL_FillRect(analytic, nullptr, white);
+        start = SDL_GetPerformanceCounter();
+        if (angle_rad == 0.0f) {
+            Primitives::draw_ellipse(analytic, cx, cy, rx, ry, color, true, filled);
+        } else {
+            Primitives::draw_rotated_ellipse(analytic, cx, cy, rx, ry, angle_rad, color, filled);
+        }
+        analytic_ms += elapsed_ms(start);
+    }
+
+    int max_diff = 0;
+    long long total_diff = 0, channels = 0;
+    for (int y = 0; y < legacy->h; ++y) {
+        const Uint8* a = (const Uint8*)legacy->pixels + y * legacy->pitch;
+        const Uint8* b = (const Uint8*)analytic->pixels + y * analytic->pitch;
+        for (int k = 0; k < legacy->w * 4; ++k) {
+            int diff = abs((int)a[k] - (int)b[k]);
+            if (diff == 0) continue;
+            max_diff = std::max(max_diff, diff);
+            total_diff += diff;
+            channels++;
+        }
+    }
+
+    legacy_ms /= iterations;
+    analytic_ms /= iterations;
+
+    printf("%-28s %12.3f %12.3f %9.1fx %9d %9.2f\n", name, legacy_ms, analytic_ms,
+           analytic_ms > 0.0 ? legacy_ms / analytic_ms : 0.0, max_diff, channels ? (double)total_diff / channels : 0.0);
+}
+
+
+// Times the old point sampler against the flattened curves (ms per 100 anti-aliased curves),
+// and the flattener alone (millions of curves per second, average segments per curve).
+static void bench_curves(SDL_Surface* canvas, int iterations) {
+    const Uint32 color = CanvasFormat::pack(30, 113, 247);
+    const int curves = 100, flatten_curves = 100000;
+    double legacy_ms = 0.0, flattened_ms = 0.0, flatten_ms = 0.0;
+    long long segments = 0;
+    std::vector<SDL_FPoint> polyline;
+
+    for (int i = 0; i < iterations; ++i) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        for (int k = 0; k < curves; ++k) {
+            legacy_bezier_curve(canvas, 100, 900, 500 + k, 100, 1400 - k, 1000, 1800, 200, color);
+        }
+        legacy_ms += elapsed_ms(start);
+
+        start = SDL_GetPerformanceCounter();
+        for (int k = 0; k < curves; ++k) {
+            Primitives::draw_curve(canvas, 100, 900, 500 + k, 100, 1400 - k, 1000, 1800, 200, color, true);
+        }
+        flattened_ms += elapsed_ms(start);
+
+        segments = 0;
+        start = SDL_GetPerformanceCounter();
+        for (int k = 0; k < flatten_curves; ++k) {
+            polyline.clear();
+            CurveFlattener::flatten_cubic(polyline, 100.0f, 900.0f, 500.0f + k % 500, 100.0f, 1400.0f, 1000.0f - k % 800, 1800.0f, 200.0f);
+            segments += (long long)polyline.size() - 1;
+        }
+        flatten_ms += elapsed_ms(start);
+    }
+
+    legacy_ms /= iterations;
+    flattened_ms /= iterations;
+    flatten_ms /= iterations;
+
+    printf("%-28s %12.3f\n", "100 curves, point sampler", legacy_ms);
+    printf("%-28s %12.3f %9.1fx\n", "100 curves, flattened", flattened_ms, flattened_ms > 0.0 ? legacy_ms / flattened_ms : 0.0);
+    printf("%-28s %12.2f   (%.1f segments per curve)\n", "flatten_cubic, Mcurves/s", flatten_curves / (flatten_ms * 1000.0),
+           (double)segments / flatten_curves);
+}
+
+
+// Times the per-pixel bounding-box walk against the span rasterizer (ms per batch) on
+// a large triangle, long thin slivers, many small triangles and rotated rectangles.
+static void bench_triangles(SDL_Surface* legacy, SDL_Surface* spans, int iterations) {
+    const Uint32 color = CanvasFormat::pack(113, 247, 30);
+
+    struct Case { const char* name; int count; };
+    const Case cases[] = { {"1 large triangle", 1}, {"100 thin slivers", 100}, {"10000 small triangles", 10000}, {"1000 rotated rectangles", 1000} };
+
+    for (int c = 0; c < 4; ++c) {
+        double legacy_ms = 0.0, span_ms = 0.0;
+
+        for (int pass = 0; pass < 2; ++pass) {
+            SDL_Surface* target = pass == 0 ? legacy : spans;
+            SDL_FillRect(target, nullptr, 0);
+
+            for (int i = 0; i < iterations; ++i) {
+                Uint64 start = SDL_GetPerformanceCounter();
+
+                for (int k = 0; k < cases[c].count; ++k) {
+                    int x0, y0, x1, y1, x2, y2;
+
+                    if (c == 0) {
+                        x0 = 50; y0 = 40; x1 = 1850; y1 = 300; x2 = 700; y2 = 1040;
+                    } else if (c == 1) {
+                        x0 = 10; y0 = 10 * k; x1 = 1900; y1 = 10 * k + 60; x2 = 1900; y2 = 10 * k + 64;
+                    } else if (c == 2) {
+                        x0 = (k * 37) % 1880; y0 = (k * 53) % 1040; x1 = x0 + 30; y1 = y0 + 7; x2 = x0 + 11; y2 = y0 + 33;
+                    } else {
+                        // Rectangle 80x40 rotated by k degrees. The legacy path splits it along the
+                        // longest diagonal, as draw_rectangle does.
+                        const double angle = k * M_PI / 180.0, co = std::cos(angle), si = std::sin(angle);
+                        const int cx = 100 + (k * 41) % 1720, cy = 100 + (k * 29) % 880;
+                        int xs[4], ys[4];
+                        const double px[4] = {-40, 40, 40, -40}, py[4] = {-20, -20, 20, 20};
+                        for (int v = 0; v < 4; ++v) {
+                            xs[v] = cx + (int)std::lround(co * px[v] - si * py[v]);
+                            ys[v] = cy + (int)std::lround(si * px[v] + co * py[v]);
+                        }
+                        if (pass == 0) {
+                            auto d2 = [&](int a, int b) {
+                                return (long long)(xs[a] - xs[b]) * (xs[a] - xs[b]) + (long long)(ys[a] - ys[b]) * (ys[a] - ys[b]);
+                            };
+                            const int pairs[6][2] = { {0,1},{0,2},{0,3},{1,2},{1,3},{2,3} };
+                            int di = 0, dj = 1;
+                            for (int p = 1; p < 6; ++p) {
+                                if (d2(pairs[p][0], pairs[p][1]) > d2(di, dj)) { di = pairs[p][0]; dj = pairs[p][1]; }
+                            }
+                            int others[2], n = 0;
+                            for (int v = 0; v < 4; ++v) if (v != di && v != dj) others[n++] = v;
+
+                            legacy_triangle(target, xs[di], ys[di], xs[others[0]], ys[others[0]], xs[dj], ys[dj], color);
+                            legacy_triangle(target, xs[di], ys[di], xs[dj], ys[dj], xs[others[1]], ys[others[1]], color);
+                        } else {
+                            Primitives::draw_rectangle(target, xs[0], ys[0], xs[1], ys[1], xs[2], ys[2], xs[3], ys[3], color);
+                        }
+                        continue;
+                    }
+
+                    if (pass == 0) legacy_triangle(target, x0, y0, x1, y1, x2, y2, color);
+                    else Primitives::draw_triangle(target, x0, y0, x1, y1, x2, y2, color);
+                }
+
+                (pass == 0 ? legacy_ms : span_ms) += elapsed_ms(start);
+            }
+        }
+
+        legacy_ms /= iterations;
+        span_ms /= iterations;
+
+        printf("%-28s %12.3f %12.3f %9.1fx   %s\n", cases[c].name, legacy_ms, span_ms,
+               span_ms > 0.0 ? legacy_ms / span_ms : 0.0, same_pixels(legacy, spans) ? "yes" : "NO");
+    }
+}
+
+
+// Times the legacy conic fills against the span versions (ms per call) and counts the
+// pixels where the two canvases differ. The aliased circle used to drop the last pixel
+// of the rows where its outline falls inside the disk, so it is not expected to match.
+static void bench_conics(SDL_Surface* legacy, SDL_Surface* spans, int iterations) {
+    const Uint32 white = CanvasFormat::pack(255, 255, 255);
+    const Uint32 color = CanvasFormat::pack(247, 113, 30);
+    const int cx = legacy->w / 2, cy = legacy->h / 2;
+    SpanList cached;
+
+    const char* names[] = {"aliased circle r=300", "aliased circle r=40", "aliased ellipse 400x250", "AA circle r=300", "cached span list r=300"};
+
+    for (int c = 0; c < 5; ++c) {
+        double legacy_ms = 0.0, span_ms = 0.0;
+        const int radius = c == 1 ? 40 : 300;
+
+        for (int pass = 0; pass < 2; ++pass) {
+            SDL_Surface* target = pass == 0 ? legacy : spans;
+            SDL_FillRect(target, nullptr, white);
+            if (c == 4 && pass == 1) ConicSpans::circle(cached, cx, cy, radius);
+
+            for (int i = 0; i < iterations; ++i) {
+                Uint64 start = SDL_GetPerformanceCounter();
+
+                if (c <= 1 || c == 4) {
+                    if (pass == 0) legacy_filled_circle(target, cx, cy, radius, color);
+                    else if (c == 4) cached.fill(target, color);
+                    else Primitives::draw_circle(target, cx, cy, radius, color, false, true);
+                } else if (c == 2) {
+                    if (pass == 0) legacy_filled_ellipse(target, cx, cy, 400, 250, color);
+                    else Primitives::draw_ellipse(target, cx, cy, 400, 250, color, false, true);
+                } else {
+                    if (pass == 0) legacy_aa_circle(target, cx, cy, radius, color);
+                    else Primitives::draw_circle(target, cx, cy, radius, color, true, true);
+                }
+
+                (pass == 0 ? legacy_ms : span_ms) += elapsed_ms(start);
+            }
+        }
+
+        long differing = 0;
+        for (int y = 0; y < legacy->h; ++y) {
+            const Uint32* a = (const Uint32*)((const Uint8*)legacy->pixels + y * legacy->pitch);
+            const Uint32* b = (const Uint32*)((const Uint8*)spans->pixels + y * spans->pitch);
+            for (int x = 0; x < legacy->w; ++x) differing += a[x] != b[x];
+        }
+
+        legacy_ms /= iterations;
+        span_ms /= iterations;
+        printf("%-28s %12.3f %12.3f %9.1fx %10ld\n", names[c], legacy_ms, span_ms,
+               span_ms > 0.0 ? legacy_ms / span_ms : 0.0, differing);
+    }
+}
+
+
+// Times the per-row edge scan against the active edge list (ms per polygon) on star-shaped
+// "lasso" polygons of growing vertex count, and checks the even-odd result matches.
+static void bench_polygons(SDL_Surface* legacy, SDL_Surface* aet, int iterations) {
+    const Uint32 color = CanvasFormat::pack(30, 247, 113);
+    const int counts[] = {8, 100, 1000, 5000};
+
+    for (int count : counts) {
+        // Radius wobbling around 400 px, so the outline crosses each row many times.
+        std::vector<SDL_Point> pts;
+        for (int k = 0; k < count; ++k) {
+            const double angle = 2.0 * M_PI * k / count;
+            const double radius = 400.0 + 100.0 * std::sin(angle * 37.0) + 20.0 * ((k * 7919) % 13);
+            pts.push_back({legacy->w / 2 + (int)std::lround(radius * std::cos(angle)),
+                           legacy->h / 2 + (int)std::lround(radius * std::sin(angle))});
+        }
+
+        double legacy_ms = 0.0, aet_ms = 0.0;
+        SDL_FillRect(legacy, nullptr, 0);
+        SDL_FillRect(aet, nullptr, 0);
+
+        for (int i = 0; i < iterations; ++i) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            legacy_fill_polygon(legacy, pts, color);
+            legacy_ms += elapsed_ms(start);
+
+            start = SDL_GetPerformanceCounter();
+            Primitives::fill_polygon(aet, pts, color);
+            aet_ms += elapsed_ms(start);
+        }
+
+        legacy_ms /= iterations;
+        aet_ms /= iterations;
+
+        char name[32];
+        snprintf(name, sizeof(name), "%d vertices", count);
+        printf("%-28s %12.3f %12.3f %9.1fx   %s\n", name, legacy_ms, aet_ms,
+               aet_ms > 0.0 ? legacy_ms / aet_ms : 0.0, same_pixels(legacy, aet) ? "yes" : "NO");
+    }
+}
+
+
+// Same geometry through both transforms: snapped (universe_to_canvas, floored to whole
+// pixels, then the integer rasterizers) and 24.8 fixed point (universe_to_canvas_fixed,
+// then the fixed-point overloads). Times are ms per pass; "diff px" counts the pixels
+// that the sub-pixel vertices move.
+static void bench_fixed_point(SDL_Surface* snapped, SDL_Surface* fixed, int iterations) {
+    const Uint32 color = CanvasFormat::pack(30, 113, 247);
+    const int w = snapped->w, h = snapped->h;
+
+    // Universe with the size of the canvas (scale 1, y up), coordinates off the pixel grid.
+    auto universe = [&](double x, double y) { return Point(x, (double)h - y); };
+
+    struct Case { const char* name; int count; };
+    const Case cases[] = { {"10000 small triangles", 10000}, {"1000 rotated rectangles", 1000}, {"2000 lines", 2000}, {"polygon, 1000 vertices", 1} };
+
+    for (int c = 0; c < 4; ++c) {
+        double snapped_ms = 0.0, fixed_ms = 0.0;
+
+        for (int pass = 0; pass < 2; ++pass) {
+            SDL_Surface* target = pass == 0 ? snapped : fixed;
+            SDL_FillRect(target, nullptr, 0);
+
+            for (int i = 0; i < iterations; ++i) {
+                Uint64 start = SDL_GetPerformanceCounter();
+
+                if (c == 3) {
+                    std::vector<Point> outline;
+                    for (int k = 0; k < 1000; ++k) {
+                        const double angle = 2.0 * M_PI * k / 1000;
+                        const double radius = 400.0 + 100.0 * std::sin(angle * 37.0) + 0.37 * ((k * 7919) % 13);
+                        outline.push_back(universe(w / 2 + radius * std::cos(angle), h / 2 + radius * std::sin(angle)));
+                    }
+                    if (pass == 0) {
+                        std::vector<SDL_Point> pts;
+                        for (const Point& u : outline) {
+                            Point p = Utils::universe_to_canvas(u, w, h, w, h);
+                            pts.push_back({(int)p.get_x(), (int)p.get_y()});
+                        }
+                        Primitives::fill_polygon(target, pts, color);
+                    } else {
+                        std::vector<FixedPoint::Vertex> pts;
+                        for (const Point& u : outline) pts.push_back(Utils::universe_to_canvas_fixed(u, w, h, w, h));
+                        Primitives::fill_polygon(target, pts, color);
+                    }
+                }
+
+                for (int k = 0; c < 3 && k < cases[c].count; ++k) {
+                    const int corners = c == 0 ? 3 : (c == 1 ? 4 : 2);
+                    Point u[4] = { Point(0, 0), Point(0, 0), Point(0, 0), Point(0, 0) };
+
+                    if (c == 0) {
+                        const double x = (k * 37.3) - 1880.0 * std::floor(k * 37.3 / 1880.0), y = (k * 53.7) - 1040.0 * std::floor(k * 53.7 / 1040.0);
+                        u[0] = universe(x, y); u[1] = universe(x + 30.4, y + 7.2); u[2] = universe(x + 11.6, y + 33.1);
+                    } else if (c == 1) {
+                        const double angle = k * M_PI / 180.0, co = std::cos(angle), si = std::sin(angle);
+                        const double cx = 100.25 + (k * 41) % 1720, cy = 100.75 + (k * 29) % 880;
+                        const double px[4] = {-40, 40, 40, -40}, py[4] = {-20, -20, 20, 20};
+                        for (int v = 0; v < 4; ++v) u[v] = universe(cx + co * px[v] - si * py[v], cy + si * px[v] + co * py[v]);
+                    } else {
+                        const double angle = k * 0.37;
+                        u[0] = universe(960.3, 540.6);
+                        u[1] = universe(960.3 + 500.0 * std::cos(angle), 540.6 + 500.0 * std::sin(angle));
+                    }
+
+                    if (pass == 0) {
+                        int x[4], y[4];
+                        for (int v = 0; v < corners; ++v) {
+                            Point p = Utils::universe_to_canvas(u[v], w, h, w, h);
+                            x[v] = (int)p.get_x();
+                            y[v] = (int)p.get_y();
+                        }
+                        if (c == 0) Primitives::draw_triangle(target, x[0], y[0], x[1], y[1], x[2], y[2], color);
+                        else if (c == 1) Primitives::draw_rectangle(target, x[0], y[0], x[1], y[1], x[2], y[2], x[3], y[3], color);
+                        else Primitives::draw_line(target, x[0], y[0], x[1], y[1], color, false);
+                    } else {
+                        FixedPoint::Vertex v[4];
+                        for (int n = 0; n < corners; ++n) v[n] = Utils::universe_to_canvas_fixed(u[n], w, h, w, h);
+                        if (c == 0) Primitives::draw_triangle(target, v[0], v[1], v[2], color);
+                        else if (c == 1) Primitives::draw_rectangle(target, v[0], v[1], v[2], v[3], color);
+                        else Primitives::draw_line(target, v[0], v[1], color);
+                    }
+                }
+
+                (pass == 0 ? snapped_ms : fixed_ms) += elapsed_ms(start);
+            }
+        }
+
+        snapped_ms /= iterations;
+        fixed_ms /= iterations;
+
+        long long diff = 0;
+        for (int y = 0; y < h; ++y) {
+            const Uint32* a = (const Uint32*)((const Uint8*)snapped->pixels + y * snapped->pitch);
+            const Uint32* b = (const Uint32*)((const Uint8*)fixed->pixels + y * fixed->pitch);
+            for (int x = 0; x < w; ++x) diff += a[x] != b[x];
+        }
+
+        printf("%-28s %12.3f %12.3f %9.1fx %10lld\n", cases[c].name, snapped_ms, fixed_ms,
+               fixed_ms > 0.0 ? snapped_ms / fixed_ms : 0.0, diff);
+    }
+}
+
+
+// Kernel suite: every Primitives entry point (and through them every private kernel) at
+// several sizes, on a plain SDL_CreateRGBSurface target. Each case is warmed up, then
+// timed in 'repetitions' samples of enough calls to last about a millisecond; the median
+// sample gives the cost per call, and the pixels a call writes (counted once on a cleared
+// canvas) turn it into pixels per second and cycles per pixel.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BENCHMARK_HAS_TSC
+#endif
+
+static Uint64 read_cycles() {
+#ifdef BENCHMARK_HAS_TSC
+    return __builtin_ia32_rdtsc();      // Reference cycles (constant-rate TSC).
+#else
+    return 0;
+#endif
+}
+
+
+struct KernelCase {
+    const char* name;
+    std::function<void(SDL_Surface* target, int size)> draw;
+    std::function<void(SDL_Surface* target, int size)> prepare;     // Untimed, before every call (flood fill).
+};
+
+
+// A rotating star with 'points' tips, 'size' pixels across, centred at (cx, cy).
+static std::vector<SDL_Point> star_points(int cx, int cy, int size, int points) {
+    std::vector<SDL_Point> star;
+    for (int k = 0; k < points * 2; ++k) {
+        const double angle = k * M_PI / points;
+        const double radius = (k % 2 ? 0.2 : 0.5) * size;
+        star.push_back({cx + (int)(radius * cos(angle)), cy + (int)(radius * sin(angle))});
+    }
+    return star;
+}
+
+
+// Runs 'calls' calls of a case, returning performance counter ticks and cycles. Cases
+// with a prepare step are timed call by call, so the reset is left out.
+static void run_kernel(const KernelCase& kernel, SDL_Surface* target, int size, int calls, Uint64* ticks, Uint64* cycles) {
+    *ticks = 0;
+    *cycles = 0;
+
+    if (!kernel.prepare) {
+        const Uint64 start = SDL_GetPerformanceCounter(), start_cycles = read_cycles();
+        for (int i = 0; i < calls; ++i) kernel.draw(target, size);
+        *cycles = read_cycles() - start_cycles;
+        *ticks = SDL_GetPerformanceCounter() - start;
+        return;
+    }
+
+    for (int i = 0; i < calls; ++i) {
+        kernel.prepare(target, size);
+        const Uint64 start = SDL_GetPerformanceCounter(), start_cycles = read_cycles();
+        kernel.draw(target, size);
+        *cycles += read_cycles() - start_cycles;
+        *ticks += SDL_GetPerformanceCounter() - start;
+    }
+}
+
+
+static void bench_kernel(const KernelCase& kernel, SDL_Surface* target, int size, int repetitions) {
+    const Uint32 background = CanvasFormat::pack(255, 255, 255);
+    const double frequency = (double)SDL_GetPerformanceFrequency();
+
+    // Pixels written by one call.
+    SDL_FillRect(target, nullptr, background);
+    if (kernel.prepare) kernel.prepare(target, size);
+
+    std::vector<Uint32> before;
+    for (int y = 0; y < target->h; ++y) {
+        const Uint32* row = (const Uint32*)((const Uint8*)target->pixels + y * target->pitch);
+        before.insert(before.end(), row, row + target->w);
+    }
+
+    kernel.draw(target, size);
+
+    long long pixels = 0;
+    for (int y = 0; y < target->h; ++y) {
+        const Uint32* row = (const Uint32*)((const Uint8*)target->pixels + y * target->pitch);
+        for (int x = 0; x < target->w; ++x) pixels += row[x] != before[(size_t)y * target->w + x];
+    }
+
+    // Warm-up, growing the batch until one sample lasts about a millisecond.
+    Uint64 ticks = 0, cycles = 0;
+    int calls = 1;
+    for (;;) {
+        run_kernel(kernel, target, size, calls, &ticks, &cycles);
+        if (ticks >= frequency / 1000.0 || calls >= (1 << 20)) break;
+        calls *= 2;
+    }
+    run_kernel(kernel, target, size, calls, &ticks, &cycles);
+
+    std::vector<double> ns_per_call, cycles_per_call;
+    for (int r = 0; r < repetitions; ++r) {
+        run_kernel(kernel, target, size, calls, &ticks, &cycles);
+        ns_per_call.push_back(ticks * 1e9 / frequency / calls);
+        cycles_per_call.push_back((double)cycles / calls);
+    }
+
+    std::sort(ns_per_call.begin(), ns_per_call.end());
+    std::sort(cycles_per_call.begin(), cycles_per_call.end());
+    const double median_ns = ns_per_call[ns_per_call.size() / 2];
+    const double median_cycles = cycles_per_call[cycles_per_call.size() / 2];
+
+    // Spread: median absolute deviation, relative to the median.
+    std::vector<double> deviations;
+    for (double ns : ns_per_call) deviations.push_back(fabs(ns - median_ns));
+    std::sort(deviations.begin(), deviations.end());
+    const double spread = median_ns > 0.0 ? 100.0 * deviations[deviations.size() / 2] / median_ns : 0.0;
+
+    char cycles_text[32] = "-";
+#ifdef BENCHMARK_HAS_TSC
+    if (pixels > 0) snprintf(cycles_text, sizeof(cycles_text), "%.2f", median_cycles / pixels);
+#else
+    (void)median_cycles;
+#endif
+
+    printf("%-30s %6d %10lld %12.3f %12.3f %7.1f%% %10.1f %10s\n", kernel.name, size, pixels,
+           median_ns / 1000.0, ns_per_call.front() / 1000.0, spread,
+           median_ns > 0.0 ? pixels * 1000.0 / median_ns : 0.0, cycles_text);
+}
+
+
+static void bench_kernel_suite(int repetitions) {
+    const int sizes[] = {16, 64, 256};
+    const int canvas_size = 512;
+    const Uint32 color = CanvasFormat::pack(30, 113, 247);
+    const Uint32 translucent = CanvasFormat::pack(30, 113, 247, 128);
+    const SDL_Color text_color = {30, 113, 247, 255};
+    const int c = canvas_size / 2;
+
+    SDL_Surface* target = SDL_CreateRGBSurface(0, canvas_size, canvas_size, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000);
+    if (!target) return;
+
+    // Text needs the interface fonts (run from the project root).
+    TTF_Font* font = nullptr;
+    if (TTF_Init() == 0 && FontManager::load_fonts()) font = FontManager::roboto_regular_15;
+
+    const std::vector<KernelCase> cases = {
+        {"draw_line AA shallow (Wu)", [=](SDL_Surface* s, int n) { Primitives::draw_line(s, c - n / 2, c - n / 8, c + n / 2, c + n / 8, color, true); }, nullptr},
+        {"draw_line AA steep (Wu)", [=](SDL_Surface* s, int n) { Primitives::draw_line(s, c - n / 8, c - n / 2, c + n / 8, c + n / 2, color, true); }, nullptr},
+        {"draw_line shallow (Bresenham)", [=](SDL_Surface* s, int n) { Primitives::draw_line(s, c - n / 2, c - n / 8, c + n / 2, c + n / 8, color, false); }, nullptr},
+        {"draw_line steep (Bresenham)", [=](SDL_Surface* s, int n) { Primitives::draw_line(s, c - n / 8, c - n / 2, c + n / 8, c + n / 2, color, false); }, nullptr},
+        {"draw_line horizontal", [=](SDL_Surface* s, int n) { Primitives::draw_line(s, c - n / 2, c, c + n / 2, c, color, false); }, nullptr},
+        {"draw_line vertical", [=](SDL_Surface* s, int n) { Primitives::draw_line(s, c, c - n / 2, c, c + n / 2, color, false); }, nullptr},
+        {"draw_line 24.8", [=](SDL_Surface* s, int n) { Primitives::draw_line(s, {(c - n / 2) * 256 + 77, (c - n / 3) * 256 + 13}, {(c + n / 2) * 256 + 200, (c + n / 3) * 256 + 150}, color); }, nullptr},
+        {"draw_curve AA", [=](SDL_Surface* s, int n) { Primitives::draw_curve(s, c - n / 2, c + n / 2, c - n / 4, c - n / 2, c + n / 4, c + n / 2, c + n / 2, c - n / 2, color, true); }, nullptr},
+        {"draw_curve", [=](SDL_Surface* s, int n) { Primitives::draw_curve(s, c - n / 2, c + n / 2, c - n / 4, c - n / 2, c + n / 4, c + n / 2, c + n / 2, c - n / 2, color, false); }, nullptr},
+        {"draw_circle AA filled", [=](SDL_Surface* s, int n) { Primitives::draw_circle(s, c, c, n / 2, color, true, true); }, nullptr},
+        {"draw_circle AA outline", [=](SDL_Surface* s, int n) { Primitives::draw_circle(s, c, c, n / 2, color, true, false); }, nullptr},
+        {"draw_circle filled", [=](SDL_Surface* s, int n) { Primitives::draw_circle(s, c, c, n / 2, color, false, true); }, nullptr},
+        {"draw_circle outline", [=](SDL_Surface* s, int n) { Primitives::draw_circle(s, c, c, n / 2, color, false, false); }, nullptr},
+        {"draw_ellipse AA filled", [=](SDL_Surface* s, int n) { Primitives::draw_ellipse(s, c, c, n / 2, n / 4, color, true, true); }, nullptr},
+        {"draw_ellipse AA outline", [=](SDL_Surface* s, int n) { Primitives::draw_ellipse(s, c, c, n / 2, n / 4, color, true, false); }, nullptr},
+        {"draw_ellipse filled", [=](SDL_Surface* s, int n) { Primitives::draw_ellipse(s, c, c, n / 2, n / 4, color, false, true); }, nullptr},
+        {"draw_ellipse outline", [=](SDL_Surface* s, int n) { Primitives::draw_ellipse(s, c, c, n / 2, n / 4, color, false, false); }, nullptr},
+        {"draw_rotated_ellipse filled", [=](SDL_Surface* s, int n) { Primitives::draw_rotated_ellipse(s, c, c, n / 2, n / 4, 0.6f, color, true); }, nullptr},
+        {"draw_rotated_ellipse outline", [=](SDL_Surface* s, int n) { Primitives::draw_rotated_ellipse(s, c, c, n / 2, n / 4, 0.6f, color, false); }, nullptr},
+        {"fill_polygon star even-odd", [=](SDL_Surface* s, int n) { Primitives::fill_polygon(s, star_points(c, c, n, 7), color, FillRule::EVEN_ODD); }, nullptr},
+        {"fill_polygon star non-zero", [=](SDL_Surface* s, int n) { Primitives::fill_polygon(s, star_points(c, c, n, 7), color, FillRule::NON_ZERO); }, nullptr},
+        {"draw_triangle", [=](SDL_Surface* s, int n) { Primitives::draw_triangle(s, c - n / 2, c + n / 2, c + n / 2, c + n / 3, c - n / 5, c - n / 2, color); }, nullptr},
+        {"draw_triangle translucent", [=](SDL_Surface* s, int n) { Primitives::draw_triangle(s, c - n / 2, c + n / 2, c + n / 2, c + n / 3, c - n / 5, c - n / 2, translucent); }, nullptr},
+        {"draw_rectangle rotated", [=](SDL_Surface* s, int n) { Primitives::draw_rectangle(s, c, c - n / 2, c + n / 2, c, c, c + n / 2, c - n / 2, c, color); }, nullptr},
+        {"draw_rounded_rect", [=](SDL_Surface* s, int n) { Primitives::draw_rounded_rect(s, {c - n / 2, c - n / 2, n, n}, n / 8, text_color); }, nullptr},
+        {"flood_fill (n x n region)", [=](SDL_Surface* s, int /*n*/) { Primitives::flood_fill(s, c, c, color); },
+            [=](SDL_Surface* s, int n) {
+                SDL_Rect region = {c - n / 2, c - n / 2, n, n};
+                SDL_FillRect(s, nullptr, color);
+                SDL_FillRect(s, &region, CanvasFormat::pack(255, 255, 255));
+            }},
+        {"blend_pixel (n x n block)", [=](SDL_Surface* s, int n) {
+            for (int y = 0; y < n; ++y) {
+                for (int x = 0; x < n; ++x) Primitives::blend_pixel(s, c - n / 2 + x, c - n / 2 + y, text_color, ((x + y) & 255) / 255.0f);
+            }
+        }, nullptr},
+    };
+
+    printf("%-30s %6s %10s %12s %12s %8s %10s %10s\n", "case", "size", "px/call", "median us", "min us", "spread", "Mpx/s", "cyc/px");
+
+    for (const KernelCase& kernel : cases) {
+        for (int size : sizes) bench_kernel(kernel, target, size, repetitions);
+    }
+
+    if (font) {
+        const std::string sample = "The quick brown fox jumps over the lazy dog. ";
+        const KernelCase text = {"draw_text (size/4 chars)", [=](SDL_Surface* s, int n) {
+            std::string line;
+            while ((int)line.size() < n / 4) line += sample;
+            line.resize(n / 4);
+            Primitives::draw_text(s, font, line, 4, c, text_color);
+        }, nullptr};
+
+        for (int size : sizes) bench_kernel(text, target, size, repetitions);
+        FontManager::close_fonts();
+    } else {
+        printf("%-30s (skipped: fonts not found, run from the project root)\n", "draw_text");
+    }
+
+    TTF_Quit();
+    SDL_FreeSurface(target);
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::string scene_path = argc > 1 ? argv[1] : "ExemploCorrigido.csv";
+    const int iterations = argc > 2 ? std::max(1, atoi(argv[2])) : 5;
+    const int repetitions = argc > 3 ? std::max(1, atoi(argv[3])) : 15;
+
+    // Scene: rendered once, then bucket-filled on the background.
+    std::vector<std::unique_ptr<Shape>> shapes;
+    int scene_w = 0, scene_h = 0, universe_w = 0, universe_h = 0;
+    Uint32 background = 0;
+
+    if (!FileManager::load_scene(scene_path, shapes, &scene_w, &scene_h, &universe_w, &universe_h, &background)) {
+        fprintf(stderr, "Could not load scene '%s'.\n", scene_path.c_str());
+        return 1;
+    }
+
+    if (universe_w > 0 && universe_h > 0) {
+        App::universe_width = universe_w;
+        App::universe_height = universe_h;
+    }
+
+    SDL_Surface* scene = create_canvas(scene_w, scene_h);
+    SDL_FillRect(scene, nullptr, background);
+    for (auto& shape : shapes) {
+        shape->draw(scene);
+    }
+
+    // Seed on the first background pixel of the top row (the sky region of the example scene).
+    int seed_x = 0;
+    while (seed_x < scene_w - 1 && Primitives::get_pixel(scene, seed_x, 0) != background) seed_x++;
+
+    SDL_Surface* blank = create_canvas(1920, 1080);
+    SDL_FillRect(blank, nullptr, CanvasFormat::pack(255, 255, 255));
+
+    const Uint32 fill_color = CanvasFormat::pack(247, 30, 113);
+
+    printf("Flood fill (%d iterations, times in ms)\n", iterations);
+    printf("%-28s %12s %12s %10s   %s\n", "case", "legacy", "span", "speedup", "same");
+    bench_flood_fill("scene background", scene, seed_x, 0, fill_color, iterations);
+    bench_flood_fill("full canvas 1920x1080", blank, 960, 540, fill_color, iterations);
+
+    printf("\nSpan fill (%d iterations, millions of spans per second, kernel: %s)\n", iterations, SpanWriter::get_kernel_name());
+    printf("%-28s %12s %12s %10s\n", "case", "scalar", "kernel", "speedup");
+    bench_span("short (8 px)", blank, 8, iterations);
+    bench_span("medium (64 px)", blank, 64, iterations);
+    bench_span("full row (1920 px)", blank, blank->w, iterations);
+
+    printf("\nCoverage blending (%d iterations, millions of pixels per second)\n", iterations);
+    printf("%-28s %12s %10s\n", "case", "Mpx/s", "speedup");
+    bench_blend(blank, iterations);
+
+    printf("\nAnti-aliased primitives (%d iterations, ms per call)\n", iterations);
+    bench_aa_primitives(blank, iterations);
+
+    printf("\nTriangles (%d iterations, times in ms)\n", iterations);
+    printf("%-28s %12s %12s %10s   %s\n", "case", "legacy", "spans", "speedup", "same");
+    SDL_Surface* spans = create_canvas(blank->w, blank->h);
+    bench_triangles(blank, spans, iterations);
+    SDL_FreeSurface(spans);
+
+    printf("\nConic fills (%d iterations, times in ms)\n", iterations);
+    printf("%-28s %12s %12s %10s %10s\n", "case", "legacy", "spans", "speedup", "diff px");
+    SDL_Surface* conics = create_canvas(blank->w, blank->h);
+    bench_conics(blank, conics, iterations);
+    SDL_FreeSurface(conics);
+
+    printf("\nPolygons (%d iterations, times in ms)\n", iterations);
+    printf("%-28s %12s %12s %10s   %s\n", "case", "legacy", "AET", "speedup", "same");
+    SDL_Surface* polygons = create_canvas(blank->w, blank->h);
+    bench_polygons(blank, polygons, iterations);
+    SDL_FreeSurface(polygons);
+
+    printf("\nFixed-point geometry (%d iterations, times in ms)\n", iterations);
+    printf("%-28s %12s %12s %10s %10s\n", "case", "snapped", "24.8", "speedup", "diff px");
+    SDL_Surface* fixed = create_canvas(blank->w, blank->h);
+    bench_fixed_point(blank, fixed, iterations);
+    SDL_FreeSurface(fixed);
+
+    printf("\nCubic curves (%d iterations)\n", iterations);
+    bench_curves(blank, iterations);
+
+    // Diferença: maior e média (entre os canais alterados) em relação ao supersampling 4x4.
+    printf("\nEllipses: 4x4 supersampling vs analytic coverage (%d iterations, times in ms)\n", iterations);
+    printf("%-28s %12s %12s %10s %9s %9s\n", "case", "legacy", "analytic", "speedup", "max diff", "mean diff");
+    SDL_Surface* analytic = create_canvas(blank->w, blank->h);
+    bench_ellipse("filled 400x250", blank, analytic, 400, 250, 0.0f, true, iterations);
+    bench_ellipse("outline 400x250", blank, analytic, 400, 250, 0.0f, false, iterations);
+    bench_ellipse("filled 60x40", blank, analytic, 60, 40, 0.0f, true, iterations);
+    bench_ellipse("filled rotated 450x200", blank, analytic, 450, 200, 0.6f, true, iterations);
+    bench_ellipse("outline rotated 450x200", blank, analytic, 450, 200, 0.6f, false, iterations);
+    bench_ellipse("filled rotated 30x12", blank, analytic, 30, 12, 1.1f, true, iterations);
+    SDL_FreeSurface(analytic);
+
+    printf("\nKernel suite (%d repetitions, median of each; cycles are TSC reference cycles)\n", repetitions);
+    bench_kernel_suite(repetitions);
+
+    SDL_FreeSurface(blank);
+    SDL_FreeSurface(scene);
+    return 0;
+}
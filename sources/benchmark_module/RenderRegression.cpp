@@ -0,0 +1,415 @@
+// INCLUDES
+#include "App.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+
+// Golden-image and performance regression run over a fixed scene corpus.
+//
+// Usage: RenderRegression [check|update|baseline] [directory] [tolerance] [threshold %] [iterations]
+// Renders every scene of the corpus offscreen: the two example scene files and synthetic
+// edge cases (shapes across the canvas edges, overlapping translucent shapes, extreme
+// shape sizes, a tiny canvas and a stretched one). Each scene is rendered serially, the
+// way App::repaint_canvas does with one thread, and through the tile renderer, which
+// must give the same pixels.
+//
+// check (default): compares each render with '<directory>/<scene>.bmp'. A pixel fails
+// when a color channel differs by more than 'tolerance'; the render and a diff image
+// (failing pixels in red over a faded golden) are then written next to the golden as
+// '<scene>.actual.bmp' and '<scene>.diff.bmp'. The best frame time is compared with
+// '<directory>/baseline.csv' and fails when it is more than 'threshold' percent slower.
+// update: writes the goldens and the baseline, creating the directory if needed.
+// baseline: writes the baseline only.
+//
+// Goldens and timings depend on the compiler and the machine, so they are generated on
+// the reference machine and checked on it. The exit code is 1 when a scene fails.
+
+
+struct Scene {
+    std::string name;
+    int width, height;                      // Canvas size.
+    int universe_width, universe_height;
+    Uint32 background;
+    std::vector<std::unique_ptr<Shape>> shapes;
+};
+
+
+// Frames rendered before timing, and the smallest slowdown reported whatever the threshold:
+// the time of scenes that render in microseconds moves by more than 20% between runs.
+static const int warmup_frames = 3;
+static const double min_regression_ms = 0.05;
+
+
+struct Palette {
+    Uint32 trunk, leaves, apple, walls, door, roof, plank, plank_top, sun, rays;
+};
+
+
+static double elapsed_ms(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+
+static Palette make_palette(Uint8 alpha) {
+    return {
+        CanvasFormat::pack(110, 70, 30, alpha), CanvasFormat::pack(40, 150, 60, alpha), CanvasFormat::pack(220, 30, 30, alpha),
+        CanvasFormat::pack(230, 200, 150, alpha), CanvasFormat::pack(120, 60, 20, alpha), CanvasFormat::pack(180, 40, 40, alpha),
+        CanvasFormat::pack(150, 110, 70, alpha), CanvasFormat::pack(90, 60, 40, alpha),
+        CanvasFormat::pack(250, 210, 40, alpha), CanvasFormat::pack(250, 160, 30, alpha)
+    };
+}
+
+
+// Shape number 'kind' (0 to 3) of the four types, with its top-left corner at (x, y) in meters.
+static void add_shape(Scene& scene, int kind, int width, int height, int x, int y, const Palette& p) {
+    switch (kind % 4) {
+        case 0: scene.shapes.emplace_back(std::make_unique<Tree>(width, height, x, y, p.trunk, p.leaves, p.apple)); break;
+        case 1: scene.shapes.emplace_back(std::make_unique<House>(width, height, x, y, p.walls, p.door, p.roof)); break;
+        case 2: scene.shapes.emplace_back(std::make_unique<Fence>(width, height, x, y, p.plank, p.plank_top)); break;
+        default: scene.shapes.emplace_back(std::make_unique<Sun>(width, height, x, y, p.sun, p.rays)); break;
+    }
+}
+
+
+static Scene& add_scene(std::vector<Scene>& corpus, const std::string& name, int width, int height) {
+    corpus.emplace_back();
+    Scene& scene = corpus.back();
+    scene.name = name;
+    scene.width = width;
+    scene.height = height;
+    scene.universe_width = 40;
+    scene.universe_height = 30;
+    scene.background = CanvasFormat::pack(135, 206, 235);
+    return scene;
+}
+
+
+static bool load_file_scene(std::vector<Scene>& corpus, const std::string& name, const std::string& file) {
+    Scene& scene = add_scene(corpus, name, 0, 0);
+
+    int universe_w = 0, universe_h = 0;
+    if (!FileManager::load_scene(file, scene.shapes, &scene.width, &scene.height, &universe_w, &universe_h, &scene.background)) {
+        fprintf(stderr, "Could not load scene '%s'.\n", file.c_str());
+        corpus.pop_back();
+        return false;
+    }
+
+    if (universe_w > 0 && universe_h > 0) {
+        scene.universe_width = universe_w;
+        scene.universe_height = universe_h;
+    }
+
+    if (scene.width <= 0) scene.width = 1920;
+    if (scene.height <= 0) scene.height = 1080;
+    return true;
+}
+
+
+// The synthetic part of the corpus. Positions come from a fixed seed, so every run draws
+// the same scenes; changing them invalidates the goldens.
+static void build_synthetic_scenes(std::vector<Scene>& corpus) {
+    const Palette opaque = make_palette(SDL_ALPHA_OPAQUE);
+    const Palette translucent = make_palette(128);
+    Uint32 seed = 12345;
+
+    auto next = [&seed](int range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (int)((seed >> 8) % (Uint32)range);
+    };
+
+    // Every type across each edge and corner, and entirely outside the universe.
+    Scene& edges = add_scene(corpus, "edges", 640, 480);
+    const int edge_positions[][2] = {{-4, 10}, {37, 12}, {15, -5}, {18, 26}, {-3, -4}, {36, -3}, {-2, 27}, {38, 28}, {-30, 5}, {45, 40}};
+    for (int i = 0; i < (int)(sizeof(edge_positions) / sizeof(edge_positions[0])); ++i) {
+        add_shape(edges, i, 8, 8, edge_positions[i][0], edge_positions[i][1], opaque);
+    }
+
+    // Dense translucent shapes over opaque ones: blending order and tile boundaries.
+    Scene& overlap = add_scene(corpus, "overlap", 800, 600);
+    for (int i = 0; i < 80; ++i) {
+        const int width = 3 + next(10);
+        const int height = 4 + next(10);
+        add_shape(overlap, next(4), width, height, next(40 - width), next(30 - height), i % 3 == 0 ? translucent : opaque);
+    }
+
+    // One-meter shapes, one covering the universe and one larger than it.
+    Scene& extremes = add_scene(corpus, "extremes", 512, 384);
+    add_shape(extremes, 1, 40, 30, 0, 0, opaque);
+    add_shape(extremes, 0, 70, 50, -15, -10, translucent);
+    for (int i = 0; i < 16; ++i) {
+        add_shape(extremes, i, 1, 1, 2 + 2 * i, 2 + i, opaque);
+    }
+
+    // Canvases smaller than a shape detail, and not a multiple of the tile size.
+    Scene& tiny = add_scene(corpus, "tiny_canvas", 9, 7);
+    for (int i = 0; i < 4; ++i) {
+        add_shape(tiny, i, 10, 12, 10 * i, 9, opaque);
+    }
+
+    Scene& stretched = add_scene(corpus, "stretched", 1000, 123);
+    for (int i = 0; i < 12; ++i) {
+        add_shape(stretched, i, 5, 8, 3 * i + next(3), next(20), i % 2 ? translucent : opaque);
+    }
+}
+
+
+// One frame: background and the whole list, serially or through the tile renderer.
+static void render_frame(SDL_Surface* canvas, const DisplayList& list, Uint32 background, TileRenderer* renderer) {
+    const SDL_Rect full = {0, 0, canvas->w, canvas->h};
+
+    if (renderer) {
+        std::vector<SDL_Rect> bounds;
+        for (size_t i = 0; i < list.size(); ++i) bounds.push_back(list.get_bounds(i));
+
+        renderer->render(canvas, full, background, bounds, [&list](SDL_Surface* target, size_t index) {
+            list.execute(target, index);
+        });
+    } else {
+        SpanWriter::fill_rect(canvas, full, background);
+        list.execute(canvas);
+    }
+}
+
+
+// Best milliseconds per serial frame, after untimed warm-up frames. The best frame is the
+// least disturbed by the rest of the system, so it moves the least between runs.
+static double time_frames(SDL_Surface* canvas, const DisplayList& list, Uint32 background, int iterations) {
+    for (int i = 0; i < warmup_frames; ++i) render_frame(canvas, list, background, nullptr);
+
+    double best_ms = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        render_frame(canvas, list, background, nullptr);
+        const double ms = elapsed_ms(start);
+        if (i == 0 || ms < best_ms) best_ms = ms;
+    }
+
+    return best_ms;
+}
+
+
+static bool same_pixels(const SDL_Surface* a, const SDL_Surface* b) {
+    for (int y = 0; y < a->h; ++y) {
+        if (memcmp((const Uint8*)a->pixels + y * a->pitch, (const Uint8*)b->pixels + y * b->pitch, a->w * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Writes the canvas as a 24-bit BMP, the format of the application's exported images.
+static bool save_canvas(SDL_Surface* canvas, const std::string& path) {
+    SDL_Surface* image = CanvasFormat::convert(canvas, SDL_PIXELFORMAT_RGB24);
+    if (!image) return false;
+
+    const bool saved = SDL_SaveBMP(image, path.c_str()) == 0;
+    SDL_FreeSurface(image);
+    return saved;
+}
+
+
+// Compares the canvas with a golden image. Returns the number of pixels with a channel off by
+// more than 'tolerance', -1 when the golden cannot be read or -2 when it has another size.
+// When some pixels fail, writes the diff image to 'diff_path'.
+static long compare_golden(SDL_Surface* canvas, const std::string& golden_path, int tolerance, const std::string& diff_path, int* max_difference) {
+    *max_difference = 0;
+
+    SDL_Surface* loaded = SDL_LoadBMP(golden_path.c_str());
+    if (!loaded) return -1;
+
+    SDL_Surface* golden = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(loaded);
+    if (!golden) return -1;
+
+    if (golden->w != canvas->w || golden->h != canvas->h) {
+        SDL_FreeSurface(golden);
+        return -2;
+    }
+
+    SDL_Surface* diff = CanvasFormat::create_surface(canvas->w, canvas->h);
+    long failing = 0;
+
+    for (int y = 0; y < canvas->h; ++y) {
+        const Uint32* actual_row = (const Uint32*)((const Uint8*)canvas->pixels + y * canvas->pitch);
+        const Uint32* golden_row = (const Uint32*)((const Uint8*)golden->pixels + y * golden->pitch);
+        Uint32* diff_row = diff ? (Uint32*)((Uint8*)diff->pixels + y * diff->pitch) : nullptr;
+
+        for (int x = 0; x < canvas->w; ++x) {
+            const SDL_Color actual = CanvasFormat::unpack(actual_row[x]);
+            const Uint32 expected = golden_row[x];
+            const int r = (expected >> 16) & 0xFF, g = (expected >> 8) & 0xFF, b = expected & 0xFF;
+
+            const int difference = std::max(std::abs(actual.r - r), std::max(std::abs(actual.g - g), std::abs(actual.b - b)));
+            *max_difference = std::max(*max_difference, difference);
+
+            if (difference > tolerance) {
+                failing++;
+                if (diff_row) diff_row[x] = CanvasFormat::pack(255, 0, 0);
+            } else if (diff_row) {
+                const Uint8 faded = (Uint8)(192 + (r * 77 + g * 150 + b * 29) / 1024);
+                diff_row[x] = CanvasFormat::pack(faded, faded, faded);
+            }
+        }
+    }
+
+    if (failing > 0 && diff) save_canvas(diff, diff_path);
+
+    SDL_FreeSurface(diff);
+    SDL_FreeSurface(golden);
+    return failing;
+}
+
+
+// Reads 'scene,ms' lines; the header and malformed lines are skipped.
+static std::map<std::string, double> load_baseline(const std::string& path) {
+    std::map<std::string, double> baseline;
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line)) {
+        const size_t comma = line.find(',');
+        if (comma == std::string::npos) continue;
+
+        const double ms = atof(line.c_str() + comma + 1);
+        if (ms > 0.0) baseline[line.substr(0, comma)] = ms;
+    }
+
+    return baseline;
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::string mode = argc > 1 ? argv[1] : "check";
+    const std::string directory = argc > 2 ? argv[2] : "regression";
+    const int tolerance = argc > 3 ? std::max(0, atoi(argv[3])) : 2;
+    const double threshold = argc > 4 ? std::max(0.0, atof(argv[4])) : 20.0;
+    const int iterations = argc > 5 ? std::max(1, atoi(argv[5])) : 15;
+
+    const bool update_goldens = mode == "update";
+    const bool update_baseline = update_goldens || mode == "baseline";
+
+    if (!update_baseline && mode != "check") {
+        fprintf(stderr, "Unknown mode '%s' (check, update or baseline).\n", mode.c_str());
+        return 1;
+    }
+
+    std::error_code error;
+    if (update_baseline) {
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            fprintf(stderr, "Could not create '%s': %s.\n", directory.c_str(), error.message().c_str());
+            return 1;
+        }
+    } else if (!std::filesystem::is_directory(directory, error)) {
+        fprintf(stderr, "No goldens in '%s': run 'RenderRegression update' first.\n", directory.c_str());
+        return 1;
+    }
+
+    std::vector<Scene> corpus;
+    bool passed = load_file_scene(corpus, "ExemploCorrigido", "ExemploCorrigido.csv");
+    passed = load_file_scene(corpus, "ExemploCorrigido-old", "ExemploCorrigido-old.csv") && passed;
+    build_synthetic_scenes(corpus);
+
+    const std::string baseline_path = directory + "/baseline.csv";
+    const std::map<std::string, double> baseline = load_baseline(baseline_path);
+    std::vector<std::pair<std::string, double>> timings;
+
+    TileRenderer renderer(4);
+    int failed_scenes = 0;
+
+    printf("%-22s %11s %9s %10s %10s %8s  %s\n", "scene", "size", "max diff", "ms", "baseline", "change", "result");
+
+    for (Scene& scene : corpus) {
+        App::universe_width = scene.universe_width;
+        App::universe_height = scene.universe_height;
+
+        SDL_Surface* canvas = CanvasFormat::create_surface(scene.width, scene.height);
+        SDL_Surface* tiled = CanvasFormat::create_surface(scene.width, scene.height);
+        if (!canvas || !tiled) {
+            fprintf(stderr, "Could not create a %dx%d canvas.\n", scene.width, scene.height);
+            return 1;
+        }
+
+        DisplayList list;
+        for (auto& shape : scene.shapes) {
+            shape->compile(list, scene.width, scene.height);
+            list.end_shape();
+        }
+
+        render_frame(canvas, list, scene.background, nullptr);
+        render_frame(tiled, list, scene.background, &renderer);
+
+        std::string result;
+        if (!same_pixels(canvas, tiled)) result += "tiles differ; ";
+
+        // Timing (the canvas ends up with the same pixels as the first serial frame).
+        const double ms = time_frames(canvas, list, scene.background, iterations);
+        timings.push_back({scene.name, ms});
+
+        const std::string golden_path = directory + "/" + scene.name + ".bmp";
+        int max_difference = 0;
+
+        if (update_goldens) {
+            if (!save_canvas(canvas, golden_path)) result += "cannot write " + golden_path + "; ";
+        } else if (!update_baseline) {
+            const long failing = compare_golden(canvas, golden_path, tolerance, directory + "/" + scene.name + ".diff.bmp", &max_difference);
+
+            if (failing == -1) {
+                result += "no golden; ";
+            } else if (failing == -2) {
+                result += "golden has another size; ";
+            } else if (failing > 0) {
+                result += std::to_string(failing) + " pixels differ; ";
+                save_canvas(canvas, directory + "/" + scene.name + ".actual.bmp");
+            }
+        }
+
+        auto reference = baseline.find(scene.name);
+        const bool has_baseline = !update_baseline && reference != baseline.end();
+        const double change = has_baseline ? (ms / reference->second - 1.0) * 100.0 : 0.0;
+
+        if (has_baseline && change > threshold && ms - reference->second > min_regression_ms) {
+            char message[64];
+            snprintf(message, sizeof(message), "%.1f%% slower; ", change);
+            result += message;
+        }
+
+        if (result.empty()) {
+            result = update_baseline ? "updated" : "ok";
+        } else {
+            result.resize(result.size() - 2);
+            failed_scenes++;
+        }
+
+        char size[24], reference_ms[16] = "-", change_text[16] = "-";
+        snprintf(size, sizeof(size), "%dx%d", scene.width, scene.height);
+        if (has_baseline) {
+            snprintf(reference_ms, sizeof(reference_ms), "%.3f", reference->second);
+            snprintf(change_text, sizeof(change_text), "%+.1f%%", change);
+        }
+
+        printf("%-22s %11s %9d %10.3f %10s %8s  %s\n", scene.name.c_str(), size, max_difference, ms, reference_ms, change_text, result.c_str());
+
+        SDL_FreeSurface(tiled);
+        SDL_FreeSurface(canvas);
+    }
+
+    if (update_baseline) {
+        FILE* file = fopen(baseline_path.c_str(), "w");
+        if (file) {
+            fprintf(file, "scene,ms\n");
+            for (const auto& timing : timings) fprintf(file, "%s,%.4f\n", timing.first.c_str(), timing.second);
+            fclose(file);
+        } else {
+            fprintf(stderr, "Could not write '%s'.\n", baseline_path.c_str());
+            passed = false;
+        }
+    }
+
+    if (failed_scenes > 0) passed = false;
+    printf("\n%d of %zu scenes failed (tolerance %d, threshold %.1f%%).\n", failed_scenes, corpus.size(), tolerance, threshold);
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,200 @@
+// INCLUDES
+#include "App.h"
+
+
+// Headless scene rendering throughput.
+//
+// Usage: SceneBenchmark [scene file] [iterations] [width] [height] [json|csv] [threads]
+// Loads a scene through FileManager::load_scene and renders it 'iterations' times into
+// an offscreen canvas, the way App::repaint_canvas does: background fill and display
+// list replay (tiled over 'threads' threads when more than 1). A width or height of 0
+// keeps the size stored in the scene. Every shape type is then replayed on its own to
+// split the cost. No window is opened, so it runs with SDL_VIDEODRIVER=dummy.
+//
+// The report goes to stdout as JSON (default) or CSV, for tracking across versions.
+
+
+struct TypeCost {
+    std::string type;
+    int shapes;
+    size_t commands;
+    double ms_per_frame;
+};
+
+
+static double elapsed_ms(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+
+// Scene paths may contain backslashes (Windows) or quotes.
+static std::string json_escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+
+static const char* shape_type_name(Shape* shape) {
+    if (dynamic_cast<House*>(shape)) return "House";
+    if (dynamic_cast<Tree*>(shape)) return "Tree";
+    if (dynamic_cast<Fence*>(shape)) return "Fence";
+    if (dynamic_cast<Sun*>(shape)) return "Sun";
+    return "Other";
+}
+
+
+// One frame: background and the whole list, serially or through the tile renderer.
+static void render_frame(SDL_Surface* canvas, const DisplayList& list, Uint32 background, TileRenderer* renderer) {
+    const SDL_Rect full = {0, 0, canvas->w, canvas->h};
+
+    if (renderer) {
+        std::vector<SDL_Rect> bounds;
+        for (size_t i = 0; i < list.size(); ++i) bounds.push_back(list.get_bounds(i));
+
+        renderer->render(canvas, full, background, bounds, [&list](SDL_Surface* target, size_t index) {
+            list.execute(target, index);
+        });
+    } else {
+        SpanWriter::fill_rect(canvas, full, background);
+        list.execute(canvas);
+    }
+}
+
+
+// Average milliseconds per frame over 'iterations' frames, after one untimed warm-up frame.
+static double time_frames(SDL_Surface* canvas, const DisplayList& list, Uint32 background, TileRenderer* renderer, int iterations, double* best_ms) {
+    render_frame(canvas, list, background, renderer);
+
+    double total_ms = 0.0;
+    *best_ms = 0.0;
+
+    for (int i = 0; i < iterations; ++i) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        render_frame(canvas, list, background, renderer);
+        const double ms = elapsed_ms(start);
+
+        total_ms += ms;
+        if (i == 0 || ms < *best_ms) *best_ms = ms;
+    }
+
+    return total_ms / iterations;
+}
+
+
+int main(int argc, char* argv[]) {
+    const std::string scene_path = argc > 1 ? argv[1] : "ExemploCorrigido.csv";
+    const int iterations = argc > 2 ? std::max(1, atoi(argv[2])) : 20;
+    int width = argc > 3 ? atoi(argv[3]) : 0;
+    int height = argc > 4 ? atoi(argv[4]) : 0;
+    const bool csv = argc > 5 && strcasecmp(argv[5], "csv") == 0;
+    const int threads = argc > 6 ? std::max(1, atoi(argv[6])) : 1;
+
+    std::vector<std::unique_ptr<Shape>> shapes;
+    int scene_w = 0, scene_h = 0, universe_w = 0, universe_h = 0;
+    Uint32 background = CanvasFormat::pack(255, 255, 255);
+
+    if (!FileManager::load_scene(scene_path, shapes, &scene_w, &scene_h, &universe_w, &universe_h, &background)) {
+        fprintf(stderr, "Could not load scene '%s'.\n", scene_path.c_str());
+        return 1;
+    }
+
+    if (universe_w > 0 && universe_h > 0) {
+        App::universe_width = universe_w;
+        App::universe_height = universe_h;
+    }
+
+    if (width <= 0) width = scene_w > 0 ? scene_w : 1920;
+    if (height <= 0) height = scene_h > 0 ? scene_h : 1080;
+
+    SDL_Surface* canvas = CanvasFormat::create_surface(width, height);
+    if (!canvas) {
+        fprintf(stderr, "Could not create a %dx%d canvas.\n", width, height);
+        return 1;
+    }
+
+    TileRenderer* renderer = threads > 1 ? new TileRenderer(threads) : nullptr;
+
+    // Compilation, as App::update_display_list does once per scene and canvas size.
+    DisplayList list;
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (auto& shape : shapes) {
+        shape->compile(list, width, height);
+        list.end_shape();
+    }
+    const double compile_ms = elapsed_ms(start);
+
+    double best_ms = 0.0;
+    const double frame_ms = time_frames(canvas, list, background, renderer, iterations, &best_ms);
+    const double pixels = (double)width * height;
+
+    // Cost per shape type: each type compiled and replayed alone, minus the frame of an
+    // empty list (background fill and, when tiled, the thread hand-off).
+    DisplayList empty_list;
+    double background_best_ms = 0.0;
+    const double background_ms = time_frames(canvas, empty_list, background, renderer, iterations, &background_best_ms);
+
+    std::vector<TypeCost> types;
+    for (auto& shape : shapes) {
+        const char* type = shape_type_name(shape.get());
+        auto found = std::find_if(types.begin(), types.end(), [type](const TypeCost& cost) { return cost.type == type; });
+        if (found == types.end()) types.push_back({type, 0, 0, 0.0});
+    }
+
+    for (TypeCost& cost : types) {
+        DisplayList type_list;
+        for (auto& shape : shapes) {
+            if (cost.type != shape_type_name(shape.get())) continue;
+            shape->compile(type_list, width, height);
+            type_list.end_shape();
+            cost.shapes++;
+        }
+
+        double type_best_ms = 0.0;
+        cost.commands = type_list.size();
+        cost.ms_per_frame = std::max(0.0, time_frames(canvas, type_list, background, renderer, iterations, &type_best_ms) - background_ms);
+    }
+
+    if (csv) {
+        printf("scene,width,height,threads,iterations,type,shapes,commands,ms_per_frame,best_ms,fps,ns_per_pixel,us_per_shape,compile_ms\n");
+        printf("%s,%d,%d,%d,%d,all,%zu,%zu,%.4f,%.4f,%.2f,%.4f,%.4f,%.4f\n",
+               scene_path.c_str(), width, height, threads, iterations, shapes.size(), list.size(), frame_ms, best_ms,
+               frame_ms > 0.0 ? 1000.0 / frame_ms : 0.0, frame_ms * 1e6 / pixels,
+               shapes.empty() ? 0.0 : frame_ms * 1000.0 / shapes.size(), compile_ms);
+        printf("%s,%d,%d,%d,%d,background,0,0,%.4f,%.4f,,%.4f,,\n",
+               scene_path.c_str(), width, height, threads, iterations, background_ms, background_best_ms, background_ms * 1e6 / pixels);
+
+        for (const TypeCost& cost : types) {
+            printf("%s,%d,%d,%d,%d,%s,%d,%zu,%.4f,,,%.4f,%.4f,\n",
+                   scene_path.c_str(), width, height, threads, iterations, cost.type.c_str(), cost.shapes, cost.commands,
+                   cost.ms_per_frame, cost.ms_per_frame * 1e6 / pixels, cost.ms_per_frame * 1000.0 / cost.shapes);
+        }
+    } else {
+        printf("{\n");
+        printf("  \"scene\": \"%s\",\n", json_escape(scene_path).c_str());
+        printf("  \"width\": %d,\n  \"height\": %d,\n  \"threads\": %d,\n  \"iterations\": %d,\n", width, height, threads, iterations);
+        printf("  \"shapes\": %zu,\n  \"commands\": %zu,\n", shapes.size(), list.size());
+        printf("  \"compile_ms\": %.4f,\n", compile_ms);
+        printf("  \"frame_ms\": %.4f,\n  \"best_frame_ms\": %.4f,\n", frame_ms, best_ms);
+        printf("  \"fps\": %.2f,\n", frame_ms > 0.0 ? 1000.0 / frame_ms : 0.0);
+        printf("  \"ns_per_pixel\": %.4f,\n", frame_ms * 1e6 / pixels);
+        printf("  \"background_ms\": %.4f,\n", background_ms);
+        printf("  \"types\": [");
+
+        for (size_t i = 0; i < types.size(); ++i) {
+            const TypeCost& cost = types[i];
+            printf("%s\n    {\"type\": \"%s\", \"shapes\": %d, \"commands\": %zu, \"ms_per_frame\": %.4f, \"us_per_shape\": %.4f}",
+                   i ? "," : "", cost.type.c_str(), cost.shapes, cost.commands, cost.ms_per_frame,
+                   cost.ms_per_frame * 1000.0 / cost.shapes);
+        }
+
+        printf("\n  ]\n}\n");
+    }
+
+    delete renderer;
+    SDL_FreeSurface(canvas);
+    return 0;
+}
@@ -0,0 +1,133 @@
+// INCLUDES
+#include <cstring>
+#include "App.h"
+
+
+// Thread scaling of the tile-binned canvas rasterizer.
+//
+// Usage: TileRendererBenchmark [shapes] [iterations] [width] [height] [tile size] [max threads]
+// Builds a synthetic scene with 'shapes' trees and houses (half of each), renders it
+// once serially as the reference and then with the TileRenderer from 1 thread up to
+// 'max threads' (default: twice the number of logical CPUs), checking that every frame
+// is bit-identical. A tile size of 0 (default) uses the automatic size. With more
+// threads than CPUs, the time measures the extra work of the smaller tiles.
+
+
+static SDL_Surface* create_canvas(int width, int height) {
+    return CanvasFormat::create_surface(width, height);
+}
+
+
+static bool same_pixels(const SDL_Surface* a, const SDL_Surface* b) {
+    for (int y = 0; y < a->h; ++y) {
+        if (memcmp((const Uint8*)a->pixels + y * a->pitch, (const Uint8*)b->pixels + y * b->pitch, a->w * 4) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+static double elapsed_ms(Uint64 start) {
+    return (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+
+// Trees and houses at pseudo-random positions (fixed seed, so every run draws the same scene).
+static void build_scene(int count, std::vector<std::unique_ptr<Shape>>& shapes) {
+    const Uint32 trunk = CanvasFormat::pack(110, 70, 30);
+    const Uint32 leaves = CanvasFormat::pack(40, 150, 60);
+    const Uint32 apple = CanvasFormat::pack(220, 30, 30);
+    const Uint32 walls = CanvasFormat::pack(230, 200, 150);
+    const Uint32 door = CanvasFormat::pack(120, 60, 20);
+    const Uint32 roof = CanvasFormat::pack(180, 40, 40);
+    Uint32 seed = 12345;
+
+    auto next = [&seed](int range) {
+        seed = seed * 1664525u + 1013904223u;
+        return (int)((seed >> 8) % (Uint32)range);
+    };
+
+    for (int i = 0; i < count; ++i) {
+        const int width = 3 + next(6);
+        const int height = 4 + next(7);
+        const int x = next(App::universe_width - width);
+        const int y = next(App::universe_height - height);
+
+        if (i % 2 == 0) {
+            shapes.emplace_back(std::make_unique<Tree>(width, height, x, y, trunk, leaves, apple));
+        } else {
+            shapes.emplace_back(std::make_unique<House>(width, height, x, y, walls, door, roof));
+        }
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    const int shape_count = argc > 1 ? std::max(1, atoi(argv[1])) : 4000;
+    const int iterations = argc > 2 ? std::max(1, atoi(argv[2])) : 5;
+    const int width = argc > 3 ? std::max(16, atoi(argv[3])) : 1920;
+    const int height = argc > 4 ? std::max(16, atoi(argv[4])) : 1080;
+    const int tile_size = argc > 5 ? atoi(argv[5]) : 0;
+    const int cpus = SDL_GetCPUCount();
+    const int max_threads = argc > 6 ? std::max(1, atoi(argv[6])) : cpus * 2;
+
+    App::universe_width = 200;
+    App::universe_height = 150;
+
+    SDL_Surface* reference = create_canvas(width, height);
+    SDL_Surface* canvas = create_canvas(width, height);
+    const Uint32 background = CanvasFormat::pack(255, 255, 255);
+    const SDL_Rect full = {0, 0, width, height};
+
+    std::vector<std::unique_ptr<Shape>> shapes;
+    build_scene(shape_count, shapes);
+
+    std::vector<SDL_Rect> bounds;
+    for (auto& shape : shapes) {
+        bounds.push_back(shape->get_canvas_bounds(width, height));
+    }
+
+    // Serial reference: the path App::repaint_canvas takes with one thread.
+    double serial_ms = 0.0;
+    for (int i = 0; i < iterations; ++i) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        SpanWriter::fill_rect(reference, full, background);
+        for (auto& shape : shapes) {
+            shape->draw(reference);
+        }
+        serial_ms += elapsed_ms(start);
+    }
+    serial_ms /= iterations;
+
+    TileRenderer renderer(1);
+    renderer.set_tile_size(tile_size);
+    printf("Tile renderer: %d trees and houses, %dx%d, %d iterations, %d logical CPUs\n",
+           shape_count, width, height, iterations, cpus);
+    printf("%-10s %8s %12s %10s %12s   %s\n", "threads", "tile", "ms/frame", "speedup", "draws/frame", "same");
+    printf("%-10s %8s %12.3f %9.2fx %12d   %s\n", "serial", "-", serial_ms, 1.0, shape_count, "-");
+
+    const TileRenderer::DrawItem draw_item = [&shapes](SDL_Surface* target, size_t index) {
+        shapes[index]->draw(target);
+    };
+
+    for (int threads = 1; threads <= max_threads; threads = threads < cpus ? threads + 1 : threads * 2) {
+        renderer.set_thread_count(threads);
+
+        double tiled_ms = 0.0;
+        int draws = 0;
+        for (int i = 0; i < iterations; ++i) {
+            Uint64 start = SDL_GetPerformanceCounter();
+            draws = renderer.render(canvas, full, background, bounds, draw_item);
+            tiled_ms += elapsed_ms(start);
+        }
+        tiled_ms /= iterations;
+
+        printf("%-10d %8d %12.3f %9.2fx %12d   %s\n", threads, renderer.get_tile_size_for(full), tiled_ms,
+               tiled_ms > 0.0 ? serial_ms / tiled_ms : 0.0, draws, same_pixels(reference, canvas) ? "yes" : "NO");
+    }
+
+    SDL_FreeSurface(reference);
+    SDL_FreeSurface(canvas);
+    return 0;
+}
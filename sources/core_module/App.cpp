@@ -11,6 +11,7 @@ int App::app_bar_height = 50;
 int App::default_margin = 30;
 int App::main_image_size = 256;
 int App::bottom_image_margin = 15;
+int App::paint_stroke_width = 3;
 int App::universe_width = 40;
 int App::universe_height = 30;
 
@@ -20,6 +21,7 @@ App::App(const std::string& title, float width_percent, float height_percent) {
     this->window = nullptr;
     this->window_surface = nullptr;
     this->drawing_surface = nullptr;
+    this->paint_surface = nullptr;
     this->running = false;
     this->window_width = 0;
     this->window_height = 0;
@@ -70,12 +72,34 @@ App::App(const std::string& title, float width_percent, float height_percent) {
     }
 
     this->window_surface = SDL_GetWindowSurface(window);
-    this->drawing_surface = SDL_CreateRGBSurface(0, window_width, window_height, 32, 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00000000);
+    this->recreate_drawing_surface(window_width, window_height);
 
     // Initializing notification manager.
     this->notification_manager = new NotificationManager(this->window_width, this->window_height);
     this->notification_manager->set_fonts(FontManager::default_notification_title_font, FontManager::default_notification_message_font);
 
+    // Initializing the damage tracker of the rendering screen.
+    this->compositor = new Compositor();
+
+    // Initializing the trace recorder (BRUSHY_TRACE=<file>). It must run before the
+    // rasterizer worker threads start, so that they are traced too.
+    const char* trace_path = SDL_getenv("BRUSHY_TRACE");
+    if (trace_path && *trace_path) {
+        TraceRecorder::start(trace_path);
+        TraceRecorder::set_thread_name("main");
+    }
+
+    // Initializing the parallel canvas rasterizer. BRUSHY_RENDER_THREADS sets the number of
+    // threads (1 keeps the serial path); by default there is one per logical CPU.
+    const char* render_threads = SDL_getenv("BRUSHY_RENDER_THREADS");
+    this->tile_renderer = new TileRenderer(render_threads ? atoi(render_threads) : 0);
+
+    // Frame cap. BRUSHY_MAX_FPS sets it (0 removes it); by default frames are paced to
+    // the refresh rate of the monitor, as vsync would.
+    const char* max_fps = SDL_getenv("BRUSHY_MAX_FPS");
+    int fps = max_fps ? atoi(max_fps) : (display_mode.refresh_rate > 0 ? display_mode.refresh_rate : 60);
+    this->frame_interval = fps > 0 ? 1000 / static_cast<Uint32>(fps) : 0;
+
     // Initializing app icon.
     SDL_Surface* icon = SDL_LoadBMP("assets/Icon_64.bmp");
 
@@ -86,10 +110,10 @@ App::App(const std::string& title, float width_percent, float height_percent) {
         SDL_FreeSurface(icon);
     }
 
-    this->background_drawing_color = Colors::rgb_to_uint32(this->drawing_surface, 255, 255, 255);
-    this->primary_color = Colors::rgb_to_uint32(this->drawing_surface, 247, 30, 113);
-    this->second_color = Colors::rgb_to_uint32(this->drawing_surface, 30, 113, 247);
-    this->tertiary_color = Colors::rgb_to_uint32(this->drawing_surface, 113, 247, 30);
+    this->background_drawing_color = CanvasFormat::pack(255, 255, 255);
+    this->primary_color = CanvasFormat::pack(247, 30, 113);
+    this->second_color = CanvasFormat::pack(30, 113, 247);
+    this->tertiary_color = CanvasFormat::pack(113, 247, 30);
 }
 
 
@@ -103,22 +127,51 @@ void App::run() {
     text_enter_height_surface = TTF_RenderText_Blended(FontManager::roboto_semibold_20, "Enter height:", textColor);
     text_enter_width_surface = TTF_RenderText_Blended(FontManager::roboto_semibold_20, "Enter width:", textColor);
 
-    // Execution loop.
+    // Execution loop. Sleeps until an event arrives, then renders a frame only if the
+    // screen was invalidated or a notification is animating, and not before the next
+    // frame slot.
     while (running) {
-        if (this->app_state == AppState::MENU_SCREEN) {
-            this->render_menu_screen();
+        this->wait_for_events();
 
-        } else if (this->app_state == AppState::NEW_PROJECT_SCREEN) {
-            this->render_new_project_screen();
+        {
+            PROFILE_SCOPE(EVENTS);
+            this->handle_events();
+        }
+
+        if (!running || this->get_frame_wait() != 0) continue;
+
+        this->redraw_requested = false;
+        this->last_frame_time = SDL_GetTicks();
 
-        } else if (this->app_state == AppState::RENDERING_SCREEN) {
-            this->render_rendering_screen();
+        {
+            PROFILE_SCOPE(FRAME);
+
+            {
+                PROFILE_SCOPE(NOTIFICATIONS);
+                this->notification_manager->update();
+            }
+
+            if (this->app_state == AppState::MENU_SCREEN) {
+                this->render_menu_screen();
+
+            } else if (this->app_state == AppState::NEW_PROJECT_SCREEN) {
+                this->render_new_project_screen();
+
+            } else if (this->app_state == AppState::RENDERING_SCREEN) {
+                this->render_rendering_screen();
+            }
+
+#ifdef BRUSHY_PROFILER
+            if (FrameProfiler::get_hud_visible()) {
+                SDL_Point hud = this->get_profiler_hud_position();
+                FrameProfiler::draw_hud(this->window_surface, hud.x, hud.y);
+            }
+#endif
+
+            this->update_screen();
         }
 
-        this->notification_manager->update();
-        this->notification_manager->draw(this->window_surface);
-        this->handle_events();
-        this->update_screen();
+        PROFILE_END_FRAME();
     }
 
     this->close();
@@ -129,6 +182,12 @@ void App::run() {
 void App::close(int exit_code) {
     if (text_title_surface) SDL_FreeSurface(text_title_surface);
 
+    TraceRecorder::flush();
+
+    // Joins the rasterizer threads before SDL shuts down.
+    delete this->tile_renderer;
+    this->tile_renderer = nullptr;
+
     SDL_DestroyWindow(this->window);
 
     if (ErrorHandler::get_loaded_fonts() == true) {
@@ -147,21 +206,69 @@ bool inside_rect(int mx, int my, SDL_Rect dst_rect){
 }
 
 
+// Canvas area touched by a line segment (Xiaolin Wu blends one extra pixel around it).
+SDL_Rect line_bounds(const Point& p0, const Point& p1) {
+    int min_x = (int)std::min(p0.get_x(), p1.get_x());
+    int min_y = (int)std::min(p0.get_y(), p1.get_y());
+    int max_x = (int)std::max(p0.get_x(), p1.get_x());
+    int max_y = (int)std::max(p0.get_y(), p1.get_y());
+    return { min_x - 1, min_y - 1, max_x - min_x + 3, max_y - min_y + 3 };
+}
+
+
 // METHOD IMPLEMENTATION
 void App::handle_events() {
+    TRACE_SCOPE("handle_events");
     SDL_Event event;
 
     while (SDL_PollEvent(&event)) {
+        // Any event may change what is on screen.
+        this->invalidate();
+
         // Processes the program exit event.
         if (event.type == SDL_QUIT) {
             running = false;
         }
 
+        // Processes window exposure (the window contents must be presented again).
+        if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_EXPOSED) {
+            this->compositor->damage_all();
+        }
+
+        // Toggles the compositor damage statistics in the window title.
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F2 && event.key.repeat == 0) {
+            this->show_damage_stats = !this->show_damage_stats;
+            this->last_stats_update = 0;
+
+            if (!this->show_damage_stats) {
+                SDL_SetWindowTitle(this->window, this->window_title.c_str());
+            }
+        }
+
+        // Writes the most recent events of the trace (BRUSHY_TRACE).
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F4 && event.key.repeat == 0 && TraceRecorder::get_enabled()) {
+            const bool saved = TraceRecorder::flush();
+            this->notification_manager->push({
+                saved ? "Trace saved!" : "Error!",
+                saved ? "Trace written to the BRUSHY_TRACE file." : "Could not write the trace file.",
+                { this->window_width - 20 - 300, this->window_height - 20 - 80, 300, 80 },
+            });
+        }
+
+#ifdef BRUSHY_PROFILER
+        // Toggles the frame profiler HUD.
+        if (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3 && event.key.repeat == 0) {
+            FrameProfiler::toggle_hud();
+            this->compositor->damage_all();
+        }
+#endif
+
         // Processes window resizing.
         if (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
             window_surface = SDL_GetWindowSurface(window);
             this->window_width = window_surface->w;
             this->window_height = window_surface->h;
+            this->compositor->damage_all();
 
             if (this->new_drawing_button) {
                 this->new_drawing_button->set_position(
@@ -222,7 +329,10 @@ void App::handle_events() {
                 int universe_w = 0, universe_h = 0;
                 Uint32 background_color = 0;
 
-                if (FileManager::load_scene("ExemploCorrigido.csv", this->window_surface, this->shapes,
+                // The shapes are replaced (even when loading fails halfway).
+                this->display_list.clear();
+
+                if (FileManager::load_scene("ExemploCorrigido.csv", this->shapes,
                                             &loaded_width, &loaded_height,
                                             &universe_w, &universe_h,
                                             &background_color))
@@ -289,7 +399,12 @@ void App::handle_events() {
 
 
             } else if (this->app_state == AppState::RENDERING_SCREEN && this->save_button->is_clicked(mx, my)) {
-                if (SDL_SaveBMP(this->drawing_surface, "screenshot.bmp") == 0) {
+                // O canvas é convertido uma única vez, na exportação, para RGB de 24 bits.
+                SDL_Surface* screenshot = CanvasFormat::convert(this->drawing_surface, SDL_PIXELFORMAT_RGB24);
+                const bool saved = screenshot && SDL_SaveBMP(screenshot, "screenshot.bmp") == 0;
+                SDL_FreeSurface(screenshot);
+
+                if (saved) {
                     this->notification_manager->push({
                         "Screenshot saved!",
                         "Screenshot saved at the root directory.",
@@ -397,15 +512,15 @@ void App::handle_events() {
                 std::string temp = "";
                 if (this->changing_color == ColorState::PRIMARY){
                     temp = "Primary color is set red";
-                    this->primary_color = red_button->color;
+                    this->primary_color = Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, "red");
                 }
                 else if (this->changing_color == ColorState::SECONDARY){
                     temp = "Seconday color is set red";
-                    this->second_color = red_button->color;
+                    this->second_color = Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, "red");
                 }
                 else if (this->changing_color == ColorState::TERTIARY){
                     temp = "Tertiary color is set red";
-                    this->tertiary_color = red_button->color;
+                    this->tertiary_color = Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, "red");
                 }
 
                 this->notification_manager->push({
@@ -417,15 +532,15 @@ void App::handle_events() {
                 std::string temp = "";
                 if (this->changing_color == ColorState::PRIMARY){
                     temp = "Primary color is set blue";
-                    this->primary_color = blue_button->color;
+                    this->primary_color = Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, "aqua");
                 }
                 else if (this->changing_color == ColorState::SECONDARY){
                     temp = "Seconday color is set blue";
-                    this->second_color = blue_button->color;
+                    this->second_color = Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, "aqua");
                 }
                 else if (this->changing_color == ColorState::TERTIARY){
                     temp = "Tertiary color is set blue";
-                    this->tertiary_color = blue_button->color;
+                    this->tertiary_color = Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, "aqua");
                 }
 
                 this->notification_manager->push({
@@ -437,15 +552,15 @@ void App::handle_events() {
                 std::string temp = "";
                 if (this->changing_color == ColorState::PRIMARY){
                     temp = "Primary color is set green";
-                    this->primary_color = green_button->color;
+                    this->primary_color = Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, "green");
                 }
                 else if (this->changing_color == ColorState::SECONDARY){
                     temp = "Seconday color is set green";
-                    this->second_color = green_button->color;
+                    this->second_color = Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, "green");
                 }
                 else if (this->changing_color == ColorState::TERTIARY){
                     temp = "Tertiary color is set green";
-                    this->tertiary_color = green_button->color;
+                    this->tertiary_color = Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, "green");
                 }
 
                 this->notification_manager->push({
@@ -459,23 +574,26 @@ void App::handle_events() {
                     int cx = mx - dst_rect.x;     // coordenada X no canvas
                     int cy = my - dst_rect.y;     // coordenada Y no canvas
 
-                    this->points.emplace_back(Point(cx, cy,this->primary_color));
+                    this->paint_stroke_active = false;
+                    this->paint_stroke(cx, cy, this->primary_color);
                 } if (this->mouse_state == MouseState::ERASER_MODE){
                     int cx = mx - dst_rect.x;     // coordenada X no canvas
                     int cy = my - dst_rect.y;     // coordenada Y no canvas
 
-                    this->eraser_points.emplace_back(cx, cy);
+                    this->paint_stroke_active = false;
+                    this->paint_stroke(cx, cy, this->background_drawing_color);
                 } else if (this->mouse_state == MouseState::BUCKET_MODE) {
                     int cx = mx - dst_rect.x;     // coordenada X no canvas
                     int cy = my - dst_rect.y;     // coordenada Y no canvas
 
-                    this->fill_points.emplace_back(Point(cx, cy, this->primary_color));
+                    this->paint_fill(cx, cy, this->primary_color);
                 }else if (this->mouse_state == MouseState::LINE_MODE) {
                     int cx = mx - dst_rect.x;     // coordenada X no canvas
                     int cy = my - dst_rect.y;     // coordenada Y no canvas
 
                     this->initial_point = Point(cx, cy);
                     this->lines.emplace_back(std::array<Point,2>{{ Point(cx,cy), Point(cx,cy) }});
+                    this->compositor->damage_canvas(line_bounds(this->lines.back()[0], this->lines.back()[1]));
                     this->temporary_in_list = true;
                 } else if (this->mouse_state == MouseState::HOUSE_MODE || this->mouse_state == MouseState::TREE_MODE || this->mouse_state == MouseState::FENCE_MODE || this->mouse_state == MouseState::SUN_MODE) {
                     int cx = mx - dst_rect.x;     // coordenada X no canvas
@@ -507,18 +625,22 @@ void App::handle_events() {
                     int cx = mx - dst_rect.x;     // coordenada X no canvas
                     int cy = my - dst_rect.y;     // coordenada Y no canvas
 
-                    points.emplace_back(cx, cy);
+                    this->paint_stroke(cx, cy, this->primary_color);
                 }else if (this->mouse_state == MouseState::ERASER_MODE){
                     int cx = mx - dst_rect.x;     // coordenada X no canvas
                     int cy = my - dst_rect.y;     // coordenada Y no canvas
 
-                    eraser_points.emplace_back(cx, cy);
+                    this->paint_stroke(cx, cy, this->background_drawing_color);
                 }else if (this->mouse_state == MouseState::LINE_MODE){
                     int cx = mx - dst_rect.x;     // coordenada X no canvas
                     int cy = my - dst_rect.y;     // coordenada Y no canvas
-                    if (!this->lines.empty()) lines.pop_back();
+                    if (!this->lines.empty()) {
+                        this->compositor->damage_canvas(line_bounds(this->lines.back()[0], this->lines.back()[1]));
+                        lines.pop_back();
+                    }
                     this->temporary_in_list = true;
                     this->lines.emplace_back(std::array<Point,2>{{ initial_point, Point(cx,cy,this->primary_color) }});
+                    this->compositor->damage_canvas(line_bounds(this->lines.back()[0], this->lines.back()[1]));
                 } else if (this->mouse_state == MouseState::HOUSE_MODE || this->mouse_state == MouseState::TREE_MODE || this->mouse_state == MouseState::FENCE_MODE || this->mouse_state == MouseState::SUN_MODE){
                     // mouse -> canvas
                     int cx1 = mx - dst_rect.x;
@@ -526,7 +648,11 @@ void App::handle_events() {
 
                     this->temporary_dragging_point = Point(cx1, cy1);
                     if (this->temporary_in_list){
-                        if (!this->shapes.empty()) shapes.pop_back();
+                        if (!this->shapes.empty()) {
+                            this->compositor->damage_canvas(this->shapes.back()->get_canvas_bounds(drawing_surface->w, drawing_surface->h));
+                            shapes.pop_back();
+                            this->display_list.truncate_shapes(this->shapes.size());
+                        }
 
                         this->temporary_in_list = false;
                     }
@@ -536,7 +662,7 @@ void App::handle_events() {
                     Utils::UniverseRect ur = Utils::canvas_drag_to_universe(c0, c1, drawing_surface->w, drawing_surface->h, App::universe_width, App::universe_height);
 
                     // Construtor do House é (width, height, x_origin, y_origin, cores...)
-                    Uint32 c = SDL_MapRGB(window_surface->format, 255, 100, 50);
+                    Uint32 c = CanvasFormat::pack(255, 100, 50);
 
                     if (this->mouse_state == MouseState::HOUSE_MODE){
                         shapes.emplace_back(std::unique_ptr<Shape>(new House( int(std::lround(ur.w)),
@@ -563,6 +689,10 @@ void App::handle_events() {
                          int(std::lround(ur.y)),
                          this->primary_color, this->second_color)));
                     }
+
+                    if (!this->shapes.empty()) {
+                        this->compositor->damage_canvas(this->shapes.back()->get_canvas_bounds(drawing_surface->w, drawing_surface->h));
+                    }
                     // limpa estado do drag
                     this->temporary_in_list = true;
                 }
@@ -580,7 +710,10 @@ void App::handle_events() {
                     });
             }
 
-            if (event.button.button == SDL_BUTTON_LEFT) mouse_down = false;
+            if (event.button.button == SDL_BUTTON_LEFT) {
+                mouse_down = false;
+                this->paint_stroke_active = false;
+            }
         }
 
         this->notification_manager->handle_event(&event);
@@ -598,7 +731,73 @@ void App::handle_events() {
 
 // METHOD IMPLEMENTATION
 void App::update_screen() {
-    SDL_UpdateWindowSurface(window);
+    PROFILE_SCOPE(PRESENT);
+
+    if (this->app_state != AppState::RENDERING_SCREEN) {
+        SDL_UpdateWindowSurface(window);
+        return;
+    }
+
+    // Presents only the rectangles recomposed in this frame.
+    const std::vector<SDL_Rect>& damaged = this->compositor->get_window_damage();
+    if (!damaged.empty()) {
+        SDL_UpdateWindowSurfaceRects(window, damaged.data(), static_cast<int>(damaged.size()));
+    }
+
+    this->compositor->end_frame();
+
+    if (this->show_damage_stats && SDL_GetTicks() - this->last_stats_update >= 500) {
+        std::string title = this->window_title + " | " + this->compositor->get_stats_text();
+        SDL_SetWindowTitle(this->window, title.c_str());
+        this->last_stats_update = SDL_GetTicks();
+    }
+}
+
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Marks the screen as changed, so the next frame slot renders it.
+ */
+void App::invalidate() {
+    this->redraw_requested = true;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Milliseconds until the next frame should be rendered: 0 when one is due now,
+ * the time left in the current frame slot when the screen is invalidated or
+ * animating, the time until the next notification change otherwise, or -1 when
+ * nothing will change without an event.
+ */
+int App::get_frame_wait() {
+    int notification_wait = this->notification_manager->get_wait_timeout();
+    bool animating = notification_wait == 0;
+
+    if (!this->redraw_requested && !animating) return notification_wait;
+
+    Uint32 elapsed = SDL_GetTicks() - this->last_frame_time;
+    return elapsed >= this->frame_interval ? 0 : static_cast<int>(this->frame_interval - elapsed);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Blocks until an event is queued or the next frame is due. The event is left in
+ * the queue for handle_events. An idle window does not wake up at all.
+ */
+void App::wait_for_events() {
+    int wait = this->get_frame_wait();
+
+    if (wait < 0) {
+        SDL_WaitEvent(nullptr);
+    } else if (wait > 0) {
+        SDL_WaitEventTimeout(nullptr, wait);
+    }
 }
 
 
@@ -820,6 +1019,8 @@ void App::unload_new_project_screen() {
 
 // METHOD IMPLEMENTATION
 void App::load_rendering_screen() {
+    this->compositor->damage_all();
+
     this->app_bar_rendering_screen = new AppBar(this->window_width, App::app_bar_height, "", FontManager::roboto_semibold_20);
     this->app_bar_rendering_screen->set_background_color({255, 255, 255, 255});
     this->app_bar_rendering_screen->setTextColor({0, 0, 0, 255});
@@ -1061,6 +1262,7 @@ void App::render_menu_screen() {
     this->new_drawing_button->draw(window_surface);
     this->load_project_button->draw(window_surface);
     this->app_icon_image->draw(window_surface);
+    this->notification_manager->draw(this->window_surface);
 }
 
 
@@ -1102,47 +1304,191 @@ void App::render_new_project_screen() {
     this->create_project_button->draw(window_surface);
     this->back_menu_button->draw(window_surface);
     this->app_bar_project_screen->draw(this->window_surface);
+    this->notification_manager->draw(this->window_surface);
 }
 
 
 // METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Renders the drawing screen incrementally. Only the canvas rectangles reported
+ * to the compositor since the last frame are re-rasterized, and only the window
+ * rectangles that changed are recomposed (and later presented by update_screen).
+ */
 void App::render_rendering_screen() {
-    // Renders the background surface.
-    SDL_FillRect(this->window_surface, nullptr, Colors::get_color(this->window_surface, Colors::interface_colors_table, Colors::number_of_interface_colors, "primary_background_window"));
+    SDL_Rect canvas_rect = this->get_canvas_rect();
+    SDL_Rect notification_damage;
+
+    if (this->notification_manager->take_damage(&notification_damage)) {
+        this->compositor->damage_window(notification_damage);
+    }
+
+#ifdef BRUSHY_PROFILER
+    // The HUD is drawn over the composed window, so its area is recomposed every frame.
+    if (FrameProfiler::get_hud_visible()) {
+        SDL_Point hud = this->get_profiler_hud_position();
+        this->compositor->damage_window(FrameProfiler::get_hud_rect(hud.x, hud.y));
+    }
+#endif
+
+    this->compositor->begin_frame(this->window_width, this->window_height, canvas_rect);
+
+    for (const SDL_Rect& rect : this->compositor->get_canvas_damage()) {
+        this->repaint_canvas(rect);
+    }
+
+    for (const SDL_Rect& rect : this->compositor->get_window_damage()) {
+        this->compose_window(rect, canvas_rect);
+    }
+}
 
-    // Renders the drawing surface.
-    SDL_FillRect(this->drawing_surface, nullptr, this->background_drawing_color);
 
-    for (auto& seg : lines) {
-        Point& p0 = seg[0];
-        Point& p1 = seg[1];
-        Primitives::draw_line(drawing_surface, p0.get_x(), p0.get_y(), p1.get_x(), p1.get_y(), p1.color, true);
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Re-rasterizes one damaged rectangle of the drawing surface. The rectangle is
+ * set as the surface clip, so the primitives only touch pixels inside it, and
+ * the shapes are replayed from the display list, skipping the commands whose
+ * bounds do not overlap it. With more than one render thread the rectangle is
+ * split into tiles rasterized in parallel by the TileRenderer, with the same
+ * result. The paint layer is then blended over the shapes.
+ *
+ * @param rect
+ * Damaged area in canvas coordinates.
+ */
+void App::repaint_canvas(const SDL_Rect& rect) {
+    TRACE_SCOPE("repaint_canvas");
+    int shapes_redrawn = 0;
+
+    {
+        PROFILE_SCOPE(DISPLAY_LIST);
+        this->update_display_list();
     }
 
-    for (size_t i = 0; i < shapes.size(); ++i) {
-        shapes[i]->draw(drawing_surface);
+    if (this->tile_renderer && this->tile_renderer->get_thread_count() > 1) {
+        // Lines first, then shape commands: the same painter's order as the serial path.
+        std::vector<const std::array<Point,2>*> segments;
+        std::vector<SDL_Rect> bounds;
+
+        for (auto& seg : lines) {
+            segments.push_back(&seg);
+            bounds.push_back(line_bounds(seg[0], seg[1]));
+        }
+
+        for (size_t i = 0; i < this->display_list.size(); ++i) {
+            bounds.push_back(this->display_list.get_bounds(i));
+        }
+
+        PROFILE_SCOPE(TILES);
+        shapes_redrawn = this->tile_renderer->render(this->drawing_surface, rect, this->background_drawing_color, bounds,
+            [this, &segments](SDL_Surface* target, size_t index) {
+                if (index < segments.size()) {
+                    const Point& p0 = (*segments[index])[0];
+                    const Point& p1 = (*segments[index])[1];
+                    Primitives::draw_line(target, p0.get_x(), p0.get_y(), p1.get_x(), p1.get_y(), p1.color, true);
+                } else {
+                    this->display_list.execute(target, index - segments.size());
+                }
+            });
+
+        SDL_SetClipRect(this->drawing_surface, &rect);
+    } else {
+        SDL_SetClipRect(this->drawing_surface, &rect);
+
+        // Renders the drawing surface.
+        {
+            PROFILE_SCOPE(CLEAR);
+            SpanWriter::fill_rect(this->drawing_surface, rect, this->background_drawing_color);
+        }
+
+        {
+            PROFILE_SCOPE(LINES);
+
+            for (auto& seg : lines) {
+                Point& p0 = seg[0];
+                Point& p1 = seg[1];
+                SDL_Rect bounds = line_bounds(p0, p1);
+
+                if (SDL_HasIntersection(&bounds, &rect)) {
+                    Primitives::draw_line(drawing_surface, p0.get_x(), p0.get_y(), p1.get_x(), p1.get_y(), p1.color, true);
+                }
+            }
+        }
+
+        PROFILE_SCOPE(SHAPES);
+        shapes_redrawn = this->display_list.execute(this->drawing_surface);
     }
 
-    for (Point p : this->points) {
-        Primitives::set_pixel(drawing_surface, p.get_x(), p.get_y(), p.color);
+    this->compositor->add_shapes_redrawn(shapes_redrawn);
+
+    {
+        PROFILE_SCOPE(PAINT_LAYER);
+        CanvasFormat::composite(this->paint_surface, this->drawing_surface, rect);
     }
 
-    for (Point p : this->fill_points) {
-        Uint32 p_color = SDL_MapRGB(drawing_surface->format, 0, 240, 100); //TODO: TROCAR PARA COR PRIMÁRIA
-        Primitives::flood_fill(drawing_surface, p.get_x(), p.get_y(), p.color);
+    SDL_SetClipRect(this->drawing_surface, nullptr);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Brings the display list up to date with the shape list. Shapes compiled in an
+ * earlier frame are kept; only the shapes appended since then are compiled. A new
+ * canvas size or universe changes every canvas coordinate, so the whole list is
+ * rebuilt. Code that removes or replaces shapes must truncate or clear the list.
+ */
+void App::update_display_list() {
+    const int canvas_w = this->drawing_surface->w;
+    const int canvas_h = this->drawing_surface->h;
+
+    if (canvas_w != this->display_list_canvas_w || canvas_h != this->display_list_canvas_h ||
+        App::universe_width != this->display_list_universe_w || App::universe_height != this->display_list_universe_h) {
+        this->display_list.clear();
+        this->display_list_canvas_w = canvas_w;
+        this->display_list_canvas_h = canvas_h;
+        this->display_list_universe_w = App::universe_width;
+        this->display_list_universe_h = App::universe_height;
     }
 
-    for (Point p : this->eraser_points) {
-        Uint32 p_color = SDL_MapRGB(drawing_surface->format, 255, 255, 255); //TODO: TROCAR PARA COR DE FUNDO
-        Primitives::set_pixel(drawing_surface, p.get_x(), p.get_y(), this->background_drawing_color);
+    this->display_list.truncate_shapes(std::min(this->display_list.get_shape_count(), this->shapes.size()));
+
+    for (size_t i = this->display_list.get_shape_count(); i < this->shapes.size(); ++i) {
+        TRACE_SCOPE("Shape::compile");
+        this->shapes[i]->compile(this->display_list, canvas_w, canvas_h);
+        this->display_list.end_shape();
     }
+}
 
-    SDL_Rect drawing_surface_rectangle;
-    drawing_surface_rectangle.w = drawing_surface->w;
-    drawing_surface_rectangle.h = drawing_surface->h;
-    drawing_surface_rectangle.x = (window_width - drawing_surface_rectangle.w - 2) / 2;
-    drawing_surface_rectangle.y = (window_height - drawing_surface_rectangle.h + App::app_bar_height) / 2;
-    SDL_BlitSurface(drawing_surface, nullptr, window_surface, &drawing_surface_rectangle);
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Recomposes one damaged rectangle of the window: background, canvas, interface
+ * components and notification, all clipped to the rectangle.
+ *
+ * @param rect
+ * Damaged area in window coordinates.
+ *
+ * @param canvas_rect
+ * Position of the drawing surface inside the window.
+ */
+void App::compose_window(const SDL_Rect& rect, const SDL_Rect& canvas_rect) {
+    SDL_SetClipRect(this->window_surface, &rect);
+
+    {
+        PROFILE_SCOPE(BLIT);
+
+        // Renders the background surface.
+        SDL_FillRect(this->window_surface, &rect, Colors::get_color(this->window_surface, Colors::interface_colors_table, Colors::number_of_interface_colors, "primary_background_window"));
+
+        // The canvas is opaque, so its premultiplied pixels are copied and converted to
+        // the window format by the blit; this is the only conversion per frame.
+        SDL_Rect drawing_surface_rectangle = canvas_rect;
+        SDL_BlitSurface(drawing_surface, nullptr, window_surface, &drawing_surface_rectangle);
+    }
+
+    PROFILE_SCOPE(INTERFACE);
 
     // Draws the components of the graphical interface.
     this->app_bar_rendering_screen->draw(this->window_surface);
@@ -1161,9 +1507,46 @@ void App::render_rendering_screen() {
     this->red_button->draw(this->window_surface);
     this->blue_button->draw(this->window_surface);
     this->save_button->draw(this->window_surface);
+
+    this->notification_manager->draw(this->window_surface);
+
+    SDL_SetClipRect(this->window_surface, nullptr);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Returns the position and size of the drawing surface inside the window.
+ */
+SDL_Rect App::get_canvas_rect() {
+    SDL_Rect drawing_surface_rectangle;
+    drawing_surface_rectangle.w = drawing_surface->w;
+    drawing_surface_rectangle.h = drawing_surface->h;
+    drawing_surface_rectangle.x = (window_width - drawing_surface_rectangle.w - 2) / 2;
+    drawing_surface_rectangle.y = (window_height - drawing_surface_rectangle.h + App::app_bar_height) / 2;
+    return drawing_surface_rectangle;
 }
 
 
+#ifdef BRUSHY_PROFILER
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Top-left corner of the profiler HUD: inside the canvas on the rendering
+ * screen, below the app bar elsewhere.
+ */
+SDL_Point App::get_profiler_hud_position() {
+    if (this->app_state == AppState::RENDERING_SCREEN) {
+        SDL_Rect canvas_rect = this->get_canvas_rect();
+        return { canvas_rect.x + 8, canvas_rect.y + 8 };
+    }
+
+    return { 8, App::app_bar_height + 8 };
+}
+#endif
+
+
 // METHOD IMPLEMENTATION
 bool App::recreate_drawing_surface(int new_width, int new_height) {
     if (this->drawing_surface != nullptr) {
@@ -1171,21 +1554,88 @@ bool App::recreate_drawing_surface(int new_width, int new_height) {
         this->drawing_surface = nullptr;
     }
 
-    this->drawing_surface = SDL_CreateRGBSurface(
-        0,
-        new_width,
-        new_height,
-        32,
-        0x00FF0000,
-        0x0000FF00,
-        0x000000FF,
-        0x00000000
-    );
+    this->drawing_surface = CanvasFormat::create_surface(new_width, new_height);
 
     if (!this->drawing_surface) {
         ErrorHandler::fatal_error("Unable to recreate drawing surface: %s", SDL_GetError());
         return false;
     }
 
+    // The paint layer always matches the drawing surface and starts fully transparent.
+    if (this->paint_surface != nullptr) {
+        SDL_FreeSurface(this->paint_surface);
+        this->paint_surface = nullptr;
+    }
+
+    this->paint_surface = CanvasFormat::create_surface(new_width, new_height);
+
+    if (!this->paint_surface) {
+        ErrorHandler::fatal_error("Unable to create paint layer: %s", SDL_GetError());
+        return false;
+    }
+
     return true;
 }
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Extends the pencil or eraser stroke to (cx, cy) in the paint layer. Mouse motion
+ * events are sparse, so the previous position is joined to this one by a round-capped
+ * segment of paint_stroke_width pixels instead of leaving isolated dots. The stroke is
+ * aliased: the paint layer only holds opaque pixels. Only the rectangle written by
+ * the stroker is reported to the compositor.
+ *
+ * @param cx
+ * X coordinate in the canvas.
+ *
+ * @param cy
+ * Y coordinate in the canvas.
+ *
+ * @param color
+ * Color in the drawing surface format (the background color for the eraser).
+ */
+void App::paint_stroke(int cx, int cy, Uint32 color) {
+    Stroker::Style style = Stroker::default_style((float)App::paint_stroke_width);
+    style.anti_aliasing = false;
+
+    const SDL_Point from = this->paint_stroke_active ? this->last_paint_point : SDL_Point{cx, cy};
+    SDL_Rect written = Stroker::stroke_line(this->paint_surface, (float)from.x, (float)from.y, (float)cx, (float)cy, color, style);
+
+    this->paint_stroke_active = true;
+    this->last_paint_point = {cx, cy};
+
+    if (written.w > 0 && written.h > 0) {
+        this->compositor->damage_canvas(written);
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Bucket tool. The region is searched on the composited canvas (shapes, lines and
+ * paint), as the user sees it, and the fill is stored in the paint layer. Pending
+ * damage is repainted first so the search never runs on a stale canvas.
+ *
+ * @param cx
+ * X coordinate of the seed in the canvas.
+ *
+ * @param cy
+ * Y coordinate of the seed in the canvas.
+ *
+ * @param color
+ * Fill color in the drawing surface format.
+ */
+void App::paint_fill(int cx, int cy, Uint32 color) {
+    if (this->compositor->has_pending_canvas_damage()) {
+        this->repaint_canvas({0, 0, this->drawing_surface->w, this->drawing_surface->h});
+    }
+
+    SDL_Rect filled = Primitives::flood_fill_into(this->drawing_surface, this->paint_surface, cx, cy, color);
+
+    if (filled.w > 0 && filled.h > 0) {
+        this->compositor->damage_canvas(filled);
+    }
+}
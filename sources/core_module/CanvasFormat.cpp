@@ -0,0 +1,150 @@
+// INCLUDES
+#include "App.h"
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Creates a canvas surface, cleared to transparent.
+ *
+ * Blitting the canvas copies its pixels (SDL_BLENDMODE_NONE): layers are combined
+ * by CanvasFormat::composite, which knows the channels are premultiplied.
+ *
+ * @return The new surface, or nullptr with SDL_GetError() set.
+ */
+SDL_Surface* CanvasFormat::create_surface(int width, int height) {
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, CanvasFormat::pixel_format);
+    if (!surface) return nullptr;
+
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    SDL_FillRect(surface, nullptr, CanvasFormat::transparent);
+    return surface;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Copies a canvas into a new surface of another pixel format, for export.
+ *
+ * Translucent pixels are divided back by their alpha first, since SDL expects
+ * straight alpha; the drawing surface is opaque, so this is normally a plain copy
+ * followed by a single SDL conversion.
+ *
+ * @param canvas        Surface in the canvas format.
+ * @param target_format SDL_PIXELFORMAT_* of the result.
+ *
+ * @return The converted surface (owned by the caller), or nullptr on failure.
+ */
+SDL_Surface* CanvasFormat::convert(SDL_Surface* canvas, Uint32 target_format) {
+    if (!canvas || canvas->format->format != CanvasFormat::pixel_format) return nullptr;
+
+    SDL_Surface* straight = SDL_CreateRGBSurfaceWithFormat(0, canvas->w, canvas->h, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (!straight) return nullptr;
+
+    for (int y = 0; y < canvas->h; ++y) {
+        const Uint32* src = (const Uint32*)((const Uint8*)canvas->pixels + y * canvas->pitch);
+        Uint32* dst = (Uint32*)((Uint8*)straight->pixels + y * straight->pitch);
+
+        for (int x = 0; x < canvas->w; ++x) {
+            const Uint32 pixel = src[x];
+            if ((pixel & CanvasFormat::alpha_mask) == CanvasFormat::alpha_mask || pixel == 0) {
+                dst[x] = pixel;
+            } else {
+                const SDL_Color c = CanvasFormat::unpack(pixel);
+                dst[x] = ((Uint32)c.a << 24) | ((Uint32)c.r << 16) | ((Uint32)c.g << 8) | c.b;
+            }
+        }
+    }
+
+    SDL_Surface* converted = SDL_ConvertSurfaceFormat(straight, target_format, 0);
+    SDL_FreeSurface(straight);
+    return converted;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Packs a straight-alpha color into a canvas pixel (channels times alpha).
+ */
+Uint32 CanvasFormat::pack(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    if (a != SDL_ALPHA_OPAQUE) {
+        r = (Uint8)((r * a + 127) / 255);
+        g = (Uint8)((g * a + 127) / 255);
+        b = (Uint8)((b * a + 127) / 255);
+    }
+
+    return ((Uint32)a << CanvasFormat::alpha_shift) | ((Uint32)r << CanvasFormat::red_shift)
+         | ((Uint32)g << CanvasFormat::green_shift) | ((Uint32)b << CanvasFormat::blue_shift);
+}
+
+
+// METHOD IMPLEMENTATION
+Uint32 CanvasFormat::pack(SDL_Color color) {
+    return CanvasFormat::pack(color.r, color.g, color.b, color.a);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Unpacks a canvas pixel into a straight-alpha color.
+ */
+SDL_Color CanvasFormat::unpack(Uint32 pixel) {
+    SDL_Color color;
+    color.a = (Uint8)(pixel >> CanvasFormat::alpha_shift);
+    color.r = (Uint8)(pixel >> CanvasFormat::red_shift);
+    color.g = (Uint8)(pixel >> CanvasFormat::green_shift);
+    color.b = (Uint8)(pixel >> CanvasFormat::blue_shift);
+
+    if (color.a != SDL_ALPHA_OPAQUE && color.a != 0) {
+        const int half = color.a / 2;
+        color.r = (Uint8)SDL_min(255, (color.r * 255 + half) / color.a);
+        color.g = (Uint8)SDL_min(255, (color.g * 255 + half) / color.a);
+        color.b = (Uint8)SDL_min(255, (color.b * 255 + half) / color.a);
+    }
+
+    return color;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Composites a layer over a canvas (premultiplied source-over) inside rect.
+ *
+ * Opaque layer pixels are copied and transparent ones skipped; only the rest pay
+ * for the blend, done on the red/blue and alpha/green lanes like CoverageBlender.
+ * Both surfaces must be canvas surfaces of the same size.
+ *
+ * @param layer  Layer on top (the paint layer).
+ * @param canvas Canvas below, written in place.
+ * @param rect   Area to composite, clipped to both surfaces.
+ */
+void CanvasFormat::composite(SDL_Surface* layer, SDL_Surface* canvas, const SDL_Rect& rect) {
+    if (!layer || !canvas) return;
+
+    const int x0 = SDL_max(rect.x, 0);
+    const int y0 = SDL_max(rect.y, 0);
+    const int x1 = SDL_min(rect.x + rect.w, SDL_min(layer->w, canvas->w));
+    const int y1 = SDL_min(rect.y + rect.h, SDL_min(layer->h, canvas->h));
+
+    for (int y = y0; y < y1; ++y) {
+        const Uint32* src = (const Uint32*)((const Uint8*)layer->pixels + y * layer->pitch);
+        Uint32* dst = (Uint32*)((Uint8*)canvas->pixels + y * canvas->pitch);
+
+        for (int x = x0; x < x1; ++x) {
+            const Uint32 s = src[x];
+            const Uint32 alpha = s >> CanvasFormat::alpha_shift;
+
+            if (alpha == 0) continue;
+            if (alpha == 255) {
+                dst[x] = s;
+                continue;
+            }
+
+            // d * (1 - alpha) + s; the sum of both lanes never exceeds 255.
+            const Uint32 inverse = 256 - (alpha + (alpha >> 7));
+            const Uint32 d = dst[x];
+            const Uint32 rb = (((d & 0x00FF00FF) * inverse) >> 8) & 0x00FF00FF;
+            const Uint32 ag = (((d >> 8) & 0x00FF00FF) * inverse) & 0xFF00FF00;
+            dst[x] = s + (rb | ag);
+        }
+    }
+}
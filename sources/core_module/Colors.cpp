@@ -212,3 +212,21 @@ Uint32 Colors::get_color(SDL_Surface* surface, const Colors::ColorItem* color_ta
     return Colors::rgb_to_uint32(surface, 0, 0, 0);
 }
 
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Same lookup as get_color, but the result is a canvas pixel (CanvasFormat) and
+ * does not depend on any surface. Colors that are drawn into the canvas (scene
+ * files, tool colors) must come from here, not from the window surface format.
+ */
+Uint32 Colors::get_canvas_color(const Colors::ColorItem* color_table, const int table_size, const std::string& color_name) {
+    for (int i = 0; i < table_size; i++) {
+        if (strcasecmp(color_table[i].name, color_name.c_str()) == 0) {
+            return CanvasFormat::pack(color_table[i].color.r, color_table[i].color.g, color_table[i].color.b);
+        }
+    }
+
+    // If not found, returns black by default.
+    return CanvasFormat::opaque_black;
+}
@@ -0,0 +1,248 @@
+// INCLUDES
+#include "Compositor.h"
+
+
+// CONSTRUCTOR IMPLEMENTATION
+Compositor::Compositor() {
+    this->pending_full = true;
+    this->frame_canvas_area = 0;
+    this->frame_canvas_total = 0;
+    this->frame_shapes_redrawn = 0;
+    this->stats = {0.0f, 0.0f, 0, 0, 0};
+    this->history_count = 0;
+    this->history_index = 0;
+
+    for (int i = 0; i < history_size; ++i) {
+        this->history[i] = 0.0f;
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Reports a rectangle of the drawing surface that changed and must be
+ * re-rasterized in the next frame.
+ *
+ * @param rect
+ * Damaged area in canvas coordinates. It is clipped to the canvas when the
+ * frame begins, so callers may pass rectangles that overflow it.
+ */
+void Compositor::damage_canvas(const SDL_Rect& rect) {
+    Compositor::add_rect(this->pending_canvas, rect);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Reports a rectangle of the window that changed (interface components,
+ * notifications) and must be recomposed and presented in the next frame.
+ *
+ * @param rect
+ * Damaged area in window coordinates.
+ */
+void Compositor::damage_window(const SDL_Rect& rect) {
+    Compositor::add_rect(this->pending_window, rect);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Invalidates the whole window and the whole canvas. Used when the screen is
+ * loaded, the window is resized or exposed, or the scene is replaced.
+ */
+void Compositor::damage_all() {
+    this->pending_full = true;
+}
+
+
+// METHOD IMPLEMENTATION
+bool Compositor::has_pending_canvas_damage() const {
+    return this->pending_full || !this->pending_canvas.empty();
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Freezes the damage reported so far into the lists used by the current frame.
+ * Canvas damage is clipped to the canvas and also translated into window damage,
+ * since every redrawn canvas area has to be presented again.
+ *
+ * @param window_width
+ * Current window width.
+ *
+ * @param window_height
+ * Current window height.
+ *
+ * @param canvas_rect
+ * Position and size of the drawing surface inside the window.
+ */
+void Compositor::begin_frame(int window_width, int window_height, const SDL_Rect& canvas_rect) {
+    SDL_Rect canvas_bounds = {0, 0, canvas_rect.w, canvas_rect.h};
+    SDL_Rect window_bounds = {0, 0, window_width, window_height};
+    SDL_Rect clipped;
+
+    this->frame_canvas.clear();
+    this->frame_window.clear();
+    this->frame_canvas_area = 0;
+    this->frame_shapes_redrawn = 0;
+
+    if (this->pending_full) {
+        this->frame_canvas.push_back(canvas_bounds);
+        this->frame_window.push_back(window_bounds);
+    } else {
+        for (const SDL_Rect& r : this->pending_canvas) {
+            if (SDL_IntersectRect(&r, &canvas_bounds, &clipped)) {
+                Compositor::add_rect(this->frame_canvas, clipped);
+            }
+        }
+
+        for (const SDL_Rect& r : this->frame_canvas) {
+            SDL_Rect translated = {r.x + canvas_rect.x, r.y + canvas_rect.y, r.w, r.h};
+            if (SDL_IntersectRect(&translated, &window_bounds, &clipped)) {
+                Compositor::add_rect(this->frame_window, clipped);
+            }
+        }
+
+        for (const SDL_Rect& r : this->pending_window) {
+            if (SDL_IntersectRect(&r, &window_bounds, &clipped)) {
+                Compositor::add_rect(this->frame_window, clipped);
+            }
+        }
+    }
+
+    for (const SDL_Rect& r : this->frame_canvas) {
+        this->frame_canvas_area += Compositor::rect_area(r);
+    }
+
+    this->frame_canvas_total = Compositor::rect_area(canvas_bounds);
+    if (this->frame_canvas_area > this->frame_canvas_total) this->frame_canvas_area = this->frame_canvas_total;
+
+    this->pending_canvas.clear();
+    this->pending_window.clear();
+    this->pending_full = false;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Closes the current frame: updates the damage statistics and releases the
+ * frame lists. Frames without any damage are counted as 0% in the rolling average.
+ */
+void Compositor::end_frame() {
+    if (this->frame_canvas_total > 0) {
+        this->stats.damaged_percent = 100.0f * (float)this->frame_canvas_area / (float)this->frame_canvas_total;
+    } else {
+        this->stats.damaged_percent = 0.0f;
+    }
+
+    this->stats.canvas_rects = (int)this->frame_canvas.size();
+    this->stats.window_rects = (int)this->frame_window.size();
+    this->stats.shapes_redrawn = this->frame_shapes_redrawn;
+
+    this->history[this->history_index] = this->stats.damaged_percent;
+    this->history_index = (this->history_index + 1) % history_size;
+    if (this->history_count < history_size) this->history_count++;
+
+    float sum = 0.0f;
+    for (int i = 0; i < this->history_count; ++i) {
+        sum += this->history[i];
+    }
+    this->stats.average_percent = sum / (float)this->history_count;
+
+    this->frame_canvas.clear();
+    this->frame_window.clear();
+}
+
+
+// METHOD IMPLEMENTATION
+void Compositor::add_shapes_redrawn(int count) {
+    this->frame_shapes_redrawn += count;
+}
+
+
+// METHOD IMPLEMENTATION
+const std::vector<SDL_Rect>& Compositor::get_canvas_damage() const {
+    return this->frame_canvas;
+}
+
+
+// METHOD IMPLEMENTATION
+const std::vector<SDL_Rect>& Compositor::get_window_damage() const {
+    return this->frame_window;
+}
+
+
+// METHOD IMPLEMENTATION
+const Compositor::FrameStats& Compositor::get_stats() const {
+    return this->stats;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Formats the damage statistics of the last frame in a single line, suitable
+ * for the window title.
+ */
+std::string Compositor::get_stats_text() const {
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer), "damage %.1f%% (avg %.1f%%) | %d canvas rects | %d window rects | %d draws",
+             this->stats.damaged_percent, this->stats.average_percent,
+             this->stats.canvas_rects, this->stats.window_rects, this->stats.shapes_redrawn);
+    return std::string(buffer);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Inserts a rectangle in a damage list, merging it with the rectangles it
+ * overlaps or nearly touches whenever the union does not waste area. When the
+ * list grows past max_rects it collapses into a single bounding rectangle, which
+ * keeps the per-frame bookkeeping bounded on long pencil strokes.
+ */
+void Compositor::add_rect(std::vector<SDL_Rect>& rects, SDL_Rect rect) {
+    const int merge_slack = 256;
+
+    if (rect.w <= 0 || rect.h <= 0) return;
+
+    bool merged = true;
+    while (merged) {
+        merged = false;
+
+        for (size_t i = 0; i < rects.size(); ++i) {
+            SDL_Rect joined;
+            SDL_UnionRect(&rects[i], &rect, &joined);
+
+            if (Compositor::rect_area(joined) <= Compositor::rect_area(rects[i]) + Compositor::rect_area(rect) + merge_slack) {
+                rect = joined;
+                rects.erase(rects.begin() + i);
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    rects.push_back(rect);
+
+    if ((int)rects.size() > max_rects) {
+        SDL_Rect bounds = rects[0];
+        for (size_t i = 1; i < rects.size(); ++i) {
+            SDL_UnionRect(&bounds, &rects[i], &bounds);
+        }
+        rects.clear();
+        rects.push_back(bounds);
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+int Compositor::rect_area(const SDL_Rect& rect) {
+    if (rect.w <= 0 || rect.h <= 0) return 0;
+    return rect.w * rect.h;
+}
@@ -0,0 +1,183 @@
+// INCLUDES
+#include "ConicSpans.h"
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Half width of the disk x^2 + dy^2 <= radius_sq at row dy.
+ *
+ * @return Largest x >= 0 with x^2 + dy^2 <= radius_sq, or -1 if the row misses the disk.
+ */
+int ConicSpans::half_width(long long radius_sq, long long dy) {
+    const long long n = radius_sq - dy * dy;
+    if (n < 0) return -1;
+
+    // The double square root can be one off for large n; the integer checks fix it.
+    long long x = (long long)std::sqrt((double)n);
+    while (x * x > n) --x;
+    while ((x + 1) * (x + 1) <= n) ++x;
+
+    return (int)x;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Rows of the aliased filled circle.
+ *
+ * The disk x^2 + y^2 <= r^2 plus the midpoint (Bresenham) outline drawn by the
+ * aliased Primitives::draw_circle, so the fill never leaves a gap under the outline.
+ * The outline is walked once, over one octant, and only widens rows.
+ *
+ * @param spans  Output list (cleared first).
+ * @param cx, cy Center.
+ * @param radius Radius; nothing is generated for negative values.
+ */
+void ConicSpans::circle(SpanList& spans, int cx, int cy, int radius) {
+    spans.clear();
+    if (radius < 0) return;
+
+    // Half width of each row, indexed by |y - cy|.
+    static thread_local std::vector<int> half;
+    half.resize(radius + 1);
+
+    const long long radius_sq = (long long)radius * radius;
+    for (int y = 0; y <= radius; ++y) {
+        half[y] = ConicSpans::half_width(radius_sq, y);
+    }
+
+    int x = radius;
+    int y = 0;
+    int err = 0;
+
+    while (x >= y) {
+        half[y] = std::max(half[y], x);
+        half[x] = std::max(half[x], y);
+
+        y++;
+        if (err <= 0) err += 2 * y + 1;
+        if (err > 0) { x--; err -= 2 * x + 1; }
+    }
+
+    for (int dy = -radius; dy <= radius; ++dy) {
+        const int w = half[std::abs(dy)];
+        spans.add(cy + dy, cx - w, cx + w);
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Rows of the aliased filled axis-aligned ellipse.
+ *
+ * Runs the same two-region midpoint walk as Primitives::draw_bresenham_ellipse and
+ * keeps, per row, the widest x reached; every step covers [-x, x] of its row, so that
+ * is the row's whole extent.
+ *
+ * @param spans  Output list (cleared first).
+ * @param cx, cy Center.
+ * @param rx, ry Horizontal and vertical radii; nothing is generated for negative ry.
+ */
+void ConicSpans::ellipse(SpanList& spans, int cx, int cy, int rx, int ry) {
+    spans.clear();
+    if (ry < 0) return;
+
+    // Half width of each row, indexed by |y - cy| (-1: row not reached).
+    static thread_local std::vector<int> half;
+    half.assign(ry + 1, -1);
+
+    int x = 0;
+    int y = ry;
+
+    int rx2 = rx * rx;
+    int ry2 = ry * ry;
+    int twoRx2 = 2 * rx2;
+    int twoRy2 = 2 * ry2;
+
+    int px = 0;
+    int py = twoRx2 * y;
+
+    int p = (int)(ry2 - (rx2 * ry) + 0.25f * rx2);
+
+    while (px < py) {
+        half[y] = std::max(half[y], x);
+
+        x++;
+        px += twoRy2;
+
+        if (p < 0) {
+            p += ry2 + px;
+        } else {
+            y--;
+            py -= twoRx2;
+            p += ry2 + px - py;
+        }
+    }
+
+    p = (int)(ry2 * (x + 0.5f) * (x + 0.5f) + rx2 * (y - 1) * (y - 1) - rx2 * ry2);
+
+    while (y >= 0) {
+        half[y] = std::max(half[y], x);
+
+        y--;
+        py -= twoRx2;
+
+        if (p > 0) {
+            p += rx2 - py;
+        } else {
+            x++;
+            px += twoRy2;
+            p += rx2 - py + px;
+        }
+    }
+
+    for (int dy = -ry; dy <= ry; ++dy) {
+        const int w = half[std::abs(dy)];
+        if (w >= 0) spans.add(cy + dy, cx - w, cx + w);
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Rows of a filled rotated ellipse: the pixels whose centers are inside it.
+ *
+ * Same conventions as Primitives::draw_rotated_ellipse (center in pixel corner
+ * coordinates, rx along the axis rotated by angle_rad). Each row is the chord of the
+ * quadratic form A*dx^2 + 2*H*dx*dy + D*dy^2 <= 1 at the row's center.
+ *
+ * @param spans     Output list (cleared first).
+ * @param cx, cy    Center.
+ * @param rx, ry    Radii; nothing is generated unless both are positive.
+ * @param angle_rad Rotation, in radians.
+ */
+void ConicSpans::rotated_ellipse(SpanList& spans, int cx, int cy, int rx, int ry, float angle_rad) {
+    spans.clear();
+    if (rx <= 0 || ry <= 0) return;
+
+    const double c = std::cos((double)angle_rad);
+    const double s = std::sin((double)angle_rad);
+    const double irx2 = 1.0 / ((double)rx * rx);
+    const double iry2 = 1.0 / ((double)ry * ry);
+
+    const double A = c * c * irx2 + s * s * iry2;
+    const double H = c * s * (irx2 - iry2);
+    const double D = s * s * irx2 + c * c * iry2;
+    const double half_h = std::sqrt(A / (A * D - H * H));
+
+    const int y_start = (int)std::floor(cy - half_h);
+    const int y_end = (int)std::ceil(cy + half_h);
+
+    for (int y = y_start; y <= y_end; ++y) {
+        const double dy = y + 0.5 - cy;
+        const double b = H * dy;
+        const double disc = b * b - A * (D * dy * dy - 1.0);
+        if (disc < 0.0) continue;
+
+        // Pixel x is inside when its center x + 0.5 lies within the chord.
+        const double root = std::sqrt(disc);
+        const int x0 = (int)std::ceil(cx + (-b - root) / A - 0.5);
+        const int x1 = (int)std::floor(cx + (-b + root) / A - 0.5);
+        spans.add(y, x0, x1);
+    }
+}
@@ -0,0 +1,109 @@
+// INCLUDES
+#include "App.h"
+
+
+// CONSTRUCTOR IMPLEMENTATION
+/**
+ * @param color Color to blend, as a canvas pixel (premultiplied ARGB8888).
+ */
+CoverageBlender::CoverageBlender(Uint32 color) {
+    this->init(color);
+}
+
+
+// CONSTRUCTOR IMPLEMENTATION
+/**
+ * @param color Color to blend, with straight alpha.
+ */
+CoverageBlender::CoverageBlender(SDL_Color color) {
+    this->init(CanvasFormat::pack(color));
+}
+
+
+// METHOD IMPLEMENTATION
+void CoverageBlender::init(Uint32 color) {
+    const int alpha = color >> CanvasFormat::alpha_shift;
+    this->alpha_scale = alpha + (alpha >> 7);
+    this->pixel = color;
+    this->packed_rb = color & 0x00FF00FF;
+    this->packed_ag = (color >> 8) & 0x00FF00FF;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Converts a float coverage (0.0-1.0) into the 0-255 range used by the blender.
+ */
+Uint8 CoverageBlender::to_coverage(float coverage) {
+    if (coverage <= 0.0f) return 0;
+    if (coverage >= 1.0f) return 255;
+    return (Uint8)(coverage * 255.0f + 0.5f);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Blends the color over one pixel. The pointer must be inside the surface.
+ *
+ * @param pixel    Destination pixel.
+ * @param coverage Fraction of the pixel covered by the primitive (0-255).
+ */
+void CoverageBlender::blend(Uint32* pixel, Uint8 coverage) const {
+    if (coverage == 0) return;
+
+    // The premultiplied source is weighted by the coverage alone and the destination
+    // by one minus coverage times source alpha, both in the range 0-256. Rounding the
+    // second weight keeps each 16-bit lane below 65536 for every alpha.
+    const int source_weight = coverage + (coverage >> 7);
+    const int weight = (source_weight * this->alpha_scale + 128) >> 8;
+
+    if (weight >= 256) {
+        *pixel = this->pixel;
+        return;
+    }
+
+    const Uint32 destination = *pixel;
+    const Uint32 inverse = 256 - weight;
+
+    Uint32 rb = (this->packed_rb * source_weight + (destination & 0x00FF00FF) * inverse) >> 8;
+    Uint32 ag = this->packed_ag * source_weight + ((destination >> 8) & 0x00FF00FF) * inverse;
+
+    // Over an opaque pixel the exact alpha is 255; the 8-bit weights can round it to
+    // 254 for translucent sources, so opaque destinations are kept opaque.
+    const Uint32 keep_opaque = CanvasFormat::alpha_mask & (0u - (Uint32)(destination >= CanvasFormat::alpha_mask));
+
+    *pixel = (rb & 0x00FF00FF) | (ag & 0xFF00FF00) | keep_opaque;
+}
+
+
+// METHOD IMPLEMENTATION
+void CoverageBlender::blend(Uint32* pixel, float coverage) const {
+    this->blend(pixel, CoverageBlender::to_coverage(coverage));
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Blends the color over a run of pixels, one coverage value per pixel.
+ *
+ * Used by primitives that compute the coverage of a whole row first (supersampled
+ * ellipses, anti-aliased circles). The run must already be clipped to the surface.
+ *
+ * @param row      First pixel of the row.
+ * @param x0       X coordinate of the first pixel of the run.
+ * @param coverage Coverage of each pixel of the run (0-255).
+ * @param count    Number of pixels in the run.
+ */
+void CoverageBlender::blend_run(Uint32* row, int x0, const Uint8* coverage, int count) const {
+    Uint32* p = row + x0;
+
+    for (int i = 0; i < count; ++i) {
+        if (coverage[i] == 0) continue;
+
+        if (coverage[i] == 255 && this->alpha_scale == 256) {
+            p[i] = this->pixel;
+        } else {
+            this->blend(p + i, coverage[i]);
+        }
+    }
+}
@@ -0,0 +1,71 @@
+// INCLUDES
+#include "CurveFlattener.h"
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Number of line segments needed to approximate a cubic Bézier curve.
+ *
+ * Wang's formula: with n = ceil(sqrt(3 * 2 / 8 * M / tolerance)), where M is the
+ * largest second difference of the control points, no point of the curve is
+ * farther than 'tolerance' from the polyline through n + 1 uniform samples.
+ *
+ * @return Segment count, between 1 and max_segments.
+ */
+int CurveFlattener::cubic_segments(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3, float tolerance) {
+    const double ax = (double)x0 - 2.0 * x1 + x2, ay = (double)y0 - 2.0 * y1 + y2;
+    const double bx = (double)x1 - 2.0 * x2 + x3, by = (double)y1 - 2.0 * y2 + y3;
+    const double m = std::sqrt(std::max(ax * ax + ay * ay, bx * bx + by * by));
+
+    if (tolerance <= 0.0f) tolerance = default_tolerance;
+    const double n = std::ceil(std::sqrt(0.75 * m / tolerance));
+
+    return (int)std::max(1.0, std::min(n, (double)max_segments));
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Appends the polyline of a cubic Bézier curve to a buffer.
+ *
+ * The buffer is not cleared, so curves can be chained into one path: when the
+ * last point already in the buffer is the start of the curve, it is not repeated.
+ *
+ * @param polyline  Output buffer (points in the same coordinates as the curve).
+ * @param x0, y0    Start point.
+ * @param x1, y1    First control point.
+ * @param x2, y2    Second control point.
+ * @param x3, y3    End point.
+ * @param tolerance Maximum distance, in pixels, between the curve and the polyline.
+ */
+void CurveFlattener::flatten_cubic(std::vector<SDL_FPoint>& polyline, float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3, float tolerance) {
+    const int n = CurveFlattener::cubic_segments(x0, y0, x1, y1, x2, y2, x3, y3, tolerance);
+
+    if (polyline.empty() || polyline.back().x != x0 || polyline.back().y != y0) {
+        polyline.push_back({x0, y0});
+    }
+
+    // B(t) = a t^3 + b t^2 + c t + P0, and its first three forward differences for a step h.
+    const double h = 1.0 / n;
+    const double ax = -(double)x0 + 3.0 * x1 - 3.0 * x2 + x3, ay = -(double)y0 + 3.0 * y1 - 3.0 * y2 + y3;
+    const double bx = 3.0 * ((double)x0 - 2.0 * x1 + x2), by = 3.0 * ((double)y0 - 2.0 * y1 + y2);
+    const double cx = 3.0 * ((double)x1 - x0), cy = 3.0 * ((double)y1 - y0);
+
+    double px = x0, py = y0;
+    double d1x = ax * h * h * h + bx * h * h + cx * h, d1y = ay * h * h * h + by * h * h + cy * h;
+    double d2x = 6.0 * ax * h * h * h + 2.0 * bx * h * h, d2y = 6.0 * ay * h * h * h + 2.0 * by * h * h;
+    const double d3x = 6.0 * ax * h * h * h, d3y = 6.0 * ay * h * h * h;
+
+    for (int i = 1; i < n; ++i) {
+        px += d1x;
+        py += d1y;
+        d1x += d2x;
+        d1y += d2y;
+        d2x += d3x;
+        d2y += d3y;
+        polyline.push_back({(float)px, (float)py});
+    }
+
+    // The last point is exactly P3, without the error accumulated by the sums.
+    polyline.push_back({x3, y3});
+}
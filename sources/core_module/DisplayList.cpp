@@ -0,0 +1,459 @@
+// INCLUDES
+#include <cstring>
+#include "App.h"
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Removes every command and shape.
+ */
+void DisplayList::clear() {
+    this->commands.clear();
+    this->order.clear();
+    this->vertices.clear();
+    this->points.clear();
+    this->shape_ends.clear();
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Closes the current shape: the commands added since the previous call
+ * belong to it.
+ */
+void DisplayList::end_shape() {
+    this->shape_ends.push_back({this->commands.size(), this->vertices.size(), this->points.size()});
+}
+
+
+// METHOD IMPLEMENTATION
+size_t DisplayList::get_shape_count() const {
+    return this->shape_ends.size();
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Keeps the first shape_count shapes and drops the commands of the others
+ * (and anything added after the last end_shape).
+ */
+void DisplayList::truncate_shapes(size_t shape_count) {
+    if (shape_count > this->shape_ends.size()) return;
+
+    const ShapeEnd end = shape_count > 0 ? this->shape_ends[shape_count - 1] : ShapeEnd{0, 0, 0};
+    if (end.commands == this->commands.size() && shape_count == this->shape_ends.size()) return;
+
+    this->shape_ends.resize(shape_count);
+    this->commands.resize(end.commands);
+    this->vertices.resize(end.vertices);
+    this->points.resize(end.points);
+
+    // The survivors keep their relative replay order, which stays valid.
+    const Uint32 limit = (Uint32)end.commands;
+    this->order.erase(std::remove_if(this->order.begin(), this->order.end(),
+                                     [limit](Uint32 index) { return index >= limit; }),
+                      this->order.end());
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Turns the grouping of commands by kind on or off. Only commands added
+ * afterwards are affected.
+ */
+void DisplayList::set_batching(bool enabled) {
+    this->batching = enabled;
+}
+
+
+// METHOD IMPLEMENTATION
+bool DisplayList::get_batching() const {
+    return this->batching;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Appends a command and places it in the replay order.
+ *
+ * With batching on, the command goes right after the last command of the same kind
+ * among the previous batch_window ones, provided it overlaps none of the commands it
+ * skips: drawing order only matters where pixels are shared. Otherwise it goes last.
+ */
+DisplayList::Command& DisplayList::push(Op op, Uint32 color, const SDL_Rect& bounds) {
+    Command command;
+    memset(&command, 0, sizeof(command));
+    command.op = op;
+    command.color = color;
+    command.bounds = bounds;
+    this->commands.push_back(command);
+
+    size_t position = this->order.size();
+    if (this->batching) {
+        const size_t stop = position > (size_t)DisplayList::batch_window ? position - DisplayList::batch_window : 0;
+
+        for (size_t i = position; i > stop; --i) {
+            const Command& previous = this->commands[this->order[i - 1]];
+            if (previous.op == op) {
+                position = i;
+                break;
+            }
+            if (SDL_HasIntersection(&previous.bounds, &bounds)) break;
+        }
+    }
+
+    this->order.insert(this->order.begin() + position, (Uint32)(this->commands.size() - 1));
+    return this->commands.back();
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Box of the pixels containing the given 24.8 vertices, plus one pixel
+ * for the rounding of the rasterizers.
+ */
+SDL_Rect DisplayList::fixed_bounds(const FixedPoint::Vertex* vertices, size_t count) {
+    Sint32 min_x = vertices[0].x, max_x = vertices[0].x;
+    Sint32 min_y = vertices[0].y, max_y = vertices[0].y;
+
+    for (size_t i = 1; i < count; ++i) {
+        min_x = std::min(min_x, vertices[i].x);
+        max_x = std::max(max_x, vertices[i].x);
+        min_y = std::min(min_y, vertices[i].y);
+        max_y = std::max(max_y, vertices[i].y);
+    }
+
+    const int x0 = FixedPoint::floor_to_int(min_x) - 1, x1 = FixedPoint::ceil_to_int(max_x) + 1;
+    const int y0 = FixedPoint::floor_to_int(min_y) - 1, y1 = FixedPoint::ceil_to_int(max_y) + 1;
+    return {x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Box of the given points, grown by margin pixels on each side.
+ */
+SDL_Rect DisplayList::points_bounds(const SDL_FPoint* points, size_t count, float margin) {
+    float min_x = points[0].x, max_x = points[0].x;
+    float min_y = points[0].y, max_y = points[0].y;
+
+    for (size_t i = 1; i < count; ++i) {
+        min_x = std::min(min_x, points[i].x);
+        max_x = std::max(max_x, points[i].x);
+        min_y = std::min(min_y, points[i].y);
+        max_y = std::max(max_y, points[i].y);
+    }
+
+    const int x0 = (int)std::floor(min_x - margin), x1 = (int)std::ceil(max_x + margin);
+    const int y0 = (int)std::floor(min_y - margin), y1 = (int)std::ceil(max_y + margin);
+    return {x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records Primitives::draw_triangle with 24.8 vertices.
+ */
+void DisplayList::add_triangle(FixedPoint::Vertex v0, FixedPoint::Vertex v1, FixedPoint::Vertex v2, Uint32 color) {
+    const FixedPoint::Vertex v[3] = {v0, v1, v2};
+    Command& command = this->push(Op::FILL_TRIANGLE, color, DisplayList::fixed_bounds(v, 3));
+
+    for (int i = 0; i < 3; ++i) {
+        command.p[2 * i] = v[i].x;
+        command.p[2 * i + 1] = v[i].y;
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records Primitives::draw_rectangle with 24.8 vertices.
+ */
+void DisplayList::add_rectangle(FixedPoint::Vertex v0, FixedPoint::Vertex v1, FixedPoint::Vertex v2, FixedPoint::Vertex v3, Uint32 color) {
+    const FixedPoint::Vertex v[4] = {v0, v1, v2, v3};
+    Command& command = this->push(Op::FILL_RECTANGLE, color, DisplayList::fixed_bounds(v, 4));
+
+    for (int i = 0; i < 4; ++i) {
+        command.p[2 * i] = v[i].x;
+        command.p[2 * i + 1] = v[i].y;
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records Primitives::fill_polygon (even-odd) with 24.8 vertices.
+ */
+void DisplayList::add_polygon(const std::vector<FixedPoint::Vertex>& vertices, Uint32 color) {
+    this->add_polygon(vertices, color, FillRule::EVEN_ODD);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records Primitives::fill_polygon with 24.8 vertices, copied to the pool.
+ */
+void DisplayList::add_polygon(const std::vector<FixedPoint::Vertex>& vertices, Uint32 color, FillRule rule) {
+    if (vertices.size() < 3) return;
+
+    const Uint32 first = (Uint32)this->vertices.size();
+    this->vertices.insert(this->vertices.end(), vertices.begin(), vertices.end());
+
+    Command& command = this->push(Op::FILL_POLYGON, color, DisplayList::fixed_bounds(vertices.data(), vertices.size()));
+    command.rule = rule;
+    command.first = first;
+    command.count = (Uint32)vertices.size();
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records Primitives::draw_ellipse. The bounds use the same margin as the
+ * clip test of draw_ellipse.
+ */
+void DisplayList::add_ellipse(int cx, int cy, int rx, int ry, Uint32 color, bool anti_aliasing, bool filled) {
+    const int reach_x = rx + rx / 4 + 2, reach_y = ry + ry / 4 + 2;
+    Command& command = this->push(Op::ELLIPSE, color, {cx - reach_x, cy - reach_y, 2 * reach_x + 1, 2 * reach_y + 1});
+
+    command.p[0] = cx;
+    command.p[1] = cy;
+    command.p[2] = rx;
+    command.p[3] = ry;
+    command.anti_aliasing = anti_aliasing;
+    command.filled = filled;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records Primitives::draw_rotated_ellipse. The bounds are those of the
+ * outer ellipse scanned by the analytic rasterizer, plus a pixel.
+ */
+void DisplayList::add_rotated_ellipse(int cx, int cy, int rx, int ry, float angle_rad, Uint32 color, bool filled) {
+    if (rx <= 0 || ry <= 0) return;
+
+    const double c = std::cos((double)angle_rad), s = std::sin((double)angle_rad);
+    const double scale = std::sqrt(1.07) + 1.5 / std::min(rx, ry);
+    const int reach_x = (int)std::ceil(scale * std::sqrt(rx * rx * c * c + ry * ry * s * s)) + 1;
+    const int reach_y = (int)std::ceil(scale * std::sqrt(rx * rx * s * s + ry * ry * c * c)) + 1;
+
+    Command& command = this->push(Op::ROTATED_ELLIPSE, color, {cx - reach_x, cy - reach_y, 2 * reach_x + 1, 2 * reach_y + 1});
+    command.p[0] = cx;
+    command.p[1] = cy;
+    command.p[2] = rx;
+    command.p[3] = ry;
+    command.angle = angle_rad;
+    command.filled = filled;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records Primitives::draw_circle.
+ */
+void DisplayList::add_circle(int cx, int cy, int radius, Uint32 color, bool anti_aliasing, bool filled) {
+    const int reach = std::abs(radius) + 2;
+    Command& command = this->push(Op::CIRCLE, color, {cx - reach, cy - reach, 2 * reach + 1, 2 * reach + 1});
+
+    command.p[0] = cx;
+    command.p[1] = cy;
+    command.p[2] = radius;
+    command.anti_aliasing = anti_aliasing;
+    command.filled = filled;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records the 24.8 Primitives::draw_line.
+ */
+void DisplayList::add_line(FixedPoint::Vertex a, FixedPoint::Vertex b, Uint32 color) {
+    const FixedPoint::Vertex v[2] = {a, b};
+    Command& command = this->push(Op::FIXED_LINE, color, DisplayList::fixed_bounds(v, 2));
+
+    command.p[0] = a.x;
+    command.p[1] = a.y;
+    command.p[2] = b.x;
+    command.p[3] = b.y;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records the integer Primitives::draw_line (one pixel of margin for the
+ * anti-aliased pair of pixels).
+ */
+void DisplayList::add_line(int x1, int y1, int x2, int y2, Uint32 color, bool anti_aliasing) {
+    const int x0 = std::min(x1, x2) - 1, y0 = std::min(y1, y2) - 1;
+    Command& command = this->push(Op::LINE, color, {x0, y0, std::max(x1, x2) + 1 - x0 + 1, std::max(y1, y2) + 1 - y0 + 1});
+
+    command.p[0] = x1;
+    command.p[1] = y1;
+    command.p[2] = x2;
+    command.p[3] = y2;
+    command.anti_aliasing = anti_aliasing;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records Primitives::draw_curve: the curve is flattened here, once, and
+ * replayed as a polyline.
+ */
+void DisplayList::add_curve(int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, Uint32 color, bool anti_aliasing) {
+    const Uint32 first = (Uint32)this->points.size();
+    CurveFlattener::flatten_cubic(this->points, (float)x0, (float)y0, (float)x1, (float)y1, (float)x2, (float)y2, (float)x3, (float)y3);
+
+    const Uint32 count = (Uint32)this->points.size() - first;
+    if (count == 0) return;
+
+    // Points are rounded to pixels on replay; the extra pixel is the anti-aliasing.
+    Command& command = this->push(Op::POLYLINE, color, DisplayList::points_bounds(this->points.data() + first, count, 2.0f));
+    command.first = first;
+    command.count = count;
+    command.anti_aliasing = anti_aliasing;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records Stroker::stroke_polyline. The bounds leave room for the longest
+ * miter allowed by the style.
+ */
+void DisplayList::add_stroke(const std::vector<SDL_FPoint>& points, Uint32 color, const Stroker::Style& style, bool closed) {
+    if (points.empty() || style.width <= 0.0f) return;
+
+    const Uint32 first = (Uint32)this->points.size();
+    this->points.insert(this->points.end(), points.begin(), points.end());
+
+    const float reach = style.width * 0.5f * std::max(1.0f, style.miter_limit) + 2.0f;
+    Command& command = this->push(Op::STROKE, color, DisplayList::points_bounds(points.data(), points.size(), reach));
+    command.first = first;
+    command.count = (Uint32)points.size();
+    command.style = style;
+    command.filled = closed;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Number of commands.
+ */
+size_t DisplayList::size() const {
+    return this->order.size();
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief The command at position index of the replay order.
+ */
+const DisplayList::Command& DisplayList::get_command(size_t index) const {
+    return this->commands[this->order[index]];
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Canvas bounds of the command at position index of the replay order.
+ */
+const SDL_Rect& DisplayList::get_bounds(size_t index) const {
+    return this->commands[this->order[index]].bounds;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Replays every command whose bounds overlap the clip rectangle of the surface.
+ *
+ * @return Number of commands drawn.
+ */
+int DisplayList::execute(SDL_Surface* surface) const {
+    if (!surface) return 0;
+
+    const SDL_Rect& clip = surface->clip_rect;
+    int drawn = 0;
+
+    for (Uint32 index : this->order) {
+        const Command& command = this->commands[index];
+        if (!SDL_HasIntersection(&command.bounds, &clip)) continue;
+
+        this->run(surface, command);
+        drawn++;
+    }
+
+    return drawn;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Replays the command at position index of the replay order (TileRenderer item).
+ */
+void DisplayList::execute(SDL_Surface* surface, size_t index) const {
+    this->run(surface, this->commands[this->order[index]]);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Makes the Primitives (or Stroker) call recorded in a command.
+ */
+void DisplayList::run(SDL_Surface* surface, const Command& command) const {
+    static const char* const trace_names[] = {
+        "fill_triangle", "fill_rectangle", "fill_polygon", "ellipse", "rotated_ellipse",
+        "circle", "fixed_line", "line", "polyline", "stroke"
+    };
+
+    TRACE_SCOPE_AREA(trace_names[(int)command.op], (Sint64)command.bounds.w * command.bounds.h);
+    const Sint32* p = command.p;
+
+    // The pooled entry points take vectors; one scratch buffer per thread (TileRenderer).
+    static thread_local std::vector<FixedPoint::Vertex> polygon;
+    static thread_local std::vector<SDL_FPoint> polyline;
+
+    switch (command.op) {
+        case Op::FILL_TRIANGLE:
+            Primitives::draw_triangle(surface, {p[0], p[1]}, {p[2], p[3]}, {p[4], p[5]}, command.color);
+            break;
+
+        case Op::FILL_RECTANGLE:
+            Primitives::draw_rectangle(surface, {p[0], p[1]}, {p[2], p[3]}, {p[4], p[5]}, {p[6], p[7]}, command.color);
+            break;
+
+        case Op::FILL_POLYGON:
+            polygon.assign(this->vertices.begin() + command.first, this->vertices.begin() + command.first + command.count);
+            Primitives::fill_polygon(surface, polygon, command.color, command.rule);
+            break;
+
+        case Op::ELLIPSE:
+            Primitives::draw_ellipse(surface, p[0], p[1], p[2], p[3], command.color, command.anti_aliasing, command.filled);
+            break;
+
+        case Op::ROTATED_ELLIPSE:
+            Primitives::draw_rotated_ellipse(surface, p[0], p[1], p[2], p[3], command.angle, command.color, command.filled);
+            break;
+
+        case Op::CIRCLE:
+            Primitives::draw_circle(surface, p[0], p[1], p[2], command.color, command.anti_aliasing, command.filled);
+            break;
+
+        case Op::FIXED_LINE:
+            Primitives::draw_line(surface, FixedPoint::Vertex{p[0], p[1]}, FixedPoint::Vertex{p[2], p[3]}, command.color);
+            break;
+
+        case Op::LINE:
+            Primitives::draw_line(surface, p[0], p[1], p[2], p[3], command.color, command.anti_aliasing);
+            break;
+
+        case Op::POLYLINE:
+            polyline.assign(this->points.begin() + command.first, this->points.begin() + command.first + command.count);
+            Primitives::draw_polyline(surface, polyline, command.color, command.anti_aliasing);
+            break;
+
+        case Op::STROKE:
+            polyline.assign(this->points.begin() + command.first, this->points.begin() + command.first + command.count);
+            Stroker::stroke_polyline(surface, polyline, command.color, command.style, command.filled);
+            break;
+    }
+}
@@ -29,21 +29,20 @@ static std::vector<std::string> split(const std::string& s, char delimiter) {
 }
 
 // Converte um nome de cor para Uint32 usando seu sistema.
-static Uint32 color_from_string(const std::string& color_name, SDL_Surface* surface) {
+static Uint32 color_from_string(const std::string& color_name) {
     std::string lower_name = color_name;
     std::for_each(lower_name.begin(), lower_name.end(), [](char & c) {
         c = ::tolower(c);
     });
     // Esta funo auxiliar simplifica a chamada.
-    return Colors::get_color(surface, Colors::drawing_colors_table, Colors::number_of_drawing_colors, lower_name);
+    return Colors::get_canvas_color(Colors::drawing_colors_table, Colors::number_of_drawing_colors, lower_name);
 }
 
 // Cria um Shape com base nos atributos lidos do arquivo
 static void create_and_add_shape(
     const std::string& shape_type,
     const std::map<std::string, std::vector<std::string>>& attributes,
-    std::vector<std::unique_ptr<Shape>>& shapes,
-    SDL_Surface* surface)
+    std::vector<std::unique_ptr<Shape>>& shapes)
 {
     try {
         // Atributos comuns
@@ -63,20 +62,20 @@ static void create_and_add_shape(
 
         if (shape_type == "Casa") {
             new_shape = std::make_unique<House>(largura, altura, loc_x, loc_y,
-                color_from_string(attributes.at("CorParede").at(0), surface),
-                color_from_string(attributes.at("CorPorta").at(0), surface),
-                color_from_string(attributes.at("CorTelhado").at(0), surface)
+                color_from_string(attributes.at("CorParede").at(0)),
+                color_from_string(attributes.at("CorPorta").at(0)),
+                color_from_string(attributes.at("CorTelhado").at(0))
             );
         } else if (shape_type == "Arvore") {
-            Uint32 cor_frutos = color_from_string("red", surface); // Valor padro
+            Uint32 cor_frutos = color_from_string("red"); // Valor padro
             new_shape = std::make_unique<Tree>(largura, altura, loc_x, loc_y,
-                color_from_string(attributes.at("CorTronco").at(0), surface),
-                color_from_string(attributes.at("CorFolhas").at(0), surface),
+                color_from_string(attributes.at("CorTronco").at(0)),
+                color_from_string(attributes.at("CorFolhas").at(0)),
                 cor_frutos
             );
         } else if (shape_type == "Cerca" || shape_type == "Sol") {
             // Lgica unificada para Cerca e Sol que usam um atributo "Cor" simples
-            Uint32 cor_unica = color_from_string(attributes.at("Cor").at(0), surface);
+            Uint32 cor_unica = color_from_string(attributes.at("Cor").at(0));
             if (shape_type == "Cerca") {
                 new_shape = std::make_unique<Fence>(largura, altura, loc_x, loc_y, cor_unica, cor_unica);
             } else { // Sol
@@ -101,7 +100,6 @@ static void create_and_add_shape(
 // --- IMPLEMENTAO DO MTODO PRINCIPAL ---
 bool FileManager::load_scene(
     const std::string& file_path,
-    SDL_Surface* target_surface,
     std::vector<std::unique_ptr<Shape>>& shapes,
     int* out_width,
     int* out_height,
@@ -109,6 +107,7 @@ bool FileManager::load_scene(
     int* out_universe_h,
     Uint32* out_bg_color)
 {
+    TRACE_SCOPE("load_scene");
     std::ifstream file(file_path);
     if (!file.is_open()) {
         std::cerr << "Erro: Nao foi possivel abrir o arquivo: " << file_path << std::endl;
@@ -132,7 +131,7 @@ bool FileManager::load_scene(
         if (key == "Tela" || key == "Casa" || key == "Arvore" || key == "Cerca" || key == "Sol") {
             // Se j estvamos lendo um bloco, processa ele antes de comear o novo.
             if (!current_block_type.empty() && current_block_type != "Tela") {
-                create_and_add_shape(current_block_type, current_attributes, shapes, target_surface);
+                create_and_add_shape(current_block_type, current_attributes, shapes);
             }
             // Inicia o novo bloco
             current_block_type = key;
@@ -147,7 +146,7 @@ bool FileManager::load_scene(
                 } else if (key == "Metros" && tokens.size() >= 3) {
                     *out_universe_w = std::stoi(tokens[1]); *out_universe_h = std::stoi(tokens[2]);
                 } else if (key == "Cor" && tokens.size() >= 2) {
-                    *out_bg_color = color_from_string(tokens[1], target_surface);
+                    *out_bg_color = color_from_string(tokens[1]);
                 }
             } else {
                 // Armazena o atributo para o Shape atual
@@ -158,7 +157,7 @@ bool FileManager::load_scene(
 
     // Adiciona o ltimo shape do arquivo.
     if (!current_block_type.empty() && current_block_type != "Tela") {
-        create_and_add_shape(current_block_type, current_attributes, shapes, target_surface);
+        create_and_add_shape(current_block_type, current_attributes, shapes);
     }
 
     file.close();
@@ -0,0 +1,60 @@
+// INCLUDES
+#include "App.h"
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Nearest fixed-point value (ties go up). Scaling by 256 is exact in binary
+ * floating point, so the only rounding is this one, identical everywhere.
+ */
+Sint32 FixedPoint::from_double(double value) {
+    const double scaled = std::floor(value * FixedPoint::one + 0.5);
+    if (!(scaled > -FixedPoint::max_magnitude)) return -FixedPoint::max_magnitude;
+    if (scaled > FixedPoint::max_magnitude) return FixedPoint::max_magnitude;
+    return (Sint32)scaled;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Left edge of pixel column (or row) value.
+ */
+Sint32 FixedPoint::from_int(int value) {
+    const int limit = FixedPoint::max_magnitude / FixedPoint::one;
+    return (Sint32)Utils::clampi(value, -limit, limit) * FixedPoint::one;
+}
+
+
+// METHOD IMPLEMENTATION
+FixedPoint::Vertex FixedPoint::vertex(double x, double y) {
+    return { FixedPoint::from_double(x), FixedPoint::from_double(y) };
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Pixel that contains the coordinate.
+ */
+int FixedPoint::floor_to_int(Sint32 value) {
+    // Right shifts of negative values are implementation-defined before C++20.
+    return value >= 0 ? (int)(value >> FixedPoint::fraction_bits)
+                      : -(int)((-value + FixedPoint::one - 1) >> FixedPoint::fraction_bits);
+}
+
+
+// METHOD IMPLEMENTATION
+int FixedPoint::ceil_to_int(Sint32 value) {
+    return -FixedPoint::floor_to_int(-value);
+}
+
+
+// METHOD IMPLEMENTATION
+int FixedPoint::round_to_int(Sint32 value) {
+    return FixedPoint::floor_to_int(value + FixedPoint::half);
+}
+
+
+// METHOD IMPLEMENTATION
+float FixedPoint::to_float(Sint32 value) {
+    return (float)value / (float)FixedPoint::one;
+}
@@ -80,6 +80,9 @@ bool FontManager::load_fonts() {
  * dangling references.
  */
 void FontManager::close_fonts() {
+    // The atlases keep the font pointers.
+    GlyphAtlas::clear();
+
     if (libertinus_regular_36) {
         TTF_CloseFont(libertinus_regular_36);
         libertinus_regular_36 = nullptr;
@@ -0,0 +1,171 @@
+// INCLUDES
+#include "App.h"
+
+#ifdef BRUSHY_PROFILER
+
+
+// ATTRIBUTE INITIALIZATION
+FrameProfiler::History FrameProfiler::histories[(int)FrameProfiler::Stage::COUNT];
+bool FrameProfiler::hud_visible = false;
+
+
+// CONSTRUCTOR IMPLEMENTATION
+FrameProfiler::Scope::Scope(Stage stage) {
+    this->stage = stage;
+    this->start = SDL_GetPerformanceCounter();
+}
+
+
+// DESTRUCTOR IMPLEMENTATION
+FrameProfiler::Scope::~Scope() {
+    FrameProfiler::add(this->stage, SDL_GetPerformanceCounter() - this->start);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Adds performance counter ticks to a stage of the current frame.
+ */
+void FrameProfiler::add(Stage stage, Uint64 ticks) {
+    History& history = FrameProfiler::histories[(int)stage];
+    history.frame_ticks += ticks;
+    history.ran = true;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Stores the time of every stage that ran in the frame and starts the next
+ * one. Stages that did not run leave no sample, so they do not pull the minimum
+ * down to zero.
+ */
+void FrameProfiler::end_frame() {
+    const double ms_per_tick = 1000.0 / (double)SDL_GetPerformanceFrequency();
+
+    for (History& history : FrameProfiler::histories) {
+        if (!history.ran) continue;
+
+        history.samples[history.index] = (float)(history.frame_ticks * ms_per_tick);
+        history.index = (history.index + 1) % FrameProfiler::history_size;
+        history.count = std::min(history.count + 1, FrameProfiler::history_size);
+        history.frame_ticks = 0;
+        history.ran = false;
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Minimum, average and 99th percentile of a stage over the kept frames.
+ */
+FrameProfiler::Stats FrameProfiler::get_stats(Stage stage) {
+    const History& history = FrameProfiler::histories[(int)stage];
+    Stats stats = {0.0f, 0.0f, 0.0f, history.count};
+    if (history.count == 0) return stats;
+
+    float sorted[FrameProfiler::history_size];
+    float sum = 0.0f;
+
+    for (int i = 0; i < history.count; ++i) {
+        sorted[i] = history.samples[i];
+        sum += sorted[i];
+    }
+
+    // Nearest-rank percentile.
+    const int rank = std::max(0, (int)std::ceil(0.99f * history.count) - 1);
+    std::nth_element(sorted, sorted + rank, sorted + history.count);
+
+    stats.min_ms = *std::min_element(sorted, sorted + history.count);
+    stats.avg_ms = sum / history.count;
+    stats.p99_ms = sorted[rank];
+    return stats;
+}
+
+
+// METHOD IMPLEMENTATION
+const char* FrameProfiler::get_name(Stage stage) {
+    static const char* const names[(int)Stage::COUNT] = {
+        "frame", "events", "notifications", "display list", "clear", "lines",
+        "shapes", "tiles", "paint layer", "blit", "interface", "present"
+    };
+
+    return names[(int)stage];
+}
+
+
+// METHOD IMPLEMENTATION
+void FrameProfiler::toggle_hud() {
+    FrameProfiler::hud_visible = !FrameProfiler::hud_visible;
+}
+
+
+// METHOD IMPLEMENTATION
+bool FrameProfiler::get_hud_visible() {
+    return FrameProfiler::hud_visible;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Window area covered by the HUD when drawn with its top-left corner at (x, y).
+ */
+SDL_Rect FrameProfiler::get_hud_rect(int x, int y) {
+    TTF_Font* font = FontManager::roboto_regular_15;
+    int name_w = 0, number_w = 0, line_h = 0;
+    GlyphAtlas::size_text(font, "notifications", &name_w, &line_h);
+    GlyphAtlas::size_text(font, "000.00", &number_w, nullptr);
+
+    const int padding = 8, gap = 12;
+    return { x, y, 2 * padding + name_w + 3 * (gap + number_w), 2 * padding + ((int)Stage::COUNT + 1) * line_h };
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Draws the statistics table (milliseconds per frame) over a translucent panel.
+ */
+void FrameProfiler::draw_hud(SDL_Surface* surface, int x, int y) {
+    TTF_Font* font = FontManager::roboto_regular_15;
+    if (!surface || !font) return;
+
+    int name_w = 0, number_w = 0, line_h = 0;
+    GlyphAtlas::size_text(font, "notifications", &name_w, &line_h);
+    GlyphAtlas::size_text(font, "000.00", &number_w, nullptr);
+
+    const int padding = 8, gap = 12;
+    const SDL_Color panel = {0, 0, 0, 170};
+    const SDL_Color header = {160, 200, 255, 255};
+    const SDL_Color text = {255, 255, 255, 255};
+
+    Primitives::draw_rounded_rect(surface, FrameProfiler::get_hud_rect(x, y), 6, panel);
+
+    const int column_x[4] = {
+        x + padding,
+        x + padding + name_w + gap,
+        x + padding + name_w + 2 * gap + number_w,
+        x + padding + name_w + 3 * gap + 2 * number_w
+    };
+
+    int row_y = y + padding;
+    Primitives::draw_text(surface, font, "ms", column_x[0], row_y, header);
+    Primitives::draw_text(surface, font, "min", column_x[1], row_y, header);
+    Primitives::draw_text(surface, font, "avg", column_x[2], row_y, header);
+    Primitives::draw_text(surface, font, "p99", column_x[3], row_y, header);
+
+    for (int i = 0; i < (int)Stage::COUNT; ++i) {
+        const Stats stats = FrameProfiler::get_stats((Stage)i);
+        const float values[3] = {stats.min_ms, stats.avg_ms, stats.p99_ms};
+        row_y += line_h;
+
+        Primitives::draw_text(surface, font, FrameProfiler::get_name((Stage)i), column_x[0], row_y, text);
+        if (stats.samples == 0) continue;
+
+        for (int k = 0; k < 3; ++k) {
+            char value[16];
+            snprintf(value, sizeof(value), "%.2f", values[k]);
+            Primitives::draw_text(surface, font, value, column_x[k + 1], row_y, text);
+        }
+    }
+}
+
+#endif
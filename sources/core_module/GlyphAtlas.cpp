@@ -0,0 +1,277 @@
+// INCLUDES
+#include <cstring>
+#include "App.h"
+
+
+// ATTRIBUTE INITIALIZATION
+std::unordered_map<TTF_Font*, std::unique_ptr<GlyphAtlas::Atlas>> GlyphAtlas::atlases;
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Draws a UTF-8 string with the top-left corner of its line box at (x, y).
+ *
+ * Surfaces whose layout PixelFormat does not handle fall back to SDL_ttf rendering.
+ *
+ * @param target Destination surface (clipped to its clip rectangle).
+ * @param font   Font of the text.
+ * @param text   UTF-8 text; bytes that are not valid UTF-8 are read as Latin-1.
+ * @param x      Left edge of the text.
+ * @param y      Top of the text line.
+ * @param color  Straight-alpha text color.
+ */
+void GlyphAtlas::draw_text(SDL_Surface* target, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
+    if (!target || !font || text.empty()) return;
+
+    if (PixelFormat::layout_of(target) == PixelFormat::Layout::UNSUPPORTED) {
+        SDL_Surface* text_surface = TTF_RenderUTF8_Blended(font, text.c_str(), color);
+        if (!text_surface) return;
+
+        SDL_Rect dest = {x, y, text_surface->w, text_surface->h};
+        SDL_BlitSurface(text_surface, nullptr, target, &dest);
+        SDL_FreeSurface(text_surface);
+        return;
+    }
+
+    Atlas& atlas = GlyphAtlas::atlas_for(font);
+    const Run& run = GlyphAtlas::run_for(atlas, text);
+    const Uint8* pixels = atlas.pixels.data();
+
+    PixelFormat::dispatch(target, CanvasFormat::pack(color), [&](const auto& out) {
+        const SDL_Rect& clip = out.clip;
+
+        for (const Placement& placement : run.glyphs) {
+            const Glyph& glyph = *placement.glyph;
+            const int gx = x + placement.x, gy = y + placement.y;
+
+            const int x0 = std::max(gx, clip.x), x1 = std::min(gx + glyph.w, clip.x + clip.w);
+            const int y0 = std::max(gy, clip.y), y1 = std::min(gy + glyph.h, clip.y + clip.h);
+            if (x0 >= x1 || y0 >= y1) continue;
+
+            for (int row = y0; row < y1; ++row) {
+                const Uint8* coverage = pixels + (glyph.atlas_y + row - gy) * GlyphAtlas::atlas_width + glyph.atlas_x + (x0 - gx);
+                out.blend_run(row, x0, coverage, x1 - x0);
+            }
+        }
+    });
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Size of the line box of a string, from the cached layout.
+ *
+ * @return false (and 0 x 0) without a font.
+ */
+bool GlyphAtlas::size_text(TTF_Font* font, const std::string& text, int* width, int* height) {
+    int w = 0, h = 0;
+
+    if (font) {
+        const Run& run = GlyphAtlas::run_for(GlyphAtlas::atlas_for(font), text);
+        w = run.width;
+        h = run.height;
+    }
+
+    if (width) *width = w;
+    if (height) *height = h;
+    return font != nullptr;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Frees every atlas and cached run.
+ */
+void GlyphAtlas::clear() {
+    GlyphAtlas::atlases.clear();
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Returns the atlas of a font, creating an empty one on first use.
+ */
+GlyphAtlas::Atlas& GlyphAtlas::atlas_for(TTF_Font* font) {
+    std::unique_ptr<Atlas>& atlas = GlyphAtlas::atlases[font];
+
+    if (!atlas) {
+        atlas.reset(new Atlas());
+        atlas->font = font;
+        atlas->height = 0;
+        atlas->shelf_x = atlas->shelf_y = atlas->shelf_h = 0;
+        for (Glyph& glyph : atlas->latin1) glyph.loaded = false;
+    }
+
+    return *atlas;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Returns a glyph of the atlas, rasterizing it on first use.
+ *
+ * The glyph is rendered in white by SDL_ttf, so its alpha is the coverage, and only
+ * the box of non-zero coverage is packed into the atlas (shelves of atlas_width
+ * pixels; the atlas grows downwards). A single-glyph surface has the pen at
+ * (max(0, -minx), max(0, maxy - ascent)) from its top-left corner, as SDL_ttf lays
+ * out a line. Glyphs missing from the font keep zero size and advance.
+ */
+const GlyphAtlas::Glyph& GlyphAtlas::glyph_for(Atlas& atlas, Uint32 codepoint) {
+    Glyph& glyph = codepoint < 256 ? atlas.latin1[codepoint] : atlas.others[codepoint];
+    if (glyph.loaded) return glyph;
+
+    memset(&glyph, 0, sizeof(glyph));
+    glyph.loaded = true;
+
+    int minx = 0, maxx = 0, miny = 0, maxy = 0, advance = 0;
+    if (TTF_GlyphMetrics32(atlas.font, codepoint, &minx, &maxx, &miny, &maxy, &advance) != 0) return glyph;
+    glyph.advance = advance;
+
+    const SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface* surface = TTF_RenderGlyph32_Blended(atlas.font, codepoint, white);
+    if (!surface) return glyph;     // Blank glyphs (spaces) may have no surface.
+
+    if (surface->format->BytesPerPixel != 4) {
+        SDL_FreeSurface(surface);
+        return glyph;
+    }
+
+    // Box of the pixels with coverage.
+    const Uint32 alpha_mask = surface->format->Amask;
+    const int alpha_shift = surface->format->Ashift;
+    int bx0 = surface->w, by0 = surface->h, bx1 = -1, by1 = -1;
+
+    for (int y = 0; y < surface->h; ++y) {
+        const Uint32* row = (const Uint32*)((const Uint8*)surface->pixels + y * surface->pitch);
+        for (int x = 0; x < surface->w; ++x) {
+            if (!(row[x] & alpha_mask)) continue;
+            bx0 = std::min(bx0, x);
+            bx1 = std::max(bx1, x);
+            by0 = std::min(by0, y);
+            by1 = std::max(by1, y);
+        }
+    }
+
+    if (bx1 >= 0) {
+        glyph.w = std::min(bx1 - bx0 + 1, (int)GlyphAtlas::atlas_width);
+        glyph.h = by1 - by0 + 1;
+        glyph.offset_x = bx0 - std::max(0, -minx);
+        glyph.offset_y = by0 - std::max(0, maxy - TTF_FontAscent(atlas.font));
+
+        // Next shelf when the row is full; grow the atlas when the shelf does not fit.
+        if (atlas.shelf_x + glyph.w > GlyphAtlas::atlas_width) {
+            atlas.shelf_y += atlas.shelf_h;
+            atlas.shelf_x = 0;
+            atlas.shelf_h = 0;
+        }
+
+        if (atlas.shelf_y + glyph.h > atlas.height) {
+            atlas.height = std::max(std::max(atlas.height * 2, 64), atlas.shelf_y + glyph.h);
+            atlas.pixels.resize((size_t)GlyphAtlas::atlas_width * atlas.height, 0);
+        }
+
+        glyph.atlas_x = atlas.shelf_x;
+        glyph.atlas_y = atlas.shelf_y;
+        atlas.shelf_x += glyph.w;
+        atlas.shelf_h = std::max(atlas.shelf_h, glyph.h);
+
+        for (int y = 0; y < glyph.h; ++y) {
+            const Uint32* src = (const Uint32*)((const Uint8*)surface->pixels + (by0 + y) * surface->pitch) + bx0;
+            Uint8* dst = atlas.pixels.data() + (size_t)(glyph.atlas_y + y) * GlyphAtlas::atlas_width + glyph.atlas_x;
+            for (int x = 0; x < glyph.w; ++x) {
+                dst[x] = (Uint8)((src[x] & alpha_mask) >> alpha_shift);
+            }
+        }
+    }
+
+    SDL_FreeSurface(surface);
+    return glyph;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Returns the cached layout of a string, laying it out on first use.
+ *
+ * Pen positions add the glyph advances and the kerning of each pair. The line is
+ * shifted right (or down) when a glyph overhangs the start of the line (or the
+ * ascent), as SDL_ttf does.
+ */
+const GlyphAtlas::Run& GlyphAtlas::run_for(Atlas& atlas, const std::string& text) {
+    auto found = atlas.runs.find(text);
+    if (found != atlas.runs.end()) return found->second;
+
+    if (atlas.runs.size() >= GlyphAtlas::max_runs) atlas.runs.clear();
+
+    Run& run = atlas.runs[text];
+    int pen = 0, min_x = 0, min_y = 0, max_x = 0;
+    Uint32 previous = 0;
+    size_t index = 0;
+
+    while (index < text.size()) {
+        const Uint32 codepoint = GlyphAtlas::next_codepoint(text, &index);
+        if (previous) pen += TTF_GetFontKerningSizeGlyphs32(atlas.font, previous, codepoint);
+
+        const Glyph& glyph = GlyphAtlas::glyph_for(atlas, codepoint);
+        if (glyph.w > 0) {
+            run.glyphs.push_back({&glyph, pen + glyph.offset_x, glyph.offset_y});
+            min_x = std::min(min_x, pen + glyph.offset_x);
+            min_y = std::min(min_y, glyph.offset_y);
+            max_x = std::max(max_x, pen + glyph.offset_x + glyph.w);
+        }
+
+        pen += glyph.advance;
+        previous = codepoint;
+    }
+
+    for (Placement& placement : run.glyphs) {
+        placement.x -= min_x;
+        placement.y -= min_y;
+    }
+
+    run.width = std::max(pen, max_x) - min_x;
+    run.height = TTF_FontHeight(atlas.font) - min_y;
+    return run;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Decodes the code point at *index and advances past it. A byte that does
+ * not start a valid UTF-8 sequence is taken as a Latin-1 character.
+ */
+Uint32 GlyphAtlas::next_codepoint(const std::string& text, size_t* index) {
+    const Uint8* s = (const Uint8*)text.data();
+    const size_t size = text.size();
+    const size_t i = *index;
+    const Uint8 lead = s[i];
+
+    int length = 0;
+    Uint32 codepoint = 0;
+    if (lead >= 0xF0 && lead < 0xF5) {
+        length = 4;
+        codepoint = lead & 0x07;
+    } else if (lead >= 0xE0) {
+        length = lead < 0xF0 ? 3 : 0;
+        codepoint = lead & 0x0F;
+    } else if (lead >= 0xC2) {
+        length = 2;
+        codepoint = lead & 0x1F;
+    }
+
+    if (length > 0 && i + length <= size) {
+        bool valid = true;
+        for (int k = 1; k < length && valid; ++k) {
+            valid = (s[i + k] & 0xC0) == 0x80;
+            codepoint = (codepoint << 6) | (s[i + k] & 0x3F);
+        }
+
+        if (valid) {
+            *index = i + length;
+            return codepoint;
+        }
+    }
+
+    *index = i + 1;
+    return lead;
+}
@@ -2,7 +2,12 @@
 
 
 NotificationManager::NotificationManager(int w, int h)
-    : window_width_(w), window_height_(h), has_current_(false) {}
+    : window_width_(w), window_height_(h), has_current_(false) {
+    had_current_ = false;
+    last_rect_ = {0, 0, 0, 0};
+    has_damage_ = false;
+    damage_ = {0, 0, 0, 0};
+}
 
 NotificationManager::~NotificationManager() {
     // nada para liberar, pois usamos valores (não ponteiros dinâmicos)
@@ -27,6 +32,55 @@ void NotificationManager::update() {
     }
 
     update_current();
+
+    // Reporta a area antiga e a nova enquanto a notificacao se move ou aparece/some.
+    SDL_Rect current_rect = {current_.rect.x, static_cast<int>(current_.pos_y), current_.rect.w, current_.rect.h};
+    bool animating = has_current_ && (current_.appearing || current_.disappearing);
+
+    if (animating || has_current_ != had_current_) {
+        if (had_current_) add_damage(last_rect_);
+        if (has_current_) add_damage(current_rect);
+    }
+
+    had_current_ = has_current_;
+    last_rect_ = current_rect;
+}
+
+
+/**
+ * @brief Returns (and clears) the window area changed by the notifications
+ * since the last call. Returns false when nothing changed.
+ */
+bool NotificationManager::take_damage(SDL_Rect* rect) {
+    if (!has_damage_) return false;
+
+    if (rect) *rect = damage_;
+    has_damage_ = false;
+    return true;
+}
+
+
+/**
+ * @brief Milliseconds until the notifications need another update: 0 while one
+ * is animating (or waiting in the queue), the time left before the current one
+ * closes itself, or -1 when there is nothing to show.
+ */
+int NotificationManager::get_wait_timeout() const {
+    if (!has_current_) return queue_.empty() ? -1 : 0;
+    if (current_.appearing || current_.disappearing) return 0;
+
+    Uint32 elapsed = SDL_GetTicks() - current_.start_time;
+    return elapsed > current_.duration_ms ? 0 : static_cast<int>(current_.duration_ms - elapsed) + 1;
+}
+
+
+void NotificationManager::add_damage(const SDL_Rect& rect) {
+    if (!has_damage_) {
+        damage_ = rect;
+        has_damage_ = true;
+    } else {
+        SDL_UnionRect(&damage_, &rect, &damage_);
+    }
 }
 
 void NotificationManager::update_current() {
@@ -91,116 +145,6 @@ void NotificationManager::handle_event(SDL_Event* e) {
 }
 
 
-void NotificationManager::draw_rounded_rect_surface(SDL_Surface* surface, int x, int y, int w, int h, SDL_Color color, int radius, bool filled) {
-    if (!surface) return;
-
-    // Fator de supersampling
-    const int scale = 3;
-    int sw = w * scale;
-    int sh = h * scale;
-    int sradius = radius * scale;
-
-    // Cria surface temporária grande
-    SDL_Surface* tmp_large = SDL_CreateRGBSurface(0, sw, sh, 32,
-                                                  0x00FF0000,
-                                                  0x0000FF00,
-                                                  0x000000FF,
-                                                  0xFF000000);
-    if (!tmp_large) return;
-
-    SDL_SetSurfaceBlendMode(tmp_large, SDL_BLENDMODE_BLEND);
-    SDL_FillRect(tmp_large, NULL, SDL_MapRGBA(tmp_large->format, 0, 0, 0, 0));
-
-    Uint32 px_color = SDL_MapRGBA(tmp_large->format, color.r, color.g, color.b, color.a);
-
-    // Desenha retângulo com cantos arredondados na surface grande
-    for (int py = 0; py < sh; py++) {
-        for (int px = 0; px < sw; px++) {
-            // Distância mínima para os cantos
-            int dx = (px < sradius) ? sradius - px : (px >= sw - sradius ? px - (sw - sradius - 1) : 0);
-            int dy = (py < sradius) ? sradius - py : (py >= sh - sradius ? py - (sh - sradius - 1) : 0);
-            float dist_sq = float(dx*dx + dy*dy);
-
-            if (dist_sq <= float(sradius*sradius)) {
-                Primitives::set_pixel(tmp_large, px, py, px_color);
-            } else if (filled && (dx == 0 || dy == 0)) {
-                // partes centrais não arredondadas
-                Primitives::set_pixel(tmp_large, px, py, px_color);
-            }
-        }
-    }
-
-    // Cria surface final com tamanho real
-    SDL_Surface* tmp_final = SDL_CreateRGBSurface(0, w, h, 32,
-                                                  0x00FF0000,
-                                                  0x0000FF00,
-                                                  0x000000FF,
-                                                  0xFF000000);
-    if (!tmp_final) {
-        SDL_FreeSurface(tmp_large);
-        return;
-    }
-    SDL_SetSurfaceBlendMode(tmp_final, SDL_BLENDMODE_BLEND);
-    SDL_FillRect(tmp_final, NULL, SDL_MapRGBA(tmp_final->format, 0, 0, 0, 0));
-
-    // Downscale: média de scale x scale pixels
-    for (int py = 0; py < h; py++) {
-        for (int px = 0; px < w; px++) {
-            int r_sum = 0, g_sum = 0, b_sum = 0, a_sum = 0;
-            for (int sy = 0; sy < scale; sy++) {
-                for (int sx = 0; sx < scale; sx++) {
-                    Uint32 col = Primitives::get_pixel(tmp_large, px*scale + sx, py*scale + sy);
-                    Uint8 r,g,b,a;
-                    SDL_GetRGBA(col, tmp_large->format, &r, &g, &b, &a);
-                    r_sum += r; g_sum += g; b_sum += b; a_sum += a;
-                }
-            }
-            Uint8 r = Uint8(r_sum / (scale*scale));
-            Uint8 g = Uint8(g_sum / (scale*scale));
-            Uint8 b = Uint8(b_sum / (scale*scale));
-            Uint8 a = Uint8(a_sum / (scale*scale));
-            Uint32 final_col = SDL_MapRGBA(tmp_final->format, r, g, b, a);
-            Primitives::set_pixel(tmp_final, px, py, final_col);
-        }
-    }
-
-    // Blit final para a surface de destino
-    SDL_Rect dest = { x, y, w, h };
-    SDL_BlitSurface(tmp_final, NULL, surface, &dest);
-
-    SDL_FreeSurface(tmp_large);
-    SDL_FreeSurface(tmp_final);
-}
-
-
-
-
-
-
-
-
-
-// Desenha retângulo com alpha em SDL_Surface
-void draw_rect_with_alpha(SDL_Surface* target, int x, int y, int w, int h, SDL_Color color) {
-    if (!target) return;
-
-    SDL_Surface* tmp = SDL_CreateRGBSurface(0, w, h, 32,
-                                            target->format->Rmask,
-                                            target->format->Gmask,
-                                            target->format->Bmask,
-                                            target->format->Amask);
-    if (!tmp) return;
-
-    SDL_FillRect(tmp, NULL, SDL_MapRGBA(tmp->format, color.r, color.g, color.b, color.a));
-    SDL_SetSurfaceBlendMode(tmp, SDL_BLENDMODE_BLEND);
-
-    SDL_Rect dest = { x, y, w, h };
-    SDL_BlitSurface(tmp, NULL, target, &dest);
-
-    SDL_FreeSurface(tmp);
-}
-
-
 /*
 void NotificationManager::draw_notification(SDL_Surface* target, Notification* n) {
     if (!n || !target) return;
@@ -230,14 +174,8 @@ void NotificationManager::draw_notification(SDL_Surface* target, const Notificat
     SDL_Color bg = {50, 50, 50, a};
 
     // Fundo arredondado da notificação
-    draw_rounded_rect_surface(target,
-                              n.rect.x,
-                              static_cast<int>(n.pos_y),
-                              n.rect.w,
-                              n.rect.h,
-                              bg,
-                              10,
-                              true);
+    SDL_Rect box = {n.rect.x, static_cast<int>(n.pos_y), n.rect.w, n.rect.h};
+    Primitives::draw_rounded_rect(target, box, 10, bg);
 
     // Botão de fechar (calculado relativo ao rect)
     SDL_Rect btn = n.close_button;
@@ -245,7 +183,7 @@ void NotificationManager::draw_notification(SDL_Surface* target, const Notificat
     btn.y = static_cast<int>(n.pos_y) + n.close_button.y;
 
     SDL_Color red = {200, 50, 50, a};
-    draw_rounded_rect_surface(target, btn.x, btn.y, btn.w, btn.h, red, 8, true);
+    Primitives::draw_rounded_rect(target, btn, 8, red);
 
     SDL_Color text_color = {255, 255, 255, a};
 
@@ -261,7 +199,11 @@ void NotificationManager::draw_notification(SDL_Surface* target, const Notificat
 
 
 void NotificationManager::draw(SDL_Surface* target) {
-    //if (!current_) return;
+    if (!has_current_ || !target) return;
+
+    // Nada a desenhar quando a notificacao esta fora da area sendo recomposta.
+    SDL_Rect bounds = {current_.rect.x, static_cast<int>(current_.pos_y), current_.rect.w, current_.rect.h};
+    if (!SDL_HasIntersection(&bounds, &target->clip_rect)) return;
     draw_notification(target, current_);
 }
 
@@ -0,0 +1,112 @@
+// INCLUDES
+#include <climits>
+#include "App.h"
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Returns the policy that matches the layout of a surface.
+ *
+ * 32-bit ARGB and XRGB surfaces share the canvas policy, 24-bit RGB24 and 16-bit
+ * RGB565 surfaces get their own, and INDEX8 needs a palette. Other 32-bit layouts
+ * with 8-bit channels (window surfaces of some drivers) go through the channel
+ * shifts of their format. Anything else is UNSUPPORTED, and the primitives skip it.
+ */
+PixelFormat::Layout PixelFormat::layout_of(const SDL_Surface* surface) {
+    if (!surface || !surface->format || !surface->pixels) return Layout::UNSUPPORTED;
+
+    switch (surface->format->format) {
+        case SDL_PIXELFORMAT_ARGB8888:
+        case SDL_PIXELFORMAT_RGB888:
+            return Layout::ARGB8888;
+        case SDL_PIXELFORMAT_RGB24:
+            return Layout::RGB888;
+        case SDL_PIXELFORMAT_RGB565:
+            return Layout::RGB565;
+        case SDL_PIXELFORMAT_INDEX8:
+            return (surface->format->palette && surface->format->palette->ncolors > 0) ? Layout::INDEXED8 : Layout::UNSUPPORTED;
+        default:
+            break;
+    }
+
+    const SDL_PixelFormat* format = surface->format;
+    if (format->BytesPerPixel == 4 && format->Rloss == 0 && format->Gloss == 0 && format->Bloss == 0 &&
+        (format->Amask == 0 || format->Aloss == 0)) {
+        return Layout::MASKED32;
+    }
+
+    return Layout::UNSUPPORTED;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Finds the palette entry closest to a canvas color (squared RGB distance).
+ *
+ * Called once per draw call, when the Indexed8 writer is built.
+ */
+Uint8 PixelFormat::nearest_index(Uint32 color, const SDL_Palette* palette) {
+    const SDL_Color target = CanvasFormat::unpack(color);
+    int best = 0;
+    int best_distance = INT_MAX;
+
+    for (int i = 0; i < palette->ncolors && i < 256; ++i) {
+        const SDL_Color& c = palette->colors[i];
+        const int dr = c.r - target.r, dg = c.g - target.g, db = c.b - target.b;
+        const int distance = dr * dr + dg * dg + db * db;
+
+        if (distance < best_distance) {
+            best_distance = distance;
+            best = i;
+            if (distance == 0) break;
+        }
+    }
+
+    return (Uint8)best;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Reads one pixel of a surface as a canvas color.
+ *
+ * @return The pixel (opaque for layouts without alpha), or 0 when (x, y) is outside
+ *         the surface or the layout is not supported.
+ */
+Uint32 PixelFormat::read(const SDL_Surface* surface, int x, int y) {
+    if (!surface || x < 0 || y < 0 || x >= surface->w || y >= surface->h) return 0;
+
+    const Uint8* row = (const Uint8*)surface->pixels + y * surface->pitch;
+    const SDL_PixelFormat* format = surface->format;
+
+    switch (PixelFormat::layout_of(surface)) {
+        case Layout::ARGB8888: return ARGB8888::decode(row + x * ARGB8888::bytes_per_pixel, format);
+        case Layout::RGB888:   return RGB888::decode(row + x * RGB888::bytes_per_pixel, format);
+        case Layout::RGB565:   return RGB565::decode(row + x * RGB565::bytes_per_pixel, format);
+        case Layout::INDEXED8: return Indexed8::decode(row + x * Indexed8::bytes_per_pixel, format);
+        case Layout::MASKED32: return Masked32::decode(row + x * Masked32::bytes_per_pixel, format);
+        default:               return 0;
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Writes one canvas color to a pixel of a surface, in the surface layout.
+ *
+ * For callers that write scattered single pixels; runs and shapes should build a
+ * Writer (PixelFormat::dispatch) instead. (x, y) must be inside the surface.
+ */
+void PixelFormat::write(SDL_Surface* surface, int x, int y, Uint32 color) {
+    Uint8* row = (Uint8*)surface->pixels + y * surface->pitch;
+    const SDL_PixelFormat* format = surface->format;
+
+    switch (PixelFormat::layout_of(surface)) {
+        case Layout::ARGB8888: ARGB8888::store(row + x * ARGB8888::bytes_per_pixel, ARGB8888::encode(color, format)); break;
+        case Layout::RGB888:   RGB888::store(row + x * RGB888::bytes_per_pixel, RGB888::encode(color, format)); break;
+        case Layout::RGB565:   RGB565::store(row + x * RGB565::bytes_per_pixel, RGB565::encode(color, format)); break;
+        case Layout::INDEXED8: Indexed8::store(row + x * Indexed8::bytes_per_pixel, Indexed8::encode(color, format)); break;
+        case Layout::MASKED32: Masked32::store(row + x * Masked32::bytes_per_pixel, Masked32::encode(color, format)); break;
+        case Layout::UNSUPPORTED: break;
+    }
+}
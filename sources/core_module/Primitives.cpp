@@ -1,5 +1,7 @@
-#include <stack>
+#include <climits>
+#include <cstring>
 #include <utility>
+#include <vector>
 #include "Primitives.h"
 
 
@@ -8,8 +10,8 @@
  * @brief
  * Sets the color of a specific pixel on an SDL_Surface.
  * This function writes a pixel with the given Uint32 color to the specified
- * coordinates (x, y) on the provided surface. It performs bounds checking
- * using Utils::verify_limits to prevent invalid memory access.
+ * coordinates (x, y) on the provided surface. Pixels outside the surface
+ * clip rectangle are discarded, which also prevents invalid memory access.
  *
  * @param surface
  *      Pointer to the SDL_Surface where the pixel will be set.
@@ -18,20 +20,46 @@
  * @param y
  *      Y-coordinate of the pixel.
  * @param color
- *      Uint32 value representing the color to set (in the surface's pixel format).
+ *      Canvas color (CanvasFormat), stored in the layout of the surface (see PixelFormat).
  **/
 void Primitives::set_pixel(SDL_Surface* surface, int x, int y, Uint32 color) {
     if (!surface) return;
 
-    if (x >= surface->w || y >= surface->h || x < 0 || y < 0) {
+    // The clip rectangle defaults to the whole surface; the compositor narrows it to a damaged area.
+    const SDL_Rect& clip = surface->clip_rect;
+    if (x < clip.x || y < clip.y || x >= clip.x + clip.w || y >= clip.y + clip.h) {
         // ErrorHandler::log_error("Point out of bounds.");
         return;
     }
 
+    PixelFormat::write(surface, x, y, color);
+}
+
 
-    Uint32* pixels = (Uint32*)surface->pixels;
-    int pitch = surface->pitch / 4;
-    pixels[y * pitch + x] = color;
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Fills the horizontal run of pixels from (x0, y) to (x1, y), both inclusive.
+ * The run is clipped once to the surface clip rectangle and then written by
+ * the row kernel of the surface layout (SpanWriter on canvas surfaces), so the
+ * per-pixel bounds check and address computation of set_pixel are paid once per
+ * run instead of once per pixel.
+ *
+ * @param surface
+ *      Pointer to the SDL_Surface.
+ * @param x0
+ *      X-coordinate of the first pixel of the run.
+ * @param x1
+ *      X-coordinate of the last pixel of the run. Nothing is drawn if x1 < x0.
+ * @param y
+ *      Y-coordinate of the run.
+ * @param color
+ *      Canvas color (CanvasFormat).
+ **/
+void Primitives::fill_span(SDL_Surface* surface, int x0, int x1, int y, Uint32 color) {
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        out.fill_span(x0, x1, y);
+    });
 }
 
 
@@ -40,8 +68,8 @@ void Primitives::set_pixel(SDL_Surface* surface, int x, int y, Uint32 color) {
  * @brief
  * Retrieves the color of a pixel from an SDL_Surface.
  * This function reads the pixel at coordinates (x, y) from the given surface
- * and returns it as a Uint32 value. The function handles different bytes-per-pixel
- * formats (1, 2, 3, or 4 bytes) and considers the system's endianness.
+ * and returns it as a canvas color. Canvas surfaces are read directly; the
+ * other layouts known to PixelFormat are converted.
  *
  * @param surface
  * Pointer to the SDL_Surface to read from.
@@ -53,37 +81,29 @@ void Primitives::set_pixel(SDL_Surface* surface, int x, int y, Uint32 color) {
  * Y-coordinate of the pixel.
  *
  * @return
- * Uint32 value representing the pixel color. Returns 0 if the coordinates
- * are out of bounds or if an unexpected pixel format is encountered.
+ * Uint32 value representing the pixel color (premultiplied ARGB8888).
+ * Returns 0 if the coordinates are out of bounds or the layout is not supported.
  */
 Uint32 Primitives::get_pixel(SDL_Surface* surface, int x, int y) {
     if (!Utils::verify_limits(surface, x, y)) {
         return 0;
     }
 
-    int bytes_per_pixel = surface->format->BytesPerPixel;
-    Uint8* p = (Uint8*)surface->pixels + y * surface->pitch + x * bytes_per_pixel;
-
-    if (bytes_per_pixel == 1) {
-        return *p;
+    return PixelFormat::read(surface, x, y);
+}
 
-    } else if (bytes_per_pixel == 2) {
-        return *(Uint16*)p;
 
-    } else if (bytes_per_pixel == 3) {
-        if (SDL_BYTEORDER == SDL_BIG_ENDIAN) {
-            return (p[0] << 16) | (p[1] << 8) | p[2];
-        } else {
-            return p[0] | (p[1] << 8) | (p[2] << 16);
-        }
+// Rejeição trivial: retorna true se a caixa [x0, x1] x [y0, y1] não toca o clip da superfície.
+static inline bool outside_clip(const SDL_Rect& clip, int x0, int y0, int x1, int y1) {
+    return x1 < clip.x || y1 < clip.y || x0 >= clip.x + clip.w || y0 >= clip.y + clip.h;
+}
 
-    } else if (bytes_per_pixel == 4) {
-        return *(Uint32*)p;
 
-    } else {
-        // Unexpected pixel format, return 0. // TODO: Implementar função de erro.
-        return 0;
-    }
+// Divisão inteira arredondada para baixo (a / b em C++ trunca em direção a zero).
+static inline long long floor_div(long long a, long long b) {
+    long long q = a / b;
+    if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+    return q;
 }
 
 
@@ -92,7 +112,8 @@ Uint32 Primitives::get_pixel(SDL_Surface* surface, int x, int y) {
  * @brief Blends a color with the background pixel on the surface.
  *
  * This function blends the given line color with the background pixel
- * at (px, py) using the provided intensity for Xiaolin Wu's antialiasing.
+ * at (px, py) using the provided intensity. Primitives that blend many
+ * pixels of one color should create a CoverageBlender once instead.
  *
  * @param surface Pointer to the SDL_Surface.
  * @param px X-coordinate of the pixel.
@@ -103,23 +124,15 @@ Uint32 Primitives::get_pixel(SDL_Surface* surface, int x, int y) {
 void Primitives::blend_pixel(SDL_Surface* surface, int px, int py, SDL_Color line_color, float intensity) {
     //if (!Utils::verify_limits(surface, px, py)) return;
 
-    if (px >= surface->w || py >= surface->h || px < 0 || py < 0) {
+    const SDL_Rect& clip = surface->clip_rect;
+    if (px < clip.x || py < clip.y || px >= clip.x + clip.w || py >= clip.y + clip.h) {
         // ErrorHandler::log_error("Point out of bounds.");
         return;
     }
 
-    Uint32 bgPixel = Primitives::get_pixel(surface, px, py);
-    SDL_Color bgColor;
-    SDL_GetRGBA(bgPixel, surface->format, &bgColor.r, &bgColor.g, &bgColor.b, &bgColor.a);
-
-    float alpha = intensity * (line_color.a / 255.0f);
-
-    Uint8 r = Uint8(bgColor.r * (1 - alpha) + line_color.r * alpha);
-    Uint8 g = Uint8(bgColor.g * (1 - alpha) + line_color.g * alpha);
-    Uint8 b = Uint8(bgColor.b * (1 - alpha) + line_color.b * alpha);
-    Uint8 a = 255;
-
-    Primitives::set_pixel(surface, px, py, SDL_MapRGBA(surface->format, r, g, b, a));
+    PixelFormat::dispatch(surface, CanvasFormat::pack(line_color), [&](const auto& out) {
+        out.blend(out.at(px, py), intensity);
+    });
 }
 
 
@@ -138,29 +151,137 @@ void Primitives::blend_pixel(SDL_Surface* surface, int px, int py, SDL_Color lin
  * @param y1            Y coordinate of the first point.
  * @param x2            X coordinate of the second point.
  * @param y2            Y coordinate of the second point.
- * @param color         Pixel color (mapped to the surface format).
+ * @param color         Canvas color (CanvasFormat).
  * @param anti_aliasing If true, draw the line with anti-aliasing; otherwise, use a sharp edge.
  */
 void Primitives::draw_line(SDL_Surface* surface, int x1, int y1, int x2, int y2, Uint32 color, bool anti_aliasing){
-    if (Utils::verify_limits(surface, x1, y1) == 0) return;
-    if (Utils::verify_limits(surface, x2, y2) == 0) return;
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        Primitives::draw_line(out, x1, y1, x2, y2, anti_aliasing);
+    });
+}
+
+
+// Núcleo de draw_line para um formato de pixel (ver PixelFormat).
+template <class Format>
+void Primitives::draw_line(const PixelFormat::Writer<Format>& out, int x1, int y1, int x2, int y2, bool anti_aliasing) {
+    // Segmentos fora do clip não custam nada; os demais são recortados por cada rasterizador.
+    if (outside_clip(out.clip, std::min(x1, x2) - 1, std::min(y1, y2) - 1, std::max(x1, x2) + 1, std::max(y1, y2) + 1)) return;
 
     if (x1 == x2){
         if (y1==y2){
-            Primitives::set_pixel(surface, x1,y1,color);
+            out.plot(x1, y1);
             return;
         }
 
-        Primitives::draw_vertical_line(surface, x1, y1, y2, color);
+        Primitives::draw_vertical_line(out, x1, y1, y2);
 
     }else if (y1==y2){
-        draw_horizontal_line(surface, x1, x2, y1, color);
+        draw_horizontal_line(out, x1, x2, y1);
 
     }else if (anti_aliasing) {
-        draw_xiaolin_wu_line(surface, x1, y1, x2, y2, color);
+        draw_xiaolin_wu_line(out, x1, y1, x2, y2);
+
+    } else {
+        draw_bresenham_line(out, x1, y1, x2, y2);
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Draws an aliased line between two 24.8 fixed-point canvas points.
+ *
+ * The line is walked along its major axis, one pixel per column (or row), from the
+ * pixel that contains the first point to the one that contains the second. In each
+ * step the minor coordinate is where the line crosses the center of that column,
+ * kept as an exact quotient and remainder, so the inner loop only adds integers.
+ * As in draw_bresenham_line, the visible steps are found before the loop, which then
+ * writes without checks.
+ *
+ * @param surface Pointer to the SDL_Surface where the line will be drawn.
+ * @param a, b    End points (see FixedPoint).
+ * @param color   Canvas color (CanvasFormat).
+ */
+void Primitives::draw_line(SDL_Surface* surface, FixedPoint::Vertex a, FixedPoint::Vertex b, Uint32 color) {
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        Primitives::draw_fixed_line(out, a, b);
+    });
+}
+
 
+// Núcleo da draw_line em ponto fixo para um formato de pixel.
+template <class Format>
+void Primitives::draw_fixed_line(const PixelFormat::Writer<Format>& out, FixedPoint::Vertex a, FixedPoint::Vertex b) {
+    const bool x_major = std::llabs((long long)b.x - a.x) >= std::llabs((long long)b.y - a.y);
+
+    // u: eixo principal, v: secundário; a linha é percorrida com u crescente.
+    long long u0 = x_major ? a.x : a.y, v0 = x_major ? a.y : a.x;
+    long long u1 = x_major ? b.x : b.y, v1 = x_major ? b.y : b.x;
+    if (u1 < u0) {
+        std::swap(u0, u1);
+        std::swap(v0, v1);
+    }
+    const long long du = u1 - u0, dv = v1 - v0;
+    const long long unit = FixedPoint::one;
+
+    if (du == 0) {
+        out.plot(FixedPoint::floor_to_int(a.x), FixedPoint::floor_to_int(a.y));
+        return;
+    }
+
+    const SDL_Rect& clip = out.clip;
+    const long long major_lo = x_major ? clip.x : clip.y;
+    const long long major_hi = x_major ? clip.x + clip.w - 1 : clip.y + clip.h - 1;
+    const long long minor_lo = x_major ? clip.y : clip.x;
+    const long long minor_hi = x_major ? clip.y + clip.h - 1 : clip.x + clip.w - 1;
+
+    // Passo k anda do pixel que contém u0 até o que contém u1. O pixel secundário no
+    // centro do passo k é m(k) = floor((n0 + k*step) / den).
+    const long long first = FixedPoint::floor_to_int((Sint32)u0);
+    const long long den = unit * du;
+    const long long step = unit * dv;
+    const long long n0 = v0 * du + (unit * first + unit / 2 - u0) * dv;
+
+    long long k0 = std::max(major_lo - first, 0LL);
+    long long k1 = std::min(major_hi, (long long)FixedPoint::floor_to_int((Sint32)u1)) - first;
+
+    // Passos com minor_lo <= m(k) <= minor_hi (m é monótona em k).
+    if (step > 0) {
+        k0 = std::max(k0, -floor_div(n0 - minor_lo * den, step));
+        k1 = std::min(k1, -floor_div(n0 - (minor_hi + 1) * den, step) - 1);
+    } else if (step < 0) {
+        k0 = std::max(k0, floor_div(n0 - (minor_hi + 1) * den, -step) + 1);
+        k1 = std::min(k1, floor_div(n0 - minor_lo * den, -step));
     } else {
-        draw_bresenham_line(surface, x1, y1, x2, y2, color);
+        const long long m = floor_div(n0, den);
+        if (m < minor_lo || m > minor_hi) return;
+    }
+    if (k0 > k1) return;
+
+    // Calculado direto no primeiro passo visível, então o recorte não muda os pixels.
+    const long long n = n0 + k0 * step;
+    const long long m0 = floor_div(n, den);
+    long long rem = n - m0 * den;
+    const long long dq = floor_div(step, den);
+    const long long dr = step - dq * den;
+
+    // Passos em bytes: um pixel na horizontal, uma linha (pitch) na vertical.
+    const int bpp = Format::bytes_per_pixel;
+    const int major_stride = x_major ? bpp : out.pitch;
+    const int minor_stride = x_major ? out.pitch : bpp;
+    const int px = (int)(x_major ? first + k0 : m0);
+    const int py = (int)(x_major ? m0 : first + k0);
+    Uint8* p = out.at(px, py);
+    const int stride = major_stride + (int)dq * minor_stride;
+
+    for (long long k = k0; k <= k1; ++k) {
+        out.put(p);
+        p += stride;
+        rem += dr;
+        if (rem >= den) {
+            rem -= den;
+            p += minor_stride;
+        }
     }
 }
 
@@ -173,21 +294,20 @@ void Primitives::draw_line(SDL_Surface* surface, int x1, int y1, int x2, int y2,
  * on the specified SDL_Surface with the given color.
  * If x1 is greater than x2, the values are swapped automatically.
  *
- * @param surface Pointer to the SDL_Surface where the line will be drawn.
+ * @param out Writer of the destination surface and color.
  * @param x1 The starting x-coordinate of the line.
  * @param x2 The ending x-coordinate of the line.
  * @param y The y-coordinate of the line.
- * @param color The color of the line, in Uint32 format.
  */
-void Primitives::draw_horizontal_line(SDL_Surface* surface, int x1, int x2, int y, Uint32 color) {
+template <class Format>
+void Primitives::draw_horizontal_line(const PixelFormat::Writer<Format>& out, int x1, int x2, int y) {
     if (x1 > x2){
         int aux = x2;
         x2 = x1;
         x1 = aux;
     }
 
-    for (int x = x1; x < x2; x++)
-        Primitives::set_pixel(surface, x, y, color);
+    out.fill_span(x1, x2 - 1, y);
 }
 
 
@@ -199,21 +319,29 @@ void Primitives::draw_horizontal_line(SDL_Surface* surface, int x1, int x2, int
  * on the specified SDL_Surface with the given color.
  * If y1 is greater than y2, the values are swapped automatically.
  *
- * @param surface Pointer to the SDL_Surface where the line will be drawn.
+ * @param out Writer of the destination surface and color.
  * @param x The x-coordinate of the line.
  * @param y1 The starting y-coordinate of the line.
  * @param y2 The ending y-coordinate of the line.
- * @param color The color of the line, in Uint32 format.
  */
-void Primitives::draw_vertical_line(SDL_Surface* surface,int x, int y1, int y2, Uint32 color) {
+template <class Format>
+void Primitives::draw_vertical_line(const PixelFormat::Writer<Format>& out, int x, int y1, int y2) {
     if (y1 > y2){
         int aux = y2;
         y2 = y1;
         y1 = aux;
     }
 
-    for (int y = y1; y < y2; y++) {
-        Primitives::set_pixel(surface, x, y, color);
+    const SDL_Rect& clip = out.clip;
+    if (x < clip.x || x >= clip.x + clip.w) return;
+
+    y1 = std::max(y1, clip.y);
+    y2 = std::min(y2, clip.y + clip.h);
+    if (y1 >= y2) return;
+
+    Uint8* p = out.at(x, y1);
+    for (int y = y1; y < y2; y++, p += out.pitch) {
+        out.put(p);
     }
 }
 
@@ -227,24 +355,80 @@ void Primitives::draw_vertical_line(SDL_Surface* surface,int x, int y1, int y2,
  * a straight and efficient line regardless of slope. The line is drawn
  * pixel by pixel using the given color.
  *
- * @param surface Pointer to the SDL_Surface where the line will be drawn.
+ * @param out Writer of the destination surface and color.
  * @param x1 The x-coordinate of the starting point.
  * @param y1 The y-coordinate of the starting point.
  * @param x2 The x-coordinate of the ending point.
  * @param y2 The y-coordinate of the ending point.
- * @param color The color of the line, in Uint32 format.
  */
-void Primitives::draw_bresenham_line(SDL_Surface* surface, int x1, int y1, int x2, int y2, Uint32 color) {
-    int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
-    int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
-    int err = dx + dy, e2;
-
-    while (true) {
-        Primitives::set_pixel(surface, x1, y1, color);
-        if (x1 == x2 && y1 == y2) break;
-        e2 = 2 * err;
-        if (e2 >= dy) { err += dy; x1 += sx; }
-        if (e2 <= dx) { err += dx; y1 += sy; }
+template <class Format>
+void Primitives::draw_bresenham_line(const PixelFormat::Writer<Format>& out, int x1, int y1, int x2, int y2) {
+    if (outside_clip(out.clip, std::min(x1, x2), std::min(y1, y2), std::max(x1, x2), std::max(y1, y2))) return;
+
+    const int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    const int dy = abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    const SDL_Rect& clip = out.clip;
+
+    // O passo j (0..major_len) anda um pixel no eixo principal; no eixo secundário o
+    // deslocamento do Bresenham tem forma fechada: m(j) = floor((2*minor_len*j + major_len) / (2*major_len)).
+    // Assim o trecho visível é resolvido antes do laço, que escreve sem checagens.
+    const bool x_major = dx >= dy;
+    const long long major_len = x_major ? dx : dy;
+    const long long minor_len = x_major ? dy : dx;
+    const int major0 = x_major ? x1 : y1;
+    const int minor0 = x_major ? y1 : x1;
+    const int major_dir = x_major ? sx : sy;
+    const int minor_dir = x_major ? sy : sx;
+    const int major_lo = x_major ? clip.x : clip.y;
+    const int major_hi = x_major ? clip.x + clip.w - 1 : clip.y + clip.h - 1;
+    const int minor_lo = x_major ? clip.y : clip.x;
+    const int minor_hi = x_major ? clip.y + clip.h - 1 : clip.x + clip.w - 1;
+
+    // Passos cujo eixo principal cai dentro do clip.
+    long long j0 = major_dir > 0 ? major_lo - major0 : major0 - major_hi;
+    long long j1 = major_dir > 0 ? major_hi - major0 : major0 - major_lo;
+    j0 = std::max(j0, 0LL);
+    j1 = std::min(j1, major_len);
+
+    // Deslocamentos secundários [a, b] que caem dentro do clip.
+    const long long a = minor_dir > 0 ? minor_lo - minor0 : minor0 - minor_hi;
+    const long long b = minor_dir > 0 ? minor_hi - minor0 : minor0 - minor_lo;
+
+    if (minor_len == 0) {
+        if (a > 0 || b < 0) return;
+    } else {
+        auto ceil_div = [](long long n, long long d) -> long long {
+            long long q = n / d;
+            if ((n % d != 0) && ((n < 0) == (d < 0))) q++;
+            return q;
+        };
+        j0 = std::max(j0, ceil_div(2 * major_len * a - major_len, 2 * minor_len));
+        j1 = std::min(j1, ceil_div(2 * major_len * (b + 1) - major_len, 2 * minor_len) - 1);
+    }
+
+    if (j0 > j1) return;
+
+    const long long den = 2 * std::max(major_len, 1LL);
+    long long num = 2 * minor_len * j0 + major_len;
+    const long long m0 = num / den;
+    long long rem = num % den;
+
+    const int bpp = Format::bytes_per_pixel;
+    const int major_stride = x_major ? major_dir * bpp : major_dir * out.pitch;
+    const int minor_stride = x_major ? minor_dir * out.pitch : minor_dir * bpp;
+
+    const int px = x_major ? major0 + major_dir * (int)j0 : minor0 + minor_dir * (int)m0;
+    const int py = x_major ? minor0 + minor_dir * (int)m0 : major0 + major_dir * (int)j0;
+    Uint8* p = out.at(px, py);
+
+    for (long long j = j0; j <= j1; ++j) {
+        out.put(p);
+        p += major_stride;
+        rem += 2 * minor_len;
+        if (rem >= den) {
+            rem -= den;
+            p += minor_stride;
+        }
     }
 }
 
@@ -256,19 +440,14 @@ void Primitives::draw_bresenham_line(SDL_Surface* surface, int x1, int y1, int x
  * This version blends the line color with the background using
  * the Xiaolin Wu antialiasing technique.
  *
- * @param surface Pointer to the SDL_Surface to draw on.
+ * @param out Writer of the destination surface and color.
  * @param x1 Starting x-coordinate.
  * @param y1 Starting y-coordinate.
  * @param x2 Ending x-coordinate.
  * @param y2 Ending y-coordinate.
- * @param color Uint32 color (mapped to surface format) of the line.
  */
-void Primitives::draw_xiaolin_wu_line(SDL_Surface* surface, int x1, int y1, int x2, int y2, Uint32 color) {
-    if (!surface) return;
-
-    SDL_Color lineColor;
-    SDL_GetRGBA(color, surface->format, &lineColor.r, &lineColor.g, &lineColor.b, &lineColor.a);
-
+template <class Format>
+void Primitives::draw_xiaolin_wu_line(const PixelFormat::Writer<Format>& out, int x1, int y1, int x2, int y2) {
     bool steep = abs(y2 - y1) > abs(x2 - x1);
 
     if (steep) {
@@ -295,25 +474,45 @@ void Primitives::draw_xiaolin_wu_line(SDL_Surface* surface, int x1, int y1, int
         y1 = aux;
     }
 
-    float dx = float(x2 - x1);
-    float dy = float(y2 - y1);
-    float gradient = (dx == 0.0f) ? 1.0f : dy / dx;
-
-    float intersectY = float(y1);
+    double dx = double(x2 - x1);
+    double dy = double(y2 - y1);
+    double gradient = (dx == 0.0) ? 1.0 : dy / dx;
+
+    // Eixo principal/secundário no espaço já trocado (steep).
+    const SDL_Rect& clip = out.clip;
+    const int major_lo = steep ? clip.y : clip.x;
+    const int major_hi = steep ? clip.y + clip.h - 1 : clip.x + clip.w - 1;
+    const int minor_lo = steep ? clip.x : clip.y;
+    const int minor_hi = steep ? clip.x + clip.w - 1 : clip.y + clip.h - 1;
+
+    int x_start = std::max(x1, major_lo);
+    int x_end = std::min(x2, major_hi);
+
+    // Restringe o eixo principal ao trecho cuja interseção pode tocar o clip
+    // (par de pixels y, y + 1), com um pixel de folga para o arredondamento.
+    if (gradient != 0.0) {
+        double xa = x1 + (minor_lo - 1 - y1) / gradient;
+        double xb = x1 + (minor_hi + 1 - y1) / gradient;
+        if (xa > xb) std::swap(xa, xb);
+        x_start = std::max(x_start, (int)std::max(std::floor(xa) - 1.0, (double)INT_MIN / 2));
+        x_end = std::min(x_end, (int)std::min(std::ceil(xb) + 1.0, (double)INT_MAX / 2));
+    } else if (y1 < minor_lo - 1 || y1 > minor_hi) {
+        return;
+    }
 
-    for (int x = x1; x <= x2; x++) {
-        int y = int(intersectY);
-        float f = intersectY - y;
+    for (int x = x_start; x <= x_end; x++) {
+        // Avaliada em forma fechada, a interseção não depende de onde o clip começa.
+        double intersectY = y1 + gradient * (x - x1);
+        int y = (int)std::floor(intersectY);
+        float f = float(intersectY - y);
 
-        if (steep) {
-            Primitives::blend_pixel(surface, y, x, lineColor, 1 - f);
-            Primitives::blend_pixel(surface, y + 1, x, lineColor, f);
-        } else {
-            Primitives::blend_pixel(surface, x, y, lineColor, 1 - f);
-            Primitives::blend_pixel(surface, x, y + 1, lineColor, f);
+        // Só o par de pixels secundários precisa ser testado: o eixo principal já foi recortado.
+        if (y >= minor_lo && y <= minor_hi) {
+            out.blend(steep ? out.at(y, x) : out.at(x, y), 1 - f);
+        }
+        if (y + 1 >= minor_lo && y + 1 <= minor_hi) {
+            out.blend(steep ? out.at(y + 1, x) : out.at(x, y + 1), f);
         }
-
-        intersectY += gradient;
     }
 }
 
@@ -324,10 +523,10 @@ void Primitives::draw_xiaolin_wu_line(SDL_Surface* surface, int x1, int y1, int
 /**
  * @brief Draws a cubic Bézier curve on an SDL_Surface with optional anti-aliasing.
  *
- * This function interpolates a cubic Bézier curve defined by four control points
- * (x0, y0), (x1, y1), (x2, y2), (x3, y3) and draws it on the provided SDL_Surface.
- * The curve can be drawn with or without anti-aliasing, which smooths the edges
- * by blending pixel colors based on their distance from the ideal curve line.
+ * The curve defined by the four control points (x0, y0), (x1, y1), (x2, y2), (x3, y3)
+ * is flattened by CurveFlattener into a polyline that stays within half a pixel of
+ * it, and the polyline is drawn with draw_polyline (Xiaolin Wu lines when anti-aliased,
+ * Bresenham lines otherwise).
  *
  * @param surface Pointer to the SDL_Surface where the curve will be drawn.
  * @param x0 X-coordinate of the first control point.
@@ -340,148 +539,64 @@ void Primitives::draw_xiaolin_wu_line(SDL_Surface* surface, int x1, int y1, int
  * @param y3 Y-coordinate of the fourth control point.
  * @param color Uint32 color of the curve in the surface's pixel format.
  * @param anti_aliasing Boolean flag to enable or disable anti-aliasing.
- *
- * @note The function automatically adjusts the number of interpolation steps
- *       based on the maximum delta between the first and last control points
- *       to ensure smooth rendering even for steep curves.
  */
-void Primitives::draw_bezier_curve(SDL_Surface* surface, int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, Uint32 color, bool anti_aliasing) {
-    if (Utils::verify_limits(surface, x0, y0) == 0) return;
-    if (Utils::verify_limits(surface, x1, y1) == 0) return;
-    if (Utils::verify_limits(surface, x2, y2) == 0) return;
-    if (Utils::verify_limits(surface, x3, y3) == 0) return;
-
-    double xu = 0.0, yu = 0.0;
-
-    const int steps = std::max(abs(x3-x0), abs(y3-y0)) * 3;
-
-    for(int i = 0; i <= steps; i++) {
-        double u = i / (double)steps;
-        xu = pow(1-u,3)*x0+3*u*pow(1-u,2)*x1+3*pow(u,2)*(1-u)*x2+pow(u,3)*x3;
-        yu = pow(1-u,3)*y0+3*u*pow(1-u,2)*y1+3*pow(u,2)*(1-u)*y2+pow(u,3)*y3;
+void Primitives::draw_curve(SDL_Surface* surface, int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, Uint32 color, bool anti_aliasing) {
+    if (!surface) return;
 
-        int x_int = int(xu);
-        int y_int = int(yu);
+    // A curva fica dentro do fecho convexo dos pontos de controle: se a caixa deles
+    // (mais um pixel do anti-aliasing) não toca o clip, nem é achatada.
+    if (outside_clip(surface->clip_rect,
+                     std::min(std::min(x0, x1), std::min(x2, x3)) - 1,
+                     std::min(std::min(y0, y1), std::min(y2, y3)) - 1,
+                     std::max(std::max(x0, x1), std::max(x2, x3)) + 1,
+                     std::max(std::max(y0, y1), std::max(y2, y3)) + 1)) return;
 
-        if (anti_aliasing) {
-            float fx = float(xu - x_int);
-            float fy = float(yu - y_int);
+    // Buffer reaproveitado entre chamadas (um por thread, por causa do TileRenderer).
+    static thread_local std::vector<SDL_FPoint> polyline;
+    polyline.clear();
 
-            // Blend pixels based on distance to the exact curve point.
-            Primitives::blend_pixel(surface, x_int,     y_int,     Colors::uint32_to_sdlcolor(surface, color), (1.0f - fx) * (1.0f - fy));
-            Primitives::blend_pixel(surface, x_int + 1, y_int,     Colors::uint32_to_sdlcolor(surface, color), fx * (1.0f - fy));
-            Primitives::blend_pixel(surface, x_int,     y_int + 1, Colors::uint32_to_sdlcolor(surface, color), (1.0f - fx) * fy);
-            Primitives::blend_pixel(surface, x_int + 1, y_int + 1, Colors::uint32_to_sdlcolor(surface, color), fx * fy);
-        } else {
-            Primitives::set_pixel(surface, x_int, y_int, color);
-        }
-    }
+    CurveFlattener::flatten_cubic(polyline, (float)x0, (float)y0, (float)x1, (float)y1, (float)x2, (float)y2, (float)x3, (float)y3);
+    Primitives::draw_polyline(surface, polyline, color, anti_aliasing);
 }
 
-void Primitives::draw_flat_curve(SDL_Surface* surface,
-                            int x0, int y0, int x1, int y1,
-                            int x2, int y2, int x3, int y3,
-                            Uint32 color, bool anti_aliasing) {
-    if (!surface) return;
-    // Se preferir manter o guard original, ok; mas remover os 4 checks evita "sumir" a curva
-    // caso algum controle fique fora, já que vamos desenhar com clipping do draw_line.
-    // if (Utils::verify_limits(surface, x0, y0) == 0) return;
-    // if (Utils::verify_limits(surface, x1, y1) == 0) return;
-    // if (Utils::verify_limits(surface, x2, y2) == 0) return;
-    // if (Utils::verify_limits(surface, x3, y3) == 0) return;
-
-    struct V2 { double x, y; };
-    auto line_len = [](V2 a, V2 b) {
-        double dx = a.x - b.x, dy = a.y - b.y;
-        return std::sqrt(dx*dx + dy*dy);
-    };
-    auto perp_dist = [](V2 p, V2 a, V2 b) {
-        // distância perpendicular de p ao segmento (a,b) usando área do paralelogramo
-        double dx = b.x - a.x, dy = b.y - a.y;
-        double num = std::abs(dy*(p.x - a.x) - dx*(p.y - a.y));
-        double den = std::sqrt(dx*dx + dy*dy);
-        return (den > 0.0) ? (num / den) : 0.0;
-    };
-
-    const double TOL = 0.5;      // tolerância em pixels (0.5 px costuma ser ótimo)
-    const int    MAX_DEPTH = 16; // trava p/ evitar recursão infinita
-
-    V2 P0{(double)x0,(double)y0}, P1{(double)x1,(double)y1};
-    V2 P2{(double)x2,(double)y2}, P3{(double)x3,(double)y3};
 
-    // desenha um segmento (escolhe AA ou não)
-    auto draw_seg = [&](V2 a, V2 b) {
-        if (anti_aliasing) {
-            Primitives::draw_xiaolin_wu_line(surface,
-                (int)std::lround(a.x),(int)std::lround(a.y),
-                (int)std::lround(b.x),(int)std::lround(b.y),
-                color);
-        } else {
-            Primitives::draw_bresenham_line(surface,
-                (int)std::lround(a.x),(int)std::lround(a.y),
-                (int)std::lround(b.x),(int)std::lround(b.y),
-                color);
+// METHOD IMPLEMENTATION
+/**
+ * @brief Draws an open polyline (for example, a flattened curve).
+ *
+ * The points are rounded to pixels; consecutive points that fall on the same pixel
+ * are merged, so short segments do not blend the same pixel twice.
+ *
+ * @param surface       Pointer to the SDL_Surface where the polyline will be drawn.
+ * @param points        Vertices, in order.
+ * @param color         Uint32 color in the surface's pixel format.
+ * @param anti_aliasing Draw Xiaolin Wu lines instead of Bresenham lines.
+ */
+void Primitives::draw_polyline(SDL_Surface* surface, const std::vector<SDL_FPoint>& points, Uint32 color, bool anti_aliasing) {
+    if (!surface || points.empty()) return;
+
+    // Um só despacho de formato para todos os segmentos.
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        int prev_x = (int)std::lround(points[0].x);
+        int prev_y = (int)std::lround(points[0].y);
+        bool drawn = false;
+
+        for (size_t i = 1; i < points.size(); ++i) {
+            const int x = (int)std::lround(points[i].x);
+            const int y = (int)std::lround(points[i].y);
+            if (x == prev_x && y == prev_y) continue;
+
+            Primitives::draw_line(out, prev_x, prev_y, x, y, anti_aliasing);
+            prev_x = x;
+            prev_y = y;
+            drawn = true;
         }
-    };
-
-    // subdivide até ficar "plano" o suficiente
-    std::function<void(V2,V2,V2,V2,int)> recurse = [&](V2 A, V2 B, V2 C, V2 D, int depth) {
-        // critério de planicidade: distâncias de B e C à reta AD
-        double d1 = perp_dist(B, A, D);
-        double d2 = perp_dist(C, A, D);
-        // também evita over-subdividir segmentos já bem pequenos
-        double chord = line_len(A, D);
 
-        if ((std::max(d1, d2) <= TOL) || depth >= MAX_DEPTH || chord <= 1.0) {
-            draw_seg(A, D);
-            return;
+        // Polilinha inteira num só pixel.
+        if (!drawn) {
+            Primitives::draw_line(out, prev_x, prev_y, prev_x, prev_y, anti_aliasing);
         }
-
-        // De Casteljau: subdivisão em duas cúbicas
-        V2 AB{(A.x+B.x)*0.5, (A.y+B.y)*0.5};
-        V2 BC{(B.x+C.x)*0.5, (B.y+C.y)*0.5};
-        V2 CD{(C.x+D.x)*0.5, (C.y+D.y)*0.5};
-
-        V2 ABC{(AB.x+BC.x)*0.5, (AB.y+BC.y)*0.5};
-        V2 BCD{(BC.x+CD.x)*0.5, (BC.y+CD.y)*0.5};
-
-        V2 ABCD{(ABC.x+BCD.x)*0.5, (ABC.y+BCD.y)*0.5}; // ponto médio na curva
-
-        // recursão nas duas metades
-        recurse(A,   AB,  ABC, ABCD, depth+1);
-        recurse(ABCD, BCD, CD,  D,    depth+1);
-    };
-
-    recurse(P0, P1, P2, P3, 0);
-}
-
-void Primitives::draw_curve(SDL_Surface* surface, int x0, int y0, int x1, int y1, int x2, int y2, int x3, int y3, Uint32 color, bool anti_aliasing) {
-    // "Flatness" da cúbica: maior distância dos pontos de controle internos
-    // à reta que liga as extremidades (em pixels).
-    double d1 = Utils::perp_dist((double)x1, (double)y1, (double)x0, (double)y0, (double)x3, (double)y3);
-    double d2 = Utils::perp_dist((double)x2, (double)y2, (double)x0, (double)y0, (double)x3, (double)y3);
-    double flatness = std::max(d1, d2);
-
-    //Reference surface size
-    const int REF_W = 895;
-    const int REF_H = 503;
-    //Reference thrheshold
-    const double BASE_THR = 10.0;
-    const double MIN_THR  = 3.0, MAX_THR = 24.0;
-
-    //Gets the diagonal of the surface
-    double diag     = std::hypot(double(surface->w), double(surface->h));
-    double diag_ref = std::hypot(double(REF_W),       double(REF_H));
-
-    int thr_px = Utils::clampi(BASE_THR * (diag / diag_ref), MIN_THR, MAX_THR);
-
-    if (flatness <= thr_px) {
-        // curva “plana o suficiente” → simples
-        Primitives::draw_bezier_curve(surface, x0, y0, x1, y1, x2, y2, x3, y3, color, anti_aliasing);
-    } else {
-        // curva acentuada → robusta (subdivisão/adaptativa em linhas conectadas)
-        Primitives::draw_flat_curve  (surface, x0, y0, x1, y1, x2, y2, x3, y3, color, anti_aliasing);
-    }
+    });
 }
 
 
@@ -496,134 +611,344 @@ void Primitives::draw_curve(SDL_Surface* surface, int x0, int y0, int x1, int y1
  * @param cx X-coordinate of the circle center.
  * @param cy Y-coordinate of the circle center.
  * @param radius Radius of the circle.
- * @param color Uint32 color of the circle in the surface's pixel format.
+ * @param color Canvas color of the circle (CanvasFormat).
  * @param anti_aliasing If true, the circle border will be smoothed using anti-aliasing.
  * @param filled If true, the circle will be filled.
  */
 void Primitives::draw_circle(SDL_Surface* surface, int cx, int cy, int radius, Uint32 color, bool anti_aliasing, bool filled) {
-    SDL_Color lineColor;
-    SDL_GetRGBA(color, surface->format, &lineColor.r, &lineColor.g, &lineColor.b, &lineColor.a);
+    if (!surface) return;
 
     if (anti_aliasing) {
-        SDL_Color lineColor = Colors::uint32_to_sdlcolor(surface, color);
-
-        int x_min = cx - radius - 1;
-        int x_max = cx + radius + 1;
-        int y_min = cy - radius - 1;
-        int y_max = cy + radius + 1;
-
-        for (int py = y_min; py <= y_max; py++) {
-            for (int px = x_min; px <= x_max; px++) {
-                float dx = px - cx;
-                float dy = py - cy;
-                float dist = sqrtf(dx * dx + dy * dy);
-
-                if (filled || (dist <= radius + 1.0f && dist >= radius - 1.0f)) {
-                    float coverage = radius + 0.5f - dist;
-                    if (coverage > 1.0f) coverage = 1.0f;
-                    if (coverage < 0.0f) coverage = 0.0f;
-
-                    if (coverage > 0.0f) {
-                        Uint32 bgPixel = Primitives::get_pixel(surface, px, py);
-                        SDL_Color bgColor = Colors::uint32_to_sdlcolor(surface, bgPixel);
-
-                        Uint8 r = Uint8(bgColor.r * (1.0f - coverage) + lineColor.r * coverage);
-                        Uint8 g = Uint8(bgColor.g * (1.0f - coverage) + lineColor.g * coverage);
-                        Uint8 b = Uint8(bgColor.b * (1.0f - coverage) + lineColor.b * coverage);
-
-                        Uint32 newColor = Colors::rgb_to_uint32(surface, r, g, b);
-                        Primitives::set_pixel(surface, px, py, newColor);
-                    }
-                }
-            }
-        }
+        PixelFormat::dispatch(surface, color, [&](const auto& out) {
+            Primitives::draw_antialiased_circle(out, cx, cy, radius, filled);
+        });
+    } else if (filled) {
+        // Uma passada pelo círculo gera a extensão de cada linha (antes, todas as linhas do
+        // disco eram redesenhadas a cada passo do octante: O(r^3)).
+        static thread_local SpanList spans;
+        ConicSpans::circle(spans, cx, cy, radius);
+        spans.fill(surface, color);
     } else {
-        int x = radius;
-        int y = 0;
-        int err = 0;
-
-        while (x >= y) {
-            Primitives::set_pixel(surface, cx + x, cy + y, color);
-            Primitives::set_pixel(surface, cx + y, cy + x, color);
-            Primitives::set_pixel(surface, cx - y, cy + x, color);
-            Primitives::set_pixel(surface, cx - x, cy + y, color);
-            Primitives::set_pixel(surface, cx - x, cy - y, color);
-            Primitives::set_pixel(surface, cx - y, cy - x, color);
-            Primitives::set_pixel(surface, cx + y, cy - x, color);
-            Primitives::set_pixel(surface, cx + x, cy - y, color);
-
-            if (filled) {
-                for (int y = -radius; y <= radius; y++) {
-                    int dx = (int)std::sqrt(radius * radius - y * y);
-                    Primitives::draw_line(surface, cx - dx, cy + y, cx + dx, cy + y, color, anti_aliasing);
-                }
+        PixelFormat::dispatch(surface, color, [&](const auto& out) {
+            Primitives::draw_bresenham_circle(out, cx, cy, radius);
+        });
+    }
+}
+
+
+// Círculo anti-aliased: cobertura pela distância ao raio, só na faixa da borda.
+template <class Format>
+void Primitives::draw_antialiased_circle(const PixelFormat::Writer<Format>& out, int cx, int cy, int radius, bool filled) {
+    static thread_local std::vector<Uint8> coverage_row;
+
+    const SDL_Rect& clip = out.clip;
+    int x_min = std::max(cx - radius - 1, clip.x);
+    int x_max = std::min(cx + radius + 1, clip.x + clip.w - 1);
+    int y_min = std::max(cy - radius - 1, clip.y);
+    int y_max = std::min(cy + radius + 1, clip.y + clip.h - 1);
+
+    if (x_min > x_max) return;
+    coverage_row.resize(x_max - x_min + 1);
+
+    auto coverage_at = [&](int px, int py) -> Uint8 {
+        float dx = px - cx;
+        float dy = py - cy;
+        float dist = sqrtf(dx * dx + dy * dy);
+        float coverage = 0.0f;
+
+        if (filled || (dist <= radius + 1.0f && dist >= radius - 1.0f)) {
+            coverage = radius + 0.5f - dist;
+        }
+
+        return CoverageBlender::to_coverage(coverage);
+    };
+
+    // Extensões de cada linha em inteiros (ConicSpans::half_width): fora do disco de raio
+    // r + 1 a cobertura é zero; dentro de r - 0.5 (preenchido) ela é 255 e vira um span
+    // sólido; dentro de r - 1 (contorno) é zero. Só a faixa da borda calcula distância.
+    const long long outer_sq = (long long)(radius + 1) * (radius + 1);
+    const long long inner_sq4 = (long long)(2 * radius - 1) * (2 * radius - 1);
+    const long long hole_sq = (long long)(radius - 1) * (radius - 1) - 1;
+
+    for (int py = y_min; py <= y_max; py++) {
+        const long long dy = py - cy;
+        const int outer = ConicSpans::half_width(outer_sq, dy);
+        if (outer < 0) continue;
+
+        int inner = -1;
+        if (filled && radius >= 1) {
+            const long long n = inner_sq4 - 4 * dy * dy;
+            inner = n < 0 ? -1 : ConicSpans::half_width(n / 4, 0);
+        } else if (!filled && radius >= 2) {
+            inner = ConicSpans::half_width(hole_sq, dy);
+        }
+
+        const int x0 = std::max(cx - outer, x_min);
+        const int x1 = std::min(cx + outer, x_max);
+        if (x0 > x1) continue;
+
+        int in0 = std::max(cx - inner, x0);
+        int in1 = std::min(cx + inner, x1);
+        if (inner < 0 || in0 > in1) {
+            in0 = x1 + 1;
+            in1 = x1;
+        }
+
+        // Borda esquerda.
+        for (int px = x0; px < in0; px++) {
+            coverage_row[px - x0] = coverage_at(px, py);
+        }
+        out.blend_run(py, x0, coverage_row.data(), in0 - x0);
+
+        // Interior: span sólido (preenchido) ou nada (contorno).
+        if (filled && in0 <= in1) {
+            if (out.opaque) {
+                out.fill_row(out.row(py), in0, in1);
+            } else {
+                std::fill(coverage_row.begin(), coverage_row.begin() + (in1 - in0 + 1), (Uint8)255);
+                out.blend_run(py, in0, coverage_row.data(), in1 - in0 + 1);
             }
+        }
 
-            y++;
-            if (err <= 0) err += 2 * y + 1;
-            if (err > 0) { x--; err -= 2 * x + 1; }
+        // Borda direita.
+        const int right_start = std::max(in1 + 1, in0);
+        for (int px = right_start; px <= x1; px++) {
+            coverage_row[px - right_start] = coverage_at(px, py);
         }
+        out.blend_run(py, right_start, coverage_row.data(), x1 - right_start + 1);
     }
 }
 
 
-void Primitives::fill_polygon(SDL_Surface* s, const std::vector<SDL_Point>& pts, Uint32 color) {
-    if (!s || pts.size() < 3) return;
-    const int H = s->h, W = s->w;
+// Contorno do círculo (Bresenham), oito pixels por passo do octante.
+template <class Format>
+void Primitives::draw_bresenham_circle(const PixelFormat::Writer<Format>& out, int cx, int cy, int radius) {
+    int x = radius;
+    int y = 0;
+    int err = 0;
+
+    while (x >= y) {
+        out.plot(cx + x, cy + y);
+        out.plot(cx + y, cy + x);
+        out.plot(cx - y, cy + x);
+        out.plot(cx - x, cy + y);
+        out.plot(cx - x, cy - y);
+        out.plot(cx - y, cy - x);
+        out.plot(cx + y, cy - x);
+        out.plot(cx + x, cy - y);
+
+        y++;
+        if (err <= 0) err += 2 * y + 1;
+        if (err > 0) { x--; err -= 2 * x + 1; }
+    }
+}
 
-    // encontra faixa de Y
-    int ymin = pts[0].y, ymax = pts[0].y;
-    for (auto &p : pts){ ymin = std::min(ymin, p.y); ymax = std::max(ymax, p.y); }
-    ymin = std::max(0, ymin);
-    ymax = std::min(H - 1, ymax);
 
-    struct Edge { int y_min, y_max; double x_at_ymin, inv_slope; };
-    std::vector<Edge> edges; edges.reserve(pts.size());
+// Grade de amostragem dos vértices de um polígono: a coluna x é amostrada em
+// unit*x + col_offset e a linha y em unit*y + row_offset, nas unidades dos vértices.
+// Pixels inteiros usam coordenadas dobradas (unit 2, linhas em y + 0.5, colunas em x);
+// ponto fixo 24.8 usa unit 256 e os centros dos pixels (offsets 128).
+struct PolygonGrid {
+    long long unit, col_offset, row_offset;
+};
+
+
+// Aresta de polígono para a conversão por linhas. O ponto em que a aresta cruza a linha
+// amostrada y, medido a partir da amostra da coluna 0 e nas unidades dos vértices,
+// u = ax - col_offset + (unit*y + row_offset - ay) * dx / dy, é guardado como quociente
+// e resto de N / dy; de uma linha para a seguinte N cresce unit*dx, então u anda com
+// somas inteiras, exato (sem o erro acumulado de somar um passo em ponto flutuante).
+// A coluna é u / unit; dividir só no fim mantém den pequeno para a comparação em before.
+struct PolygonEdge {
+    int y_end;              // Primeira linha depois da aresta ([y_start, y_end)).
+    int winding;            // +1 aresta descendo, -1 subindo (regra não-zero).
+    long long q, r;         // floor(u) e resto, em [0, den).
+    long long dq, dr;       // Passo por linha: floor(unit*dx / den) e o resto.
+    long long den;          // dy.
+    long long unit;
+
+    static long long floor_div(long long a, long long b) {
+        long long q = a / b;
+        if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+        return q;
+    }
+
+    static long long ceil_div(long long a, long long b) {
+        return -floor_div(-a, b);
+    }
 
-    // constrói tabela de arestas (ignora horizontais)
+    void start(const PolygonGrid& grid, long long ax, long long ay, long long dx, long long dy, int y) {
+        den = dy;
+        unit = grid.unit;
+        const long long n = (ax - grid.col_offset) * dy + (grid.unit * y + grid.row_offset - ay) * dx;
+        q = floor_div(n, den);
+        r = n - q * den;
+        dq = floor_div(grid.unit * dx, den);
+        dr = grid.unit * dx - dq * den;
+    }
+
+    void step() {
+        q += dq;
+        r += dr;
+        if (r >= den) {
+            r -= den;
+            q++;
+        }
+    }
+
+    bool before(const PolygonEdge& other) const {
+        // q + r/den < other.q + other.r/other.den, sem divisão.
+        if (q != other.q) return q < other.q;
+        return r * other.den < other.r * den;
+    }
+
+    // ceil(ceil(u) / unit) = ceil(u / unit), e o mesmo com floor.
+    int ceil_x() const { return (int)ceil_div(q + (r > 0 ? 1 : 0), unit); }
+    int floor_x() const { return (int)floor_div(q, unit); }
+};
+
+
+// Conversão por linhas das duas versões de fill_polygon (ver PolygonGrid).
+template <class Format>
+static void scan_polygon(const PixelFormat::Writer<Format>& out, const std::vector<FixedPoint::Vertex>& pts, const PolygonGrid& grid, FillRule rule) {
+    struct PendingEdge { int y_start; int y_end; FixedPoint::Vertex top; FixedPoint::Vertex bottom; int winding; };
+    static thread_local std::vector<PendingEdge> edge_table;
+    static thread_local std::vector<PolygonEdge> active;
+    edge_table.clear();
+    active.clear();
+
+    // Tabela de arestas (as que não cruzam nenhum centro de linha ficam de fora).
+    const int clip_top = out.clip.y;
+    const int clip_bottom = out.clip.y + out.clip.h - 1;
     for (size_t i = 0; i < pts.size(); ++i) {
-        SDL_Point a = pts[i], b = pts[(i + 1) % pts.size()];
+        FixedPoint::Vertex a = pts[i], b = pts[(i + 1) % pts.size()];
         if (a.y == b.y) continue;
-        if (a.y > b.y) std::swap(a, b); // a.y < b.y
-        Edge e;
-        e.y_min = a.y;
-        e.y_max = b.y;            // tratado como [y_min, y_max) (topo incluso, base exclusiva)
-        e.x_at_ymin = a.x;
-        e.inv_slope = double(b.x - a.x) / double(b.y - a.y);
-        edges.push_back(e);
-    }
 
-    // para cada scanline
-    for (int y = ymin; y <= ymax; ++y) {
-        std::vector<double> xs; xs.reserve(pts.size());
+        const int winding = a.y < b.y ? 1 : -1;
+        if (a.y > b.y) std::swap(a, b);
+
+        // Linhas amostradas em [a.y, b.y): topo incluso, base exclusiva.
+        const int y_start = (int)PolygonEdge::ceil_div((long long)a.y - grid.row_offset, grid.unit);
+        const int y_end = (int)PolygonEdge::ceil_div((long long)b.y - grid.row_offset, grid.unit);
+        if (y_start >= y_end || y_end - 1 < clip_top || y_start > clip_bottom) continue;
+        edge_table.push_back({std::max(y_start, clip_top), y_end, a, b, winding});
+    }
+    if (edge_table.empty()) return;
+
+    std::sort(edge_table.begin(), edge_table.end(), [](const PendingEdge& e0, const PendingEdge& e1) {
+        return e0.y_start < e1.y_start;
+    });
+
+    size_t next_edge = 0;
+    int y = edge_table[0].y_start;
+
+    while (y <= clip_bottom && (next_edge < edge_table.size() || !active.empty())) {
+        // Entram as arestas que começam nesta linha.
+        while (next_edge < edge_table.size() && edge_table[next_edge].y_start == y) {
+            const PendingEdge& e = edge_table[next_edge++];
+            PolygonEdge edge;
+            edge.y_end = e.y_end;
+            edge.winding = e.winding;
+            edge.start(grid, e.top.x, e.top.y, (long long)e.bottom.x - e.top.x, (long long)e.bottom.y - e.top.y, y);
+            active.push_back(edge);
+        }
 
-        // coleta interseções com esta linha (y + 0.5 evita ambiguidade em vértices)
-        double scan_y = y + 0.5;
-        for (const auto& e : edges) {
-            if (scan_y >= e.y_min && scan_y < e.y_max) {
-                double x = e.x_at_ymin + (scan_y - e.y_min) * e.inv_slope;
-                xs.push_back(x);
+        // Lista ativa ordenada por x (quase ordenada: inserção).
+        for (size_t i = 1; i < active.size(); ++i) {
+            PolygonEdge edge = active[i];
+            size_t k = i;
+            while (k > 0 && edge.before(active[k - 1])) {
+                active[k] = active[k - 1];
+                k--;
             }
+            active[k] = edge;
         }
 
-        if (xs.size() < 2) continue;
-        std::sort(xs.begin(), xs.end());
-
-        // pinta pares (regra par-ímpar)
-        for (size_t i = 0; i + 1 < xs.size(); i += 2) {
-            int xL = (int)std::ceil(xs[i]);
-            int xR = (int)std::floor(xs[i + 1]);
-            if (xL > xR) continue;
-            xL = std::max(0, xL);
-            xR = std::min(W - 1, xR);
-            for (int x = xL; x <= xR; ++x) {
-                Primitives::set_pixel(s, x, y, color);
+        if (rule == FillRule::NON_ZERO) {
+            int winding = 0;
+            for (size_t i = 0; i + 1 < active.size(); ++i) {
+                winding += active[i].winding;
+                if (winding != 0) {
+                    out.fill_span(active[i].ceil_x(), active[i + 1].floor_x(), y);
+                }
             }
+        } else {
+            for (size_t i = 0; i + 1 < active.size(); i += 2) {
+                out.fill_span(active[i].ceil_x(), active[i + 1].floor_x(), y);
+            }
+        }
+
+        // Saem as arestas que terminam nesta linha; as demais andam uma linha.
+        y++;
+        size_t kept = 0;
+        for (size_t i = 0; i < active.size(); ++i) {
+            if (active[i].y_end <= y) continue;
+            active[i].step();
+            active[kept++] = active[i];
+        }
+        active.resize(kept);
+
+        // Linhas sem arestas ativas: pula direto para a próxima aresta.
+        if (active.empty() && next_edge < edge_table.size()) {
+            y = edge_table[next_edge].y_start;
         }
     }
 }
 
 
+// METHOD IMPLEMENTATION
+/**
+ * @brief Fills a polygon with an edge table and an active edge list.
+ *
+ * The edges are sorted once by their first row. Going down the rows, edges enter the
+ * active list when their first row is reached and leave it after their last one; the
+ * active list stays sorted by x with an insertion sort, which is linear because the
+ * order barely changes from one row to the next. Each row costs O(active edges), with
+ * no allocation: the tables are scratch buffers reused across calls.
+ *
+ * A pixel is filled when its center is inside the polygon (edges cross rows at y + 0.5;
+ * a span covers the pixels from ceil of the left crossing to floor of the right one).
+ *
+ * @param s     Destination surface.
+ * @param pts   Vertices, in order; the polygon is closed from the last back to the first.
+ * @param color Canvas color (CanvasFormat).
+ * @param rule  EVEN_ODD (pairs of crossings) or NON_ZERO (signed crossing count).
+ */
+void Primitives::fill_polygon(SDL_Surface* s, const std::vector<SDL_Point>& pts, Uint32 color, FillRule rule) {
+    if (!s || pts.size() < 3) return;
+
+    static thread_local std::vector<FixedPoint::Vertex> doubled;
+    doubled.clear();
+    for (const SDL_Point& p : pts) {
+        doubled.push_back({2 * p.x, 2 * p.y});
+    }
+    PixelFormat::dispatch(s, color, [&](const auto& out) {
+        scan_polygon(out, doubled, {2, 0, 1}, rule);
+    });
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Fills a polygon given in 24.8 fixed-point canvas coordinates.
+ *
+ * Same edge table as the integer version; a pixel is filled when its center is inside
+ * the polygon, with vertices kept at 1/256 px and exact integer edge stepping.
+ *
+ * @param s     Destination surface.
+ * @param pts   Vertices (see FixedPoint), in order; the polygon is closed.
+ * @param color Canvas color (CanvasFormat).
+ * @param rule  EVEN_ODD (pairs of crossings) or NON_ZERO (signed crossing count).
+ */
+void Primitives::fill_polygon(SDL_Surface* s, const std::vector<FixedPoint::Vertex>& pts, Uint32 color, FillRule rule) {
+    if (!s || pts.size() < 3) return;
+
+    PixelFormat::dispatch(s, color, [&](const auto& out) {
+        scan_polygon(out, pts, {FixedPoint::one, FixedPoint::half, FixedPoint::half}, rule);
+    });
+}
+
+
 
 // METHOD IMPLEMENTATION
 /**
@@ -641,18 +966,27 @@ void Primitives::fill_polygon(SDL_Surface* s, const std::vector<SDL_Point>& pts,
  * @param cy            Y coordinate of the ellipse center.
  * @param rx            Horizontal radius of the ellipse.
  * @param ry            Vertical radius of the ellipse.
- * @param color         Pixel color (mapped to the surface format).
+ * @param color         Canvas color (CanvasFormat).
  * @param anti_aliasing If true, draw the ellipse with anti-aliasing; otherwise, use Bresenham's algorithm.
  * @param filled        If true, fill the ellipse; if false, draw only the outline.
  */
 void Primitives::draw_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, Uint32 color, bool anti_aliasing, bool filled) {
-    if (!Utils::verify_limits(surface, cx + rx, cy + ry)) return;
-    if (!Utils::verify_limits(surface, cx - rx, cy - ry)) return;
+    if (!surface) return;
+
+    // Elipses inteiramente fora do clip não custam nada (a margem cobre o anti-aliasing).
+    if (outside_clip(surface->clip_rect, cx - rx - rx / 4 - 2, cy - ry - ry / 4 - 2, cx + rx + rx / 4 + 2, cy + ry + ry / 4 + 2)) return;
 
     if (anti_aliasing) {
         Primitives::draw_supersampled_ellipse(surface, cx, cy, rx, ry, color, filled);
+    } else if (filled) {
+        // Preenchida: mesma caminhada do Bresenham, mas uma extensão por linha.
+        static thread_local SpanList spans;
+        ConicSpans::ellipse(spans, cx, cy, rx, ry);
+        spans.fill(surface, color);
     } else {
-        Primitives::draw_bresenham_ellipse(surface, cx, cy, rx, ry, color, filled);
+        PixelFormat::dispatch(surface, color, [&](const auto& out) {
+            Primitives::draw_bresenham_ellipse(out, cx, cy, rx, ry);
+        });
     }
 }
 
@@ -661,20 +995,19 @@ void Primitives::draw_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int
 /**
  * @brief Draws an ellipse on an SDL surface using the Bresenham midpoint algorithm.
  *
- * This function plots an ellipse centered at (cx, cy) with with horizontal (rx)
- * and vertical (ry) radii. It supports both outlined and filled ellipses by plotting
- * symmetric points in all four quadrants. The algorithm is integer-based and
- * efficient for raster graphics.
+ * This function plots the outline of an ellipse centered at (cx, cy) with
+ * horizontal (rx) and vertical (ry) radii, plotting symmetric points in all four
+ * quadrants. The algorithm is integer-based and efficient for raster graphics.
+ * Filled ellipses take the same walk through ConicSpans (see draw_ellipse).
  *
- * @param surface SDL surface where the ellipse will be drawn.
+ * @param out     Writer of the destination surface and color.
  * @param cx      X coordinate of the ellipse center.
  * @param cy      Y coordinate of the ellipse center.
  * @param rx      Horizontal radius of the ellipse.
  * @param ry      Vertical radius of the ellipse.
- * @param color   Pixel color (mapped to the surface format).
- * @param filled  If true, the ellipse is filled; otherwise, only the outline is drawn.
  */
-void Primitives::draw_bresenham_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, Uint32 color, bool filled) {
+template <class Format>
+void Primitives::draw_bresenham_ellipse(const PixelFormat::Writer<Format>& out, int cx, int cy, int rx, int ry) {
     int x = 0;
     int y = ry;
 
@@ -689,18 +1022,10 @@ void Primitives::draw_bresenham_ellipse(SDL_Surface* surface, int cx, int cy, in
     int p = (int)(ry2 - (rx2 * ry) + 0.25f * rx2);
 
     while (px < py) {
-        Primitives::set_pixel(surface, cx + x, cy + y, color);
-        Primitives::set_pixel(surface, cx - x, cy + y, color);
-        Primitives::set_pixel(surface, cx - x, cy - y, color);
-        Primitives::set_pixel(surface, cx + x, cy - y, color);
-
-        if (filled) {
-            int fx;
-            for (fx = cx - x + 1; fx < cx + x; fx++) {
-                Primitives::set_pixel(surface, fx, cy + y, color);
-                Primitives::set_pixel(surface, fx, cy - y, color);
-            }
-        }
+        out.plot(cx + x, cy + y);
+        out.plot(cx - x, cy + y);
+        out.plot(cx - x, cy - y);
+        out.plot(cx + x, cy - y);
 
         x++;
         px += twoRy2;
@@ -717,18 +1042,10 @@ void Primitives::draw_bresenham_ellipse(SDL_Surface* surface, int cx, int cy, in
     p = (int)(ry2 * (x + 0.5f) * (x + 0.5f) + rx2 * (y - 1) * (y - 1) - rx2 * ry2);
 
     while (y >= 0) {
-        Primitives::set_pixel(surface, cx + x, cy + y, color);
-        Primitives::set_pixel(surface, cx - x, cy + y, color);
-        Primitives::set_pixel(surface, cx - x, cy - y, color);
-        Primitives::set_pixel(surface, cx + x, cy - y, color);
-
-        if (filled) {
-            int fx;
-            for (fx = cx - x + 1; fx < cx + x; fx++) {
-                Primitives::set_pixel(surface, fx, cy + y, color);
-                Primitives::set_pixel(surface, fx, cy - y, color);
-            }
-        }
+        out.plot(cx + x, cy + y);
+        out.plot(cx - x, cy + y);
+        out.plot(cx - x, cy - y);
+        out.plot(cx + x, cy - y);
 
         y--;
         py -= twoRx2;
@@ -746,11 +1063,12 @@ void Primitives::draw_bresenham_ellipse(SDL_Surface* surface, int cx, int cy, in
 
 // METHOD IMPLEMENTATION
 /**
- * @brief Draws an ellipse on an SDL surface using supersampling anti-aliasing (SSAA).
+ * @brief Draws an anti-aliased, axis-aligned ellipse on an SDL surface.
  *
  * This function rasterizes an ellipse centered at (cx, cy) with radii rx (horizontal)
- * and ry (vertical). The edges are anti-aliased by subdividing each pixel into a
- * grid of subpixels (supersampling) and computing the coverage fraction of the ellipse.
+ * and ry (vertical). It used to supersample every pixel of the bounding box (4x4
+ * subpixels); it now goes through draw_analytic_ellipse, which only computes coverage
+ * near the boundary. The outline keeps the same thickness as before.
  *
  * - If filled is true, the interior of the ellipse is filled.
  * - If filled is false, only the outline of the ellipse is drawn with smooth edges.
@@ -760,267 +1078,528 @@ void Primitives::draw_bresenham_ellipse(SDL_Surface* surface, int cx, int cy, in
  * @param cy      Y coordinate of the ellipse center.
  * @param rx      Horizontal radius of the ellipse.
  * @param ry      Vertical radius of the ellipse.
- * @param color   Pixel color (mapped to the surface format).
+ * @param color   Canvas color (CanvasFormat).
  * @param filled  If true, fill the ellipse; if false, draw only the anti-aliased border.
  */
 void Primitives::draw_supersampled_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, Uint32 color, bool filled) {
-    SDL_Color lineColor = Colors::uint32_to_sdlcolor(surface, color);
-    int samples = 4; // Subpixels per axis (4x4 = 16 subpixels per pixel).
-
-    int marginX = rx / samples + 2;
-    int marginY = ry / samples + 2;
-
-    int xStart = cx - rx - marginX;
-    int xEnd   = cx + rx + marginX;
-    int yStart = cy - ry - marginY;
-    int yEnd   = cy + ry + marginY;
-
-    for (int y = yStart; y <= yEnd; y++) {
-        for (int x = xStart; x <= xEnd; x++) {
-            int count = 0;
-            for (int sy = 0; sy < samples; sy++) {
-                for (int sx = 0; sx < samples; sx++) {
-                    float px = x + (sx + 0.5f) / samples - cx;
-                    float py = y + (sy + 0.5f) / samples - cy;
-                    float value = (px*px)/(rx*rx) + (py*py)/(ry*ry);
-
-                    if (filled) {
-                        // Any subpixel within the ellipse.
-                        if (value <= 1.0f) count++;
-                    } else {
-                        // Only subpixels near the edge.
-                        float tolerance = 0.07f / samples; // Controls the thickness.
-                        if (fabs(value - 1.0f) <= tolerance) count++;
-                    }
+    // Espessura do contorno: |valor implícito - 1| <= 0.07 / 4, como no supersampling antigo.
+    Primitives::draw_analytic_ellipse(surface, cx, cy, rx, ry, 0.0f, color, filled, 0.07f / 4);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Analytic anti-aliased rasterizer for (rotated) ellipses.
+ *
+ * For each row, the chords of the ellipse at the top and bottom of the row give the
+ * pixels that lie entirely inside it: those are written as one solid span (filled
+ * mode) or skipped (outline mode). Only the pixels between that span and the outer
+ * bound of the row get a coverage value, computed from the signed distance to the
+ * boundary estimated with the gradient of the implicit function
+ * G(p) = sqrt(u^2 / rx^2 + v^2 / ry^2), d = (G - 1) / |grad G|.
+ *
+ * @param surface           Destination surface.
+ * @param cx                X coordinate of the center (pixel corner coordinates).
+ * @param cy                Y coordinate of the center.
+ * @param rx                Radius along the rotated x axis.
+ * @param ry                Radius along the rotated y axis.
+ * @param angle_rad         Rotation, in radians.
+ * @param color             Canvas color (CanvasFormat).
+ * @param filled            Fill the ellipse or draw only its outline.
+ * @param outline_tolerance Outline thickness, as the allowed |G^2 - 1|.
+ */
+void Primitives::draw_analytic_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, float angle_rad, Uint32 color, bool filled, float outline_tolerance) {
+    if (!surface || rx <= 0 || ry <= 0) return;
+
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        Primitives::draw_analytic_ellipse(out, cx, cy, rx, ry, angle_rad, filled, outline_tolerance);
+    });
+}
+
+
+// Núcleo de draw_analytic_ellipse para um formato de pixel.
+template <class Format>
+void Primitives::draw_analytic_ellipse(const PixelFormat::Writer<Format>& out, int cx, int cy, int rx, int ry, float angle_rad, bool filled, float outline_tolerance) {
+    const double c = std::cos((double)angle_rad);
+    const double s = std::sin((double)angle_rad);
+    const double irx2 = 1.0 / ((double)rx * rx);
+    const double iry2 = 1.0 / ((double)ry * ry);
+
+    // Forma quadrática: G^2 = A*dx^2 + 2*H*dx*dy + D*dy^2.
+    const double A = c * c * irx2 + s * s * iry2;
+    const double H = c * s * (irx2 - iry2);
+    const double D = s * s * irx2 + c * c * iry2;
+    const double det = A * D - H * H;
+
+    // Faixa do contorno em G (G^2 entre 1 - t e 1 + t) e elipses que limitam as linhas:
+    // a externa contém todo pixel com cobertura, a interna só pixels sem borda.
+    const double t = filled ? 0.0 : (double)outline_tolerance;
+    const double band_in = std::sqrt(std::max(0.0, 1.0 - t));
+    const double band_out = std::sqrt(1.0 + t);
+    const double min_radius = (double)std::min(rx, ry);
+    const double outer_scale = band_out + 1.5 / min_radius;
+    const double inner_scale = filled ? 1.0 : band_in - 1.5 / min_radius;
+
+    // Meia corda (em relação ao centro) da elipse G <= scale na altura dy.
+    auto chord = [&](double scale, double dy, double* left, double* right) -> bool {
+        double b = H * dy;
+        double disc = b * b - A * (D * dy * dy - scale * scale);
+        if (disc < 0.0) return false;
+        double root = std::sqrt(disc);
+        *left = (-b - root) / A;
+        *right = (-b + root) / A;
+        return true;
+    };
+
+    const double outer_half_h = outer_scale * std::sqrt(A / det);
+    const double outer_half_w = outer_scale * std::sqrt(D / det);
+
+    const SDL_Rect& clip = out.clip;
+    const int y_start = std::max((int)std::floor(cy - outer_half_h), clip.y);
+    const int y_end = std::min((int)std::ceil(cy + outer_half_h), clip.y + clip.h - 1);
+    const int clip_x0 = clip.x, clip_x1 = clip.x + clip.w - 1;
+    if (y_start > y_end || clip_x0 > clip_x1) return;
+
+    static thread_local std::vector<Uint8> coverage_row;
+
+    // Cobertura de um pixel a partir do centro (dx, dy) relativo ao centro da elipse.
+    auto coverage_at = [&](double dx, double dy) -> Uint8 {
+        double u = c * dx + s * dy;
+        double v = -s * dx + c * dy;
+        double gx = u * irx2, gy = v * iry2;
+        double g2 = u * gx + v * gy;
+        double G = std::sqrt(g2);
+        double grad = std::sqrt(gx * gx + gy * gy);
+        if (G < 1e-9 || grad < 1e-12) return filled ? 255 : 0;
+
+        // |grad G| = |grad (G^2)| / (2G) = grad / G.
+        double inv_grad = G / grad;
+        double d = (G - 1.0) * inv_grad;
+        double coverage;
+
+        if (filled) {
+            coverage = 0.5 - d;
+        } else {
+            double d_in = (band_in - 1.0) * inv_grad;
+            double d_out = (band_out - 1.0) * inv_grad;
+            coverage = std::min(d + 0.5, d_out) - std::max(d - 0.5, d_in);
+        }
+
+        return CoverageBlender::to_coverage((float)coverage);
+    };
+
+    for (int y = y_start; y <= y_end; ++y) {
+        const double dy_top = y - cy;
+        const double dy_bottom = y + 1 - cy;
+        const double dy_center = y + 0.5 - cy;
+
+        // Extensão horizontal da elipse externa dentro da faixa [y, y + 1].
+        const double dy0 = std::max(dy_top, -outer_half_h);
+        const double dy1 = std::min(dy_bottom, outer_half_h);
+        if (dy0 > dy1) continue;
+
+        // No topo/base da elipse a corda degenera (disc < 0 por arredondamento): usa o ponto tangente.
+        double l0, r0, l1, r1;
+        if (!chord(outer_scale, dy0, &l0, &r0)) l0 = r0 = -H * dy0 / A;
+        if (!chord(outer_scale, dy1, &l1, &r1)) l1 = r1 = -H * dy1 / A;
+        double left = std::min(l0, l1);
+        double right = std::max(r0, r1);
+
+        // Os pontos extremos em x ficam em dy = -+H*w/D; se caem na faixa, limitam a linha.
+        const double y_at_left = H * outer_half_w / D;
+        if (y_at_left >= dy0 && y_at_left <= dy1) left = -outer_half_w;
+        if (-y_at_left >= dy0 && -y_at_left <= dy1) right = outer_half_w;
+
+        int x0 = std::max((int)std::floor(cx + left), clip_x0);
+        int x1 = std::min((int)std::floor(cx + right), clip_x1);
+        if (x0 > x1) continue;
+
+        // Pixels com os quatro cantos dentro da elipse interna (convexa) não têm borda.
+        int in0 = x1 + 1, in1 = x1;
+        double il0, ir0, il1, ir1;
+        if (inner_scale > 0.0 && chord(inner_scale, dy_top, &il0, &ir0) && chord(inner_scale, dy_bottom, &il1, &ir1)) {
+            int lo = (int)std::ceil(cx + std::max(il0, il1));
+            int hi = (int)std::floor(cx + std::min(ir0, ir1)) - 1;
+            if (lo <= hi) {
+                in0 = std::max(lo, x0);
+                in1 = std::min(hi, x1);
+                if (in0 > in1) {
+                    in0 = x1 + 1;
+                    in1 = x1;
                 }
             }
+        }
+
+        coverage_row.resize(x1 - x0 + 1);
+
+        // Borda esquerda.
+        for (int x = x0; x < in0; ++x) {
+            coverage_row[x - x0] = coverage_at(x + 0.5 - cx, dy_center);
+        }
+        out.blend_run(y, x0, coverage_row.data(), in0 - x0);
 
-            float coverage = (float)count / (samples * samples);
-            if (coverage > 0.0f) {
-                Primitives::blend_pixel(surface, x, y, lineColor, coverage);
+        // Interior: span sólido (preenchida) ou nada (contorno).
+        if (filled && in0 <= in1) {
+            if (out.opaque) {
+                out.fill_row(out.row(y), in0, in1);
+            } else {
+                std::fill(coverage_row.begin(), coverage_row.begin() + (in1 - in0 + 1), (Uint8)255);
+                out.blend_run(y, in0, coverage_row.data(), in1 - in0 + 1);
             }
         }
+
+        // Borda direita.
+        const int right_start = std::max(in1 + 1, in0);
+        for (int x = right_start; x <= x1; ++x) {
+            coverage_row[x - right_start] = coverage_at(x + 0.5 - cx, dy_center);
+        }
+        out.blend_run(y, right_start, coverage_row.data(), x1 - right_start + 1);
     }
 }
 
 
 // METHOD IMPLEMENTATION
-// Essa função pega uma string, renderiza-a como imagem (com a fonte e cor especificadas) e desenha esse texto na superfície alvo na posição (x, y)
+// Essa função desenha uma string (com a fonte e cor especificadas) na superfície alvo na posição (x, y).
+// Os glifos e o layout do texto ficam em cache (GlyphAtlas): nenhuma surface é criada por chamada.
 void Primitives::draw_text(SDL_Surface* target, TTF_Font* font, const std::string& text, int x, int y, SDL_Color color) {
-    if (!target || !font) return;
+    GlyphAtlas::draw_text(target, font, text, x, y, color);
+}
+
 
-    SDL_Surface* text_surf = TTF_RenderUTF8_Blended(font, text.c_str(), color);
-    if (!text_surf) return;
+// Compara duas cores canal a canal; cada canal pode diferir no máximo 'tolerance'.
+static inline bool color_within_tolerance(Uint32 a, Uint32 b, int tolerance) {
+    if (a == b) return true;
+    if (tolerance <= 0) return false;
 
-    SDL_Rect dest = { x, y, text_surf->w, text_surf->h };
-    SDL_BlitSurface(text_surf, NULL, target, &dest);
-    SDL_FreeSurface(text_surf);
+    // Os quatro canais ocupam um byte cada (CanvasFormat).
+    for (int shift = 0; shift < 32; shift += 8) {
+        int ca = (int)((a >> shift) & 0xFF);
+        int cb = (int)((b >> shift) & 0xFF);
+        if (std::abs(ca - cb) > tolerance) return false;
+    }
+
+    return true;
 }
 
 
 // METHOD IMPLEMENTATION
-// Flood fill com  (algoritmo de preenchimento)
-// Pinta shape com base na cor, usando o pixel de referência (x,y) como cor dos pixels que será substituída pela fillColor
-// Se a pilha enche, o algoritmo apenas deixa de pintar pixels que precisariam ser processados, não dá erro.
-void Primitives::flood_fill(SDL_Surface* surface, int x, int y, Uint32 fill_color) {
-    if (!surface || x < 0 || x >= surface->w || y < 0 || y >= surface->h) {
-        return;
+/**
+ * @brief Span-based (scanline) flood fill.
+ *
+ * Starting at the seed, the fill extends left and right along the row, writes the
+ * whole run through the row pointer and seeds only one point per run of matching
+ * pixels in the rows above and below. The fill never leaves surface->clip_rect.
+ *
+ * @param surface         32-bit surface to fill.
+ * @param x               X coordinate of the seed.
+ * @param y               Y coordinate of the seed.
+ * @param fill_color      Color written over the region (in the surface format).
+ * @param tolerance       Maximum per-channel difference (0-255) from the seed color
+ *                        for a pixel to belong to the region. 0 means exact match.
+ * @param eight_connected If true, diagonal neighbours also connect the region.
+ */
+void Primitives::flood_fill(SDL_Surface* surface, int x, int y, Uint32 fill_color, int tolerance, bool eight_connected) {
+    Primitives::flood_fill_into(surface, surface, x, y, fill_color, tolerance, eight_connected);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Span-based flood fill that reads the region from one surface and writes it to another.
+ *
+ * Used by the paint layer: the region is found on the composited canvas, but the
+ * fill color is stored in the layer. Both surfaces must be 32-bit and have the same
+ * size; the fill is bounded by source->clip_rect. When source and target are the
+ * same surface this is the regular flood_fill.
+ *
+ * @param source          Surface the region is read from.
+ * @param target          Surface the fill color is written to.
+ * @param x               X coordinate of the seed.
+ * @param y               Y coordinate of the seed.
+ * @param fill_color      Color written over the region (in the target format).
+ * @param tolerance       Maximum per-channel difference (0-255) from the seed color.
+ * @param eight_connected If true, diagonal neighbours also connect the region.
+ *
+ * @return Bounding rectangle of the filled pixels (w and h are 0 if nothing was filled).
+ */
+SDL_Rect Primitives::flood_fill_into(SDL_Surface* source, SDL_Surface* target, int x, int y, Uint32 fill_color, int tolerance, bool eight_connected) {
+    TRACE_SCOPE("flood_fill");
+    SDL_Rect filled = {0, 0, 0, 0};
+
+    if (!source || !target) return filled;
+    if (source->format->BytesPerPixel != 4 || target->format->BytesPerPixel != 4) return filled;
+    if (source->w != target->w || source->h != target->h) return filled;
+
+    const SDL_Rect& clip = source->clip_rect;
+    const int min_x = clip.x, max_x = clip.x + clip.w;
+    const int min_y = clip.y, max_y = clip.y + clip.h;
+
+    if (x < min_x || x >= max_x || y < min_y || y >= max_y) {
+        return filled;
     }
 
-    Uint32 target_color = get_pixel(surface, x, y);
-    if (target_color == fill_color) {
-        return;
+    Uint8* base = (Uint8*)source->pixels;
+    const int pitch = source->pitch;
+    Uint8* target_base = (Uint8*)target->pixels;
+    const int target_pitch = target->pitch;
+    const bool in_place = source == target;
+
+    const Uint32 target_color = ((Uint32*)(base + y * pitch))[x];
+    if (in_place && target_color == fill_color && tolerance <= 0) {
+        return filled;
     }
 
-    // A pilha agora usa pares (x, y) e cresce dinamicamente.
-    std::stack<std::pair<int, int>> pixels;
-    pixels.push({x, y});
+    // Com tolerância a cor de preenchimento pode continuar "casando" com a região,
+    // e com superfícies distintas a origem nunca muda; nos dois casos os pixels já
+    // pintados são marcados numa máscara para não serem revisitados.
+    const bool use_mask = tolerance > 0 || !in_place;
+    int fill_x0 = max_x, fill_y0 = max_y, fill_x1 = min_x - 1, fill_y1 = min_y - 1;
 
-    while (!pixels.empty()) {
-        // Pega o pixel do topo da pilha e o remove (pop).
-        std::pair<int, int> current = pixels.top();
-        pixels.pop();
+    // Buffers reaproveitados entre chamadas (um por thread).
+    static thread_local std::vector<Uint8> visited;
+    static thread_local std::vector<SDL_Point> seeds;
 
-        int px = current.first;
-        int py = current.second;
+    if (use_mask) visited.assign((size_t)clip.w * (size_t)clip.h, 0);
+    seeds.clear();
 
-        // Verifica os limites e a cor do pixel atual.
-        if (px < 0 || px >= surface->w || py < 0 || py >= surface->h || get_pixel(surface, px, py) != target_color) {
-            continue;
-        }
+    auto matches = [&](const Uint32* row, int px, int py) -> bool {
+        if (!use_mask) return row[px] == target_color;
+        if (visited[(size_t)(py - min_y) * clip.w + (px - min_x)]) return false;
+        return color_within_tolerance(row[px], target_color, tolerance);
+    };
 
-        // Pinta o pixel.
-        set_pixel(surface, px, py, fill_color);
+    seeds.push_back({x, y});
 
-        // Adiciona (push) os vizinhos à pilha.
-        pixels.push({px + 1, py});
-        pixels.push({px - 1, py});
-        pixels.push({px, py + 1});
-        pixels.push({px, py - 1});
-    }
-}
+    while (!seeds.empty()) {
+        SDL_Point seed = seeds.back();
+        seeds.pop_back();
 
-// METHOD IMPLEMENTATION
-void Primitives::draw_rotated_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, float angle_rad, Uint32 color, bool filled)
-{
-    if (!surface) return;
-    if (rx <= 0 || ry <= 0) return;
+        Uint32* row = (Uint32*)(base + seed.y * pitch);
+        if (!matches(row, seed.x, seed.y)) continue;
 
-    SDL_Color col = Colors::uint32_to_sdlcolor(surface, color);
+        // Expande a corrida para a esquerda e para a direita.
+        int left = seed.x;
+        int right = seed.x;
+        while (left > min_x && matches(row, left - 1, seed.y)) left--;
+        while (right < max_x - 1 && matches(row, right + 1, seed.y)) right++;
 
-    float c = cosf(angle_rad);
-    float s = sinf(angle_rad);
-    int margin = (rx > ry ? rx : ry) + 2;
-    int samples = 4;
+        // Escreve a corrida inteira pelo ponteiro da linha.
+        Uint32* target_row = (Uint32*)(target_base + seed.y * target_pitch);
+        for (int i = left; i <= right; ++i) {
+            target_row[i] = fill_color;
+        }
 
-    // [CORREÇÃO] Calcula os limites da iteração (bounding box na tela)
-    int x_start = cx - margin;
-    int x_end = cx + margin;
-    int y_start = cy - margin;
-    int y_end = cy + margin;
+        fill_x0 = std::min(fill_x0, left);
+        fill_x1 = std::max(fill_x1, right);
+        fill_y0 = std::min(fill_y0, seed.y);
+        fill_y1 = std::max(fill_y1, seed.y);
 
-    // [CORREÇÃO] Restringe (clamping) os limites para ficarem DENTRO da tela.
-    // Isso evita loops gigantes e garante que 'x' e 'y' sempre serão válidos.
-    x_start = std::max(0, x_start);
-    x_end = std::min(surface->w - 1, x_end);
-    y_start = std::max(0, y_start);
-    y_end = std::min(surface->h - 1, y_end);
+        if (use_mask) {
+            std::fill_n(visited.begin() + (size_t)(seed.y - min_y) * clip.w + (left - min_x), right - left + 1, (Uint8)1);
+        }
 
-    // O loop agora itera SOMENTE sobre os pixels potencialmente visíveis.
-    for (int y = y_start; y <= y_end; ++y) {
-        for (int x = x_start; x <= x_end; ++x) {
-            int inside = 0;
-            for (int sy = 0; sy < samples; ++sy) {
-                for (int sx = 0; sx < samples; ++sx) {
-                    float dx = (x + (sx + 0.5f) / samples) - cx;
-                    float dy = (y + (sy + 0.5f) / samples) - cy;
-                    float u = c * dx + s * dy;
-                    float v = -s * dx + c * dy;
-                    float val = (u * u) / (rx * rx) + (v * v) / (ry * ry);
-                    if (filled ? (val <= 1.0f) : (fabsf(val - 1.0f) <= 0.07f)) {
-                        inside++;
+        // Nas linhas vizinhas, semeia apenas o início de cada corrida que casa.
+        const int scan_left = eight_connected ? std::max(left - 1, min_x) : left;
+        const int scan_right = eight_connected ? std::min(right + 1, max_x - 1) : right;
+
+        for (int ny = seed.y - 1; ny <= seed.y + 1; ny += 2) {
+            if (ny < min_y || ny >= max_y) continue;
+
+            const Uint32* neighbour = (const Uint32*)(base + ny * pitch);
+            bool in_run = false;
+
+            for (int i = scan_left; i <= scan_right; ++i) {
+                if (matches(neighbour, i, ny)) {
+                    if (!in_run) {
+                        seeds.push_back({i, ny});
+                        in_run = true;
                     }
+                } else {
+                    in_run = false;
                 }
             }
-            float cov = (float)inside / (samples * samples);
-            // A chamada a blend_pixel agora é inerentemente segura, pois x e y
-            // estão garantidos dentro dos limites da tela pelo loop.
-            if (cov > 0.0f) {
-                Primitives::blend_pixel(surface, x, y, col, cov);
-            }
         }
     }
-}
 
+    if (fill_x1 >= fill_x0) {
+        filled = {fill_x0, fill_y0, fill_x1 - fill_x0 + 1, fill_y1 - fill_y0 + 1};
+    }
 
-void Primitives::draw_triangle(SDL_Surface* surface,
-                                      int x0, int y0,
-                                      int x1, int y1,
-                                      int x2, int y2,
-                                      Uint32 color)
+    return filled;
+}
+
+// METHOD IMPLEMENTATION
+void Primitives::draw_rotated_ellipse(SDL_Surface* surface, int cx, int cy, int rx, int ry, float angle_rad, Uint32 color, bool filled)
 {
-    if (!surface) return;
+    // Antes: 4x4 amostras por pixel em todo o quadrado de lado 2*margin. Agora só a faixa
+    // da borda calcula cobertura; o contorno mantém a espessura antiga (|valor - 1| <= 0.07).
+    Primitives::draw_analytic_ellipse(surface, cx, cy, rx, ry, angle_rad, color, filled, 0.07f);
+}
 
 
-auto edge_fn = [](int ax, int ay, int bx, int by, int px, int py) -> long long {
-        // (By - Ay)*(Px - Ax) - (Bx - Ax)*(Py - Ay)
-        return (long long)(by - ay) * (px - ax) - (long long)(bx - ax) * (py - ay);
+// Triângulo preparado para rasterização por linhas. Cada aresta é linear em x, então a
+// cobertura de uma linha é um único intervalo, limitado por uma aresta à esquerda e outra
+// à direita. Cada limite é floor((N0 + D*j) / den) na linha j: quociente e resto andam
+// de linha em linha com somas (sem divisões), como no Bresenham.
+struct TriangleRows {
+    struct EdgeBound {
+        long long q, r;     // Limite atual (floor) e resto, em [0, den).
+        long long dq, dr;   // Passo por linha: floor(D / den) e D - dq * den.
+        long long den;      // |A| (0: aresta horizontal, ver value).
+        long long value;    // Aresta horizontal: sign * E - t, constante na linha.
+        long long step;     // Aresta horizontal: quanto value muda por linha.
+        int kind;           // +1 limite esquerdo, -1 limite direito, 0 horizontal.
     };
 
-    long long area2 = edge_fn(x0,y0, x1,y1, x2,y2);
-    if (area2 == 0) {
-        // Triângulo degenerado: desenha as arestas
-        Primitives::draw_bresenham_line(surface, x0, y0, x1, y1, color);
-        Primitives::draw_bresenham_line(surface, x1, y1, x2, y2, color);
-        Primitives::draw_bresenham_line(surface, x2, y2, x0, y0, color);
-        return;
+    int minx, maxx, miny, maxy;
+    EdgeBound bounds[3];
+
+    static long long floor_div(long long a, long long b) {
+        long long q = a / b;
+        if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+        return q;
     }
 
-    // BBox inteira (não clampada)
-    int minx = std::min(x0, std::min(x1, x2));
-    int maxx = std::max(x0, std::max(x1, x2));
-    int miny = std::min(y0, std::min(y1, y2));
-    int maxy = std::max(y0, std::max(y1, y2));
+    // Pixel que contém a coordenada v (em unidades de 1/unit pixel).
+    static long long to_pixel(long long v, long long unit) {
+        if (unit == 1) return v;
+        if (unit == FixedPoint::one) return v >> FixedPoint::fraction_bits;
+        return floor_div(v, unit);
+    }
 
-    // Top-left rule
-    auto is_top_left = [](int ax, int ay, int bx, int by) -> bool {
-        int dx = bx - ax, dy = by - ay;
-        return (dy < 0) || (dy == 0 && dx < 0);
-    };
+    // Vértices v = {x0, y0, x1, y1, x2, y2} em unidades de 1/unit pixel: unit = 1 para
+    // coordenadas inteiras de pixel, FixedPoint::one para 24.8.
+    // Retorna false se o triângulo é degenerado (área zero) ou não toca o clip.
+    bool setup(const SDL_Rect& clip, const long long v[6], long long unit, bool* degenerate) {
+        const long long x0 = v[0], y0 = v[1], x1 = v[2], y1 = v[3], x2 = v[4], y2 = v[5];
+
+        // Área com sinal: (x1 - x0)*(y2 - y0) - ... (mesma convenção das edge functions)
+        long long area2 = (y1 - y0) * (x2 - x0) - (x1 - x0) * (y2 - y0);
+        *degenerate = area2 == 0;
+        if (area2 == 0) return false;
+
+        // Pixels que contêm os vértices extremos (um superconjunto dos centros cobertos).
+        minx = (int)std::max(to_pixel(std::min(x0, std::min(x1, x2)), unit), (long long)clip.x);
+        maxx = (int)std::min(to_pixel(std::max(x0, std::max(x1, x2)), unit), (long long)clip.x + clip.w - 1);
+        miny = (int)std::max(to_pixel(std::min(y0, std::min(y1, y2)), unit), (long long)clip.y);
+        maxy = (int)std::min(to_pixel(std::max(y0, std::max(y1, y2)), unit), (long long)clip.y + clip.h - 1);
+        if (minx > maxx || miny > maxy) return false;
+
+        // Arestas opostas a v0, v1 e v2: E(P) = A*x + B*y + C, amostrada no centro do
+        // pixel. Com sign = sinal da área, o pixel está dentro quando sign*E >= t, com
+        // t = 0 nas arestas top-left e 1 nas demais.
+        const long long ex[3][4] = { {x1, y1, x2, y2}, {x2, y2, x0, y0}, {x0, y0, x1, y1} };
+        const long long sign = area2 > 0 ? 1 : -1;
+
+        for (int i = 0; i < 3; ++i) {
+            const long long ax = ex[i][0], ay = ex[i][1], bx = ex[i][2], by = ex[i][3];
+            const long long A = by - ay;
+            const long long B = -(bx - ax);
+            const long long C = bx * ay - by * ax;
+            const bool top_left = (by - ay < 0) || (by == ay && bx - ax < 0);
+            const long long t = top_left ? 0 : 1;
+
+            // Meio pixel: exato em ponto fixo; em pixels inteiros, o viés (A >> 1) + (B >> 1).
+            const long long center = unit == 1 ? (A >> 1) + (B >> 1) : (A + B) * (unit / 2);
+
+            // sign * E(minx + 0.5, miny + 0.5) - t e suas variações por pixel e por linha.
+            const long long N0 = sign * (A * minx * unit + B * miny * unit + C + center) - t;
+            const long long D = sign * B * unit;
+            const long long sA = sign * A * unit;
+            EdgeBound& e = bounds[i];
+
+            if (sA == 0) {
+                e.kind = 0;
+                e.value = N0;
+                e.step = D;
+                continue;
+            }
 
-    bool e0_top = is_top_left(x1,y1, x2,y2); // oposta a v0
-    bool e1_top = is_top_left(x2,y2, x0,y0); // oposta a v1
-    bool e2_top = is_top_left(x0,y0, x1,y1); // oposta a v2
-
-    // Coeficientes integrais da edge function: E(P)=A*x + B*y + C
-    struct EC { long long A,B,C; };
-    auto coeffs = [](int ax,int ay,int bx,int by) -> EC {
-        EC c;
-        c.A = (long long)(by - ay);
-        c.B = (long long)-(bx - ax);
-        // C = bx*ay - by*ax  (forma compatível com A,B acima)
-        c.C = (long long)bx * ay - (long long)by * ax;
-        return c;
-    };
+            // sA > 0: k >= -floor(N / sA) (limite esquerdo, guardado negado);
+            // sA < 0: k <= floor(N / -sA) (limite direito).
+            e.kind = sA > 0 ? 1 : -1;
+            e.den = sA > 0 ? sA : -sA;
+            e.q = floor_div(N0, e.den);
+            e.r = N0 - e.q * e.den;
+            e.dq = floor_div(D, e.den);
+            e.dr = D - e.dq * e.den;
+        }
 
-    EC e0 = coeffs(x1,y1, x2,y2);
-    EC e1 = coeffs(x2,y2, x0,y0);
-    EC e2 = coeffs(x0,y0, x1,y1);
+        return true;
+    }
 
-    // Bias para amostrar no centro do pixel: (A*0.5 + B*0.5)
-    auto center_bias = [](const EC& e) -> long long {
-        // como A e B são inteiros, A/2 + B/2 em aritmética inteira truncada funciona
-        // (usar 64 bits evita overflow)
-        return (e.A >> 1) + (e.B >> 1);
-    };
-    long long bias0 = center_bias(e0);
-    long long bias1 = center_bias(e1);
-    long long bias2 = center_bias(e2);
-
-    for (int y = miny; y <= maxy; ++y) {
-        // E(minx + 0.5, y + 0.5) = A*minx + B*y + C + (A/2 + B/2)
-        long long E0 = e0.A * (long long)minx + e0.B * (long long)y + e0.C + bias0;
-        long long E1 = e1.A * (long long)minx + e1.B * (long long)y + e1.C + bias1;
-        long long E2 = e2.A * (long long)minx + e2.B * (long long)y + e2.C + bias2;
-
-        for (int x = minx; x <= maxx; ++x) {
-            if (area2 > 0) {
-                bool c0 = (E0 > 0) || (E0 == 0 && e0_top);
-                bool c1 = (E1 > 0) || (E1 == 0 && e1_top);
-                bool c2 = (E2 > 0) || (E2 == 0 && e2_top);
-                if (c0 && c1 && c2)
-                    Primitives::set_pixel(surface, x, y, color);
-            } else {
-                bool c0 = (E0 < 0) || (E0 == 0 && e0_top);
-                bool c1 = (E1 < 0) || (E1 == 0 && e1_top);
-                bool c2 = (E2 < 0) || (E2 == 0 && e2_top);
-                if (c0 && c1 && c2)
-                    Primitives::set_pixel(surface, x, y, color);
+    // Intervalo coberto na linha atual (vazio se x_lo > x_hi) e avanço para a próxima.
+    void next_row(int* x_lo, int* x_hi) {
+        long long k_lo = 0;
+        long long k_hi = maxx - minx;
+
+        for (int i = 0; i < 3; ++i) {
+            EdgeBound& e = bounds[i];
+
+            if (e.kind == 0) {
+                if (e.value < 0) k_hi = -1;
+                e.value += e.step;
+                continue;
             }
 
-            // próximo pixel em X: E += A
-            E0 += e0.A; E1 += e1.A; E2 += e2.A;
+            if (e.kind > 0) k_lo = std::max(k_lo, -e.q);
+            else            k_hi = std::min(k_hi, e.q);
+
+            // Vai-um sem desvio: com vértices fora da grade de pixels ele é irregular e
+            // o desvio seria mal previsto.
+            e.r += e.dr;
+            const long long carry = e.r >= e.den ? 1 : 0;
+            e.q += e.dq + carry;
+            e.r -= e.den & -carry;
+        }
+
+        if (k_lo > k_hi) {
+            *x_lo = minx;
+            *x_hi = minx - 1;
+        } else {
+            *x_lo = minx + (int)k_lo;
+            *x_hi = minx + (int)k_hi;
         }
     }
-}
+};
+
+
+// Preenche um triângulo com vértices em unidades de 1/unit pixel (ver TriangleRows::setup).
+template <class Format>
+void Primitives::fill_triangle(const PixelFormat::Writer<Format>& out, const long long v[6], long long unit) {
+    TriangleRows rows;
+    bool degenerate = false;
+
+    if (!rows.setup(out.clip, v, unit, &degenerate)) {
+        if (degenerate) {
+            // Triângulo degenerado: desenha as arestas entre os pixels dos vértices
+            int px[3], py[3];
+            for (int i = 0; i < 3; ++i) {
+                px[i] = (int)TriangleRows::floor_div(v[2 * i], unit);
+                py[i] = (int)TriangleRows::floor_div(v[2 * i + 1], unit);
+            }
+            Primitives::draw_bresenham_line(out, px[0], py[0], px[1], py[1]);
+            Primitives::draw_bresenham_line(out, px[1], py[1], px[2], py[2]);
+            Primitives::draw_bresenham_line(out, px[2], py[2], px[0], py[0]);
+        }
+        return;
+    }
 
-void Primitives::draw_rectangle(SDL_Surface* surface,
-                                int x0, int y0,
-                                int x1, int y1,
-                                int x2, int y2,
-                                int x3, int y3,
-                                Uint32 color)
-{
-    if (!surface) return;
+    for (int y = rows.miny; y <= rows.maxy; ++y) {
+        int x_lo, x_hi;
+        rows.next_row(&x_lo, &x_hi);
+        out.fill_span(x_lo, x_hi, y);
+    }
+}
 
-    // Coloca em arrays para facilitar o manuseio por índice.
-    int xs[4] = { x0, x1, x2, x3 };
-    int ys[4] = { y0, y1, y2, y3 };
 
+// Preenche um quadrilátero convexo (retângulo) com vértices em unidades de 1/unit pixel.
+template <class Format>
+void Primitives::fill_quad(const PixelFormat::Writer<Format>& out, const long long xs[4], const long long ys[4], long long unit) {
     // Escolhe a diagonal: o par com maior distância ao quadrado.
     auto d2 = [&](int i, int j) -> long long {
-        long long dx = (long long)xs[i] - (long long)xs[j];
-        long long dy = (long long)ys[i] - (long long)ys[j];
+        long long dx = xs[i] - xs[j];
+        long long dy = ys[i] - ys[j];
         return dx*dx + dy*dy;
     };
 
@@ -1042,15 +1621,226 @@ void Primitives::draw_rectangle(SDL_Surface* surface,
 
     // Triangula sempre pela diagonal (di)-(dj).
     // Isso cobre o retângulo inteiro sem buracos, independentemente da ordem de entrada.
-    Primitives::draw_triangle(surface,
-                              xs[di], ys[di],
-                              xs[others[0]], ys[others[0]],
-                              xs[dj], ys[dj],
-                              color);
-
-    Primitives::draw_triangle(surface,
-                              xs[di], ys[di],
-                              xs[dj], ys[dj],
-                              xs[others[1]], ys[others[1]],
-                              color);
+    const long long first_v[6] = { xs[di], ys[di], xs[others[0]], ys[others[0]], xs[dj], ys[dj] };
+    const long long second_v[6] = { xs[di], ys[di], xs[dj], ys[dj], xs[others[1]], ys[others[1]] };
+
+    TriangleRows first, second;
+    bool first_degenerate = false, second_degenerate = false;
+    const bool first_visible = first.setup(out.clip, first_v, unit, &first_degenerate);
+    const bool second_visible = second.setup(out.clip, second_v, unit, &second_degenerate);
+
+    if (first_degenerate || second_degenerate) {
+        Primitives::fill_triangle(out, first_v, unit);
+        Primitives::fill_triangle(out, second_v, unit);
+        return;
+    }
+    if (!first_visible && !second_visible) return;
+
+    // As duas metades são percorridas juntas: numa linha em que os intervalos se tocam
+    // (pela regra top-left, a diagonal fica com um só dos lados), sai um único span.
+    const int y_start = std::min(first_visible ? first.miny : INT_MAX, second_visible ? second.miny : INT_MAX);
+    const int y_end = std::max(first_visible ? first.maxy : INT_MIN, second_visible ? second.maxy : INT_MIN);
+
+    for (int y = y_start; y <= y_end; ++y) {
+        int a_lo = 0, a_hi = -1, b_lo = 0, b_hi = -1;
+        if (first_visible && y >= first.miny && y <= first.maxy) first.next_row(&a_lo, &a_hi);
+        if (second_visible && y >= second.miny && y <= second.maxy) second.next_row(&b_lo, &b_hi);
+
+        if (a_lo <= a_hi && b_lo <= b_hi && b_lo <= a_hi + 1 && a_lo <= b_hi + 1) {
+            out.fill_span(std::min(a_lo, b_lo), std::max(a_hi, b_hi), y);
+        } else {
+            out.fill_span(a_lo, a_hi, y);
+            out.fill_span(b_lo, b_hi, y);
+        }
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Fills a triangle, one span per row.
+ *
+ * The covered interval of each row comes straight from the three edge functions,
+ * stepped incrementally from row to row, so no pixel of the bounding box is tested
+ * individually and fully covered parts of the row are written by the span kernel.
+ * Pixels are sampled at their centers with the top-left rule: a pixel on an edge
+ * shared by two triangles is drawn by exactly one of them.
+ *
+ * @param surface Pointer to the SDL_Surface where the triangle will be drawn.
+ * @param x0, y0  First vertex.
+ * @param x1, y1  Second vertex.
+ * @param x2, y2  Third vertex.
+ * @param color   Canvas color (CanvasFormat).
+ */
+void Primitives::draw_triangle(SDL_Surface* surface,
+                                      int x0, int y0,
+                                      int x1, int y1,
+                                      int x2, int y2,
+                                      Uint32 color)
+{
+    if (!surface) return;
+
+    const long long v[6] = { x0, y0, x1, y1, x2, y2 };
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        Primitives::fill_triangle(out, v, 1);
+    });
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Fills a triangle given in 24.8 fixed-point canvas coordinates.
+ *
+ * Same rasterizer as the integer version, with the vertices kept at 1/256 px: the
+ * edge functions, the pixel-center samples and the row stepping are all exact
+ * 64-bit integer arithmetic, so the result does not depend on the compiler or on
+ * how the canvas is split into tiles.
+ *
+ * @param surface    Pointer to the SDL_Surface where the triangle will be drawn.
+ * @param v0, v1, v2 Vertices (see FixedPoint).
+ * @param color      Canvas color (CanvasFormat).
+ */
+void Primitives::draw_triangle(SDL_Surface* surface, FixedPoint::Vertex v0, FixedPoint::Vertex v1, FixedPoint::Vertex v2, Uint32 color) {
+    if (!surface) return;
+
+    const long long v[6] = { v0.x, v0.y, v1.x, v1.y, v2.x, v2.y };
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        Primitives::fill_triangle(out, v, FixedPoint::one);
+    });
+}
+
+
+void Primitives::draw_rectangle(SDL_Surface* surface,
+                                int x0, int y0,
+                                int x1, int y1,
+                                int x2, int y2,
+                                int x3, int y3,
+                                Uint32 color)
+{
+    if (!surface) return;
+
+    // Coloca em arrays para facilitar o manuseio por índice.
+    const long long xs[4] = { x0, x1, x2, x3 };
+    const long long ys[4] = { y0, y1, y2, y3 };
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        Primitives::fill_quad(out, xs, ys, 1);
+    });
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Fills a rectangle (any convex quadrilateral, corners in any order) given in
+ * 24.8 fixed-point canvas coordinates. See the fixed-point draw_triangle.
+ */
+void Primitives::draw_rectangle(SDL_Surface* surface, FixedPoint::Vertex v0, FixedPoint::Vertex v1, FixedPoint::Vertex v2, FixedPoint::Vertex v3, Uint32 color) {
+    if (!surface) return;
+
+    const long long xs[4] = { v0.x, v1.x, v2.x, v3.x };
+    const long long ys[4] = { v0.y, v1.y, v2.y, v3.y };
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        Primitives::fill_quad(out, xs, ys, FixedPoint::one);
+    });
+}
+
+
+// Cobertura (0-255) dos pixels x0..x0+count-1 da linha y num retângulo de cantos
+// arredondados. As bordas retas caem entre pixels (coordenadas inteiras), então só os
+// pixels dos cantos têm cobertura parcial: 0.5 menos a distância do centro do pixel ao arco.
+static void rounded_rect_row(const SDL_Rect& box, int radius, int y, int x0, int count, Uint8* coverage) {
+    const int left = std::max(box.x, x0);
+    const int right = std::min(box.x + box.w, x0 + count);
+
+    if (box.w <= 0 || box.h <= 0 || y < box.y || y >= box.y + box.h || left >= right) {
+        memset(coverage, 0, count);
+        return;
+    }
+
+    memset(coverage, 0, left - x0);
+    memset(coverage + (left - x0), 255, right - left);
+    memset(coverage + (right - x0), 0, x0 + count - right);
+
+    // Linhas fora das faixas dos cantos ficam inteiras.
+    const double py = y + 0.5;
+    double dy;
+    if (py < box.y + radius) {
+        dy = box.y + radius - py;
+    } else if (py > box.y + box.h - radius) {
+        dy = py - (box.y + box.h - radius);
+    } else {
+        return;
+    }
+
+    // Colunas dos cantos esquerdo e direito.
+    const int corner_columns[2][2] = { {left, std::min(right, box.x + radius)},
+                                       {std::max(left, box.x + box.w - radius), right} };
+
+    for (const auto& columns : corner_columns) {
+        for (int x = columns[0]; x < columns[1]; ++x) {
+            const double px = x + 0.5;
+            const double dx = px < box.x + radius ? box.x + radius - px : px - (box.x + box.w - radius);
+            if (dx <= 0.0) continue;
+
+            const double distance = std::sqrt(dx * dx + dy * dy) - radius;
+            coverage[x - x0] = CoverageBlender::to_coverage((float)(0.5 - distance));
+        }
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Draws an anti-aliased rounded rectangle, filled or as a border, straight into
+ * the surface (for the interface components).
+ *
+ * The straight edges are pixel aligned; the corners are quarter circles whose coverage
+ * comes from the distance of each pixel center to the arc. A border is the rectangle
+ * minus the same rectangle inset by its thickness, with the radius reduced to match.
+ *
+ * @param surface          Destination surface (clipped to its clip rectangle).
+ * @param rect             Outer bounds of the rectangle.
+ * @param radius           Corner radius, limited to half the shorter side.
+ * @param color            Straight-alpha color; translucent colors are blended.
+ * @param border_thickness Thickness of the border, or 0 to fill the rectangle.
+ */
+void Primitives::draw_rounded_rect(SDL_Surface* surface, const SDL_Rect& rect, int radius, SDL_Color color, int border_thickness) {
+    if (!surface || rect.w <= 0 || rect.h <= 0) return;
+
+    PixelFormat::dispatch(surface, CanvasFormat::pack(color), [&](const auto& out) {
+        Primitives::draw_rounded_rect(out, rect, radius, border_thickness);
+    });
+}
+
+
+// Núcleo de draw_rounded_rect para um formato de pixel.
+template <class Format>
+void Primitives::draw_rounded_rect(const PixelFormat::Writer<Format>& out, const SDL_Rect& rect, int radius, int border_thickness) {
+    SDL_Rect area;
+    if (!SDL_IntersectRect(&rect, &out.clip, &area)) return;
+
+    radius = std::max(0, std::min(radius, std::min(rect.w, rect.h) / 2));
+
+    // Borda: cobertura do retângulo menos a do retângulo interno.
+    const SDL_Rect inner = { rect.x + border_thickness, rect.y + border_thickness,
+                             rect.w - 2 * border_thickness, rect.h - 2 * border_thickness };
+    const int inner_radius = std::max(0, radius - border_thickness);
+    const bool ring = border_thickness > 0 && inner.w > 0 && inner.h > 0;
+
+    // Buffers reaproveitados entre chamadas (um por thread).
+    static thread_local std::vector<Uint8> outer_row, inner_row;
+    outer_row.resize(area.w);
+    inner_row.resize(area.w);
+
+    for (int y = area.y; y < area.y + area.h; ++y) {
+        rounded_rect_row(rect, radius, y, area.x, area.w, outer_row.data());
+
+        if (ring) {
+            rounded_rect_row(inner, inner_radius, y, area.x, area.w, inner_row.data());
+            for (int i = 0; i < area.w; ++i) {
+                outer_row[i] = outer_row[i] > inner_row[i] ? outer_row[i] - inner_row[i] : 0;
+            }
+        }
+
+        out.blend_run(y, area.x, outer_row.data(), area.w);
+    }
 }
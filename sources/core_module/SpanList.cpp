@@ -0,0 +1,73 @@
+// INCLUDES
+#include "SpanList.h"
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Removes every span. The memory is kept, so a reused list does not allocate again.
+ */
+void SpanList::clear() {
+    this->spans.clear();
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Appends the run [x0, x1] of row y. Empty runs (x1 < x0) are ignored.
+ */
+void SpanList::add(int y, int x0, int x1) {
+    if (x1 < x0) return;
+    this->spans.push_back({y, x0, x1});
+}
+
+
+// METHOD IMPLEMENTATION
+bool SpanList::empty() const {
+    return this->spans.empty();
+}
+
+
+// METHOD IMPLEMENTATION
+const std::vector<SpanList::Span>& SpanList::get_spans() const {
+    return this->spans;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Smallest rectangle containing every span ({0, 0, 0, 0} for an empty list).
+ */
+SDL_Rect SpanList::get_bounds() const {
+    if (this->spans.empty()) return {0, 0, 0, 0};
+
+    int x_min = this->spans[0].x0, x_max = this->spans[0].x1;
+    int y_min = this->spans[0].y, y_max = this->spans[0].y;
+
+    for (const Span& span : this->spans) {
+        x_min = std::min(x_min, span.x0);
+        x_max = std::max(x_max, span.x1);
+        y_min = std::min(y_min, span.y);
+        y_max = std::max(y_max, span.y);
+    }
+
+    return {x_min, y_min, x_max - x_min + 1, y_max - y_min + 1};
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Fills every span with one color, clipped to the surface clip rectangle.
+ *
+ * The pixel layout of the surface is looked up once for the whole list.
+ *
+ * @param surface Destination surface (any layout supported by PixelFormat).
+ * @param color   Canvas color (CanvasFormat).
+ * @param dx, dy  Offset added to every span, for a cached list whose shape has moved.
+ */
+void SpanList::fill(SDL_Surface* surface, Uint32 color, int dx, int dy) const {
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        for (const Span& span : this->spans) {
+            out.fill_span(span.x0 + dx, span.x1 + dx, span.y + dy);
+        }
+    });
+}
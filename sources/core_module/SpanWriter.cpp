@@ -0,0 +1,150 @@
+// INCLUDES
+#include "App.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define SPAN_WRITER_X86 1
+    #include <immintrin.h>
+#endif
+
+
+// Runs shorter than this are written by the scalar loop: setting up the vector
+// registers and the alignment head costs more than it saves.
+static const int min_vector_span = 8;
+
+
+#ifdef SPAN_WRITER_X86
+// 16-byte stores. The head is written pixel by pixel until the pointer is aligned.
+__attribute__((target("sse2")))
+static void fill_row_sse2(Uint32* row, int x0, int x1, Uint32 color) {
+    Uint32* p = row + x0;
+    Uint32* end = row + x1 + 1;
+
+    if (end - p < min_vector_span) {
+        while (p < end) *p++ = color;
+        return;
+    }
+
+    while (((uintptr_t)p & 15) != 0) *p++ = color;
+
+    const __m128i value = _mm_set1_epi32((int)color);
+    for (; end - p >= 8; p += 8) {
+        _mm_store_si128((__m128i*)p, value);
+        _mm_store_si128((__m128i*)(p + 4), value);
+    }
+    if (end - p >= 4) {
+        _mm_store_si128((__m128i*)p, value);
+        p += 4;
+    }
+
+    while (p < end) *p++ = color;
+}
+
+
+// 32-byte stores, same structure as the SSE2 kernel.
+__attribute__((target("avx2")))
+static void fill_row_avx2(Uint32* row, int x0, int x1, Uint32 color) {
+    Uint32* p = row + x0;
+    Uint32* end = row + x1 + 1;
+
+    if (end - p < min_vector_span) {
+        while (p < end) *p++ = color;
+        return;
+    }
+
+    while (((uintptr_t)p & 31) != 0) *p++ = color;
+
+    const __m256i value = _mm256_set1_epi32((int)color);
+    for (; end - p >= 16; p += 16) {
+        _mm256_store_si256((__m256i*)p, value);
+        _mm256_store_si256((__m256i*)(p + 8), value);
+    }
+    if (end - p >= 8) {
+        _mm256_store_si256((__m256i*)p, value);
+        p += 8;
+    }
+    if (end - p >= 4) {
+        _mm_store_si128((__m128i*)p, _mm256_castsi256_si128(value));
+        p += 4;
+    }
+
+    while (p < end) *p++ = color;
+}
+#endif
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Fills the pixels [x0, x1] of a row with one color.
+ *
+ * The range must already be clipped to the surface: no bounds are checked here.
+ *
+ * @param row   Pointer to the first pixel of the row (32-bit pixels).
+ * @param x0    First pixel of the run.
+ * @param x1    Last pixel of the run (inclusive). Nothing is written if x1 < x0.
+ * @param color Color in the surface format.
+ */
+void SpanWriter::fill_row(Uint32* row, int x0, int x1, Uint32 color) {
+    if (x1 < x0) return;
+    SpanWriter::get_kernel().fill_row(row, x0, x1, color);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Portable kernel, used when no vector kernel is available.
+ * Also kept public as the reference for the benchmark.
+ */
+void SpanWriter::fill_row_scalar(Uint32* row, int x0, int x1, Uint32 color) {
+    for (int x = x0; x <= x1; ++x) {
+        row[x] = color;
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Fills a rectangle of a 32-bit surface, row by row, with the span kernel.
+ *
+ * @param surface Destination surface. The rectangle is clipped to surface->clip_rect.
+ * @param rect    Area to fill.
+ * @param color   Color in the surface format.
+ */
+void SpanWriter::fill_rect(SDL_Surface* surface, const SDL_Rect& rect, Uint32 color) {
+    if (!surface || surface->format->BytesPerPixel != 4) return;
+
+    SDL_Rect area;
+    if (!SDL_IntersectRect(&rect, &surface->clip_rect, &area)) return;
+
+    const RowKernel kernel = SpanWriter::get_kernel().fill_row;
+    Uint8* base = (Uint8*)surface->pixels;
+
+    for (int y = area.y; y < area.y + area.h; ++y) {
+        kernel((Uint32*)(base + y * surface->pitch), area.x, area.x + area.w - 1, color);
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+const char* SpanWriter::get_kernel_name() {
+    return SpanWriter::get_kernel().name;
+}
+
+
+// METHOD IMPLEMENTATION
+const SpanWriter::Kernel& SpanWriter::get_kernel() {
+    static const Kernel kernel = SpanWriter::select_kernel();
+    return kernel;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Picks the widest kernel supported by the running CPU.
+ */
+SpanWriter::Kernel SpanWriter::select_kernel() {
+#ifdef SPAN_WRITER_X86
+    if (SDL_HasAVX2()) return {fill_row_avx2, "avx2"};
+    if (SDL_HasSSE2()) return {fill_row_sse2, "sse2"};
+#endif
+    return {SpanWriter::fill_row_scalar, "scalar"};
+}
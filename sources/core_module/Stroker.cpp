@@ -0,0 +1,447 @@
+// INCLUDES
+#include <climits>
+#include "App.h"
+
+
+// Band evaluated around each piece, in pixels. Coverage is zero beyond half a pixel
+// outside the stroke; the extra half pixel absorbs rounding of the row ranges.
+static const float band = 1.0f;
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Anti-aliased stroke with round joins and caps (miter limit 4, for MITER joins).
+ */
+Stroker::Style Stroker::default_style(float width) {
+    Style style;
+    style.width = width;
+    style.join = Join::ROUND;
+    style.cap = Cap::ROUND;
+    style.miter_limit = 4.0f;
+    style.anti_aliasing = true;
+    return style;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Signed distance from (px, py) to the piece: negative inside, positive outside.
+ *
+ * Exact for boxes and disks. For polygons it is the largest distance to an edge line,
+ * exact inside and along the edges, slightly short near the outer corners.
+ */
+float Stroker::Piece::distance(float px, float py) const {
+    switch (this->kind) {
+        case PieceKind::BOX: {
+            const float dx = this->bx - this->ax, dy = this->by - this->ay;
+            const float length = std::sqrt(dx * dx + dy * dy);
+            const float half = 0.5f * length;
+            const float rx = px - this->ax, ry = py - this->ay;
+
+            // Coordinates along the segment (from its middle) and across it.
+            const float u = (rx * dx + ry * dy) / length - half;
+            const float v = (rx * dy - ry * dx) / length;
+            const float qx = std::fabs(u) - half;
+            const float qy = std::fabs(v) - this->radius;
+            const float ox = std::max(qx, 0.0f), oy = std::max(qy, 0.0f);
+
+            return std::sqrt(ox * ox + oy * oy) + std::min(std::max(qx, qy), 0.0f);
+        }
+        case PieceKind::DISK: {
+            const float dx = px - this->ax, dy = py - this->ay;
+            return std::sqrt(dx * dx + dy * dy) - this->radius;
+        }
+        default: {
+            float d = -INFINITY;
+            for (int i = 0; i < this->count; ++i) {
+                d = std::max(d, this->nx[i] * px + this->ny[i] * py - this->c[i]);
+            }
+            return d;
+        }
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Horizontal extent of the piece's band on the line y = py.
+ *
+ * @return False if the band does not reach that line.
+ */
+bool Stroker::Piece::row_range(float py, float* x0, float* x1) const {
+    if (py < this->min_y || py > this->max_y) return false;
+
+    switch (this->kind) {
+        case PieceKind::BOX: {
+            // Crossings of the line with the edges of the widened box (a convex quad).
+            bool found = false;
+            for (int i = 0; i < 4; ++i) {
+                const int j = (i + 1) & 3;
+                const float yi = this->corner_y[i], yj = this->corner_y[j];
+                if ((yi < py && yj < py) || (yi > py && yj > py)) continue;
+
+                float x = this->corner_x[i];
+                if (yi != yj) x += (py - yi) * (this->corner_x[j] - this->corner_x[i]) / (yj - yi);
+
+                *x0 = found ? std::min(*x0, x) : x;
+                *x1 = found ? std::max(*x1, x) : x;
+                found = true;
+            }
+            return found;
+        }
+        case PieceKind::DISK: {
+            const float r = this->radius + band;
+            const float dy = py - this->ay;
+            const float h = std::sqrt(std::max(r * r - dy * dy, 0.0f));
+            *x0 = this->ax - h;
+            *x1 = this->ax + h;
+            return true;
+        }
+        default:
+            // Joins are a few pixels wide: their bounding box is tight enough.
+            *x0 = this->min_x;
+            *x1 = this->max_x;
+            return true;
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Adds the butt-ended box of half width 'radius' around the segment a-b.
+ */
+void Stroker::add_box(std::vector<Piece>& pieces, SDL_FPoint a, SDL_FPoint b, float radius) {
+    Piece piece;
+    piece.kind = PieceKind::BOX;
+    piece.ax = a.x;
+    piece.ay = a.y;
+    piece.bx = b.x;
+    piece.by = b.y;
+    piece.radius = radius;
+    piece.count = 0;
+
+    const float dx = b.x - a.x, dy = b.y - a.y;
+    const float length = std::sqrt(dx * dx + dy * dy);
+    const float ux = dx / length, uy = dy / length;
+    const float w = radius + band;
+
+    // Box widened by the band on every side, in order around it.
+    const float sx[4] = {a.x - ux * band, b.x + ux * band, b.x + ux * band, a.x - ux * band};
+    const float sy[4] = {a.y - uy * band, b.y + uy * band, b.y + uy * band, a.y - uy * band};
+    const float side[4] = {1.0f, 1.0f, -1.0f, -1.0f};
+
+    for (int i = 0; i < 4; ++i) {
+        piece.corner_x[i] = sx[i] - uy * w * side[i];
+        piece.corner_y[i] = sy[i] + ux * w * side[i];
+    }
+
+    piece.min_x = *std::min_element(piece.corner_x, piece.corner_x + 4);
+    piece.max_x = *std::max_element(piece.corner_x, piece.corner_x + 4);
+    piece.min_y = *std::min_element(piece.corner_y, piece.corner_y + 4);
+    piece.max_y = *std::max_element(piece.corner_y, piece.corner_y + 4);
+
+    pieces.push_back(piece);
+}
+
+
+// METHOD IMPLEMENTATION
+void Stroker::add_disk(std::vector<Piece>& pieces, SDL_FPoint center, float radius) {
+    Piece piece;
+    piece.kind = PieceKind::DISK;
+    piece.ax = piece.bx = center.x;
+    piece.ay = piece.by = center.y;
+    piece.radius = radius;
+    piece.count = 0;
+    piece.min_x = center.x - radius - band;
+    piece.max_x = center.x + radius + band;
+    piece.min_y = center.y - radius - band;
+    piece.max_y = center.y + radius + band;
+
+    pieces.push_back(piece);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Adds a convex polygon of up to max_polygon vertices, in either winding.
+ */
+void Stroker::add_polygon(std::vector<Piece>& pieces, const SDL_FPoint* vertices, int count) {
+    Piece piece;
+    piece.kind = PieceKind::POLYGON;
+    piece.ax = piece.bx = vertices[0].x;
+    piece.ay = piece.by = vertices[0].y;
+    piece.radius = 0.0f;
+    piece.count = 0;
+
+    float cx = 0.0f, cy = 0.0f;
+    for (int i = 0; i < count; ++i) {
+        cx += vertices[i].x / count;
+        cy += vertices[i].y / count;
+    }
+
+    piece.min_x = piece.max_x = vertices[0].x;
+    piece.min_y = piece.max_y = vertices[0].y;
+
+    for (int i = 0; i < count; ++i) {
+        const SDL_FPoint p = vertices[i], q = vertices[(i + 1) % count];
+        piece.min_x = std::min(piece.min_x, p.x);
+        piece.max_x = std::max(piece.max_x, p.x);
+        piece.min_y = std::min(piece.min_y, p.y);
+        piece.max_y = std::max(piece.max_y, p.y);
+
+        float nx = q.y - p.y, ny = p.x - q.x;
+        const float length = std::sqrt(nx * nx + ny * ny);
+        if (length < 1e-6f) continue;
+        nx /= length;
+        ny /= length;
+
+        // Outward normal: the centroid is on the negative side.
+        float c = nx * p.x + ny * p.y;
+        if (nx * cx + ny * cy > c) {
+            nx = -nx;
+            ny = -ny;
+            c = -c;
+        }
+
+        piece.nx[piece.count] = nx;
+        piece.ny[piece.count] = ny;
+        piece.c[piece.count] = c;
+        piece.count++;
+    }
+
+    if (piece.count < 3) return;
+
+    piece.min_x -= band;
+    piece.max_x += band;
+    piece.min_y -= band;
+    piece.max_y += band;
+
+    pieces.push_back(piece);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Adds the join between a segment arriving at 'vertex' with direction d0 and one
+ * leaving it with direction d1 (both unit vectors).
+ *
+ * The boxes of the two segments already overlap on the inner side of the turn; the
+ * join fills the wedge left open on the outer side. A wedge that only touched the box
+ * ends would leave a seam at half coverage along them, so it reaches 'overlap' pixels
+ * back into each box, along the box's outer edge.
+ */
+void Stroker::add_join(std::vector<Piece>& pieces, SDL_FPoint vertex, SDL_FPoint d0, SDL_FPoint d1, float overlap, const Style& style) {
+    const float radius = 0.5f * style.width;
+
+    if (style.join == Join::ROUND) {
+        Stroker::add_disk(pieces, vertex, radius);
+        return;
+    }
+
+    const float cross = d0.x * d1.y - d0.y * d1.x;
+    const float dot = d0.x * d1.x + d0.y * d1.y;
+    if (std::fabs(cross) < 1e-6f) return;      // Straight on, or a full turn back (no outer side).
+
+    // Normals pointing to the outer side of the turn.
+    const float side = cross > 0.0f ? -1.0f : 1.0f;
+    const SDL_FPoint n0 = {-d0.y * side, d0.x * side};
+    const SDL_FPoint n1 = {-d1.y * side, d1.x * side};
+    const SDL_FPoint p0 = {vertex.x + n0.x * radius, vertex.y + n0.y * radius};
+    const SDL_FPoint p1 = {vertex.x + n1.x * radius, vertex.y + n1.y * radius};
+
+    // Outline: back along the first box, the outer corners, forward along the second box.
+    SDL_FPoint outline[max_polygon];
+    int count = 0;
+    outline[count++] = {vertex.x - d0.x * overlap, vertex.y - d0.y * overlap};
+    outline[count++] = {p0.x - d0.x * overlap, p0.y - d0.y * overlap};
+    outline[count++] = p0;
+
+    // The normals turn by the same angle as the directions: n0 . n1 = d0 . d1.
+    if (style.join == Join::MITER) {
+        const float cos_half = std::sqrt(std::max(0.0f, 0.5f * (1.0f + dot)));
+        if (cos_half > 1e-6f && 1.0f / cos_half <= style.miter_limit) {
+            const float scale = radius / (1.0f + dot);
+            outline[count++] = {vertex.x + (n0.x + n1.x) * scale, vertex.y + (n0.y + n1.y) * scale};
+        }
+    }
+
+    outline[count++] = p1;
+    outline[count++] = {p1.x + d1.x * overlap, p1.y + d1.y * overlap};
+    outline[count++] = {vertex.x + d1.x * overlap, vertex.y + d1.y * overlap};
+
+    Stroker::add_polygon(pieces, outline, count);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Strokes a polyline.
+ *
+ * @param surface Destination surface (any layout supported by PixelFormat).
+ * @param points  Vertices, in pixel-center coordinates. Repeated points are ignored.
+ * @param color   Canvas color (CanvasFormat).
+ * @param style   Width, join, cap, miter limit and anti-aliasing.
+ * @param closed  Join the last point back to the first (no caps).
+ *
+ * @return Rectangle of the pixels written (empty if none), for damage tracking.
+ */
+SDL_Rect Stroker::stroke_polyline(SDL_Surface* surface, const std::vector<SDL_FPoint>& points, Uint32 color, const Style& style, bool closed) {
+    SDL_Rect touched = {0, 0, 0, 0};
+    if (!surface || points.empty() || !(style.width > 0.0f)) return touched;
+
+    static thread_local std::vector<SDL_FPoint> path;
+    static thread_local std::vector<Piece> pieces;
+    static thread_local std::vector<int> order;
+    static thread_local std::vector<int> active;
+    static thread_local std::vector<Uint8> coverage_row;
+
+    path.clear();
+    pieces.clear();
+    for (const SDL_FPoint& p : points) {
+        if (path.empty() || p.x != path.back().x || p.y != path.back().y) path.push_back(p);
+    }
+    if (closed && path.size() > 1 && path.front().x == path.back().x && path.front().y == path.back().y) {
+        path.pop_back();
+    }
+    if (path.size() < 3) closed = false;
+
+    const float radius = 0.5f * style.width;
+    const size_t n = path.size();
+    const size_t segments = closed ? n : n - 1;
+
+    auto length = [&](size_t i) -> float {
+        const SDL_FPoint a = path[i], b = path[(i + 1) % n];
+        return std::sqrt((b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y));
+    };
+
+    auto direction = [&](size_t i) -> SDL_FPoint {
+        const SDL_FPoint a = path[i], b = path[(i + 1) % n];
+        const float l = length(i);
+        return {(b.x - a.x) / l, (b.y - a.y) / l};
+    };
+
+    // Joins overlap their boxes by a pixel, but never past the segments or the half width.
+    auto join = [&](size_t i, size_t before, size_t after) {
+        const float overlap = std::min(std::min(1.0f, radius), std::min(length(before), length(after)));
+        Stroker::add_join(pieces, path[i], direction(before), direction(after), overlap, style);
+    };
+
+    for (size_t i = 0; i < segments; ++i) {
+        Stroker::add_box(pieces, path[i], path[(i + 1) % n], radius);
+    }
+
+    if (closed) {
+        for (size_t i = 0; i < n; ++i) {
+            join(i, (i + n - 1) % n, i);
+        }
+    } else {
+        for (size_t i = 1; i + 1 < n; ++i) {
+            join(i, i - 1, i);
+        }
+        if (style.cap == Cap::ROUND) {
+            Stroker::add_disk(pieces, path.front(), radius);
+            if (n > 1) Stroker::add_disk(pieces, path.back(), radius);
+        }
+    }
+
+    if (pieces.empty()) return touched;
+
+    // Rows and columns reached by any band, clipped.
+    float min_x = pieces[0].min_x, max_x = pieces[0].max_x, min_y = pieces[0].min_y, max_y = pieces[0].max_y;
+    for (const Piece& piece : pieces) {
+        min_x = std::min(min_x, piece.min_x);
+        max_x = std::max(max_x, piece.max_x);
+        min_y = std::min(min_y, piece.min_y);
+        max_y = std::max(max_y, piece.max_y);
+    }
+
+    const SDL_Rect& clip = surface->clip_rect;
+    const int x_lo = std::max((int)std::ceil(min_x), clip.x);
+    const int x_hi = std::min((int)std::floor(max_x), clip.x + clip.w - 1);
+    const int y_lo = std::max((int)std::ceil(min_y), clip.y);
+    const int y_hi = std::min((int)std::floor(max_y), clip.y + clip.h - 1);
+    if (x_lo > x_hi || y_lo > y_hi) return touched;
+
+    // Pieces enter the active list at their first row (same scheme as fill_polygon).
+    order.resize(pieces.size());
+    for (size_t i = 0; i < pieces.size(); ++i) order[i] = (int)i;
+    std::sort(order.begin(), order.end(), [](int a, int b) { return pieces[a].min_y < pieces[b].min_y; });
+
+    active.clear();
+    coverage_row.assign(x_hi - x_lo + 1, 0);
+
+    size_t next_piece = 0;
+    int touched_x0 = INT_MAX, touched_x1 = INT_MIN, touched_y0 = INT_MAX, touched_y1 = INT_MIN;
+
+    // The rows are written in the layout of the surface, chosen once (see PixelFormat).
+    PixelFormat::dispatch(surface, color, [&](const auto& out) {
+        for (int y = y_lo; y <= y_hi; ++y) {
+            const float py = (float)y;
+
+            while (next_piece < order.size() && pieces[order[next_piece]].min_y <= py) {
+                active.push_back(order[next_piece++]);
+            }
+
+            size_t kept = 0;
+            for (size_t i = 0; i < active.size(); ++i) {
+                if (pieces[active[i]].max_y >= py) active[kept++] = active[i];
+            }
+            active.resize(kept);
+
+            // Union of the pieces: the largest coverage of each pixel.
+            int row_x0 = x_hi + 1, row_x1 = x_lo - 1;
+            for (int index : active) {
+                const Piece& piece = pieces[index];
+                float fx0, fx1;
+                if (!piece.row_range(py, &fx0, &fx1)) continue;
+
+                const int x0 = std::max((int)std::ceil(fx0), x_lo);
+                const int x1 = std::min((int)std::floor(fx1), x_hi);
+                if (x0 > x1) continue;
+
+                row_x0 = std::min(row_x0, x0);
+                row_x1 = std::max(row_x1, x1);
+
+                for (int x = x0; x <= x1; ++x) {
+                    const float coverage = 0.5f - piece.distance((float)x, py);
+                    const Uint8 value = style.anti_aliasing ? CoverageBlender::to_coverage(coverage) : (coverage >= 0.5f ? 255 : 0);
+                    Uint8& slot = coverage_row[x - x_lo];
+                    if (value > slot) slot = value;
+                }
+            }
+
+            if (row_x0 > row_x1) continue;
+
+            // Trim the empty ends, for a tight damage rectangle.
+            while (row_x0 <= row_x1 && coverage_row[row_x0 - x_lo] == 0) row_x0++;
+            while (row_x1 >= row_x0 && coverage_row[row_x1 - x_lo] == 0) row_x1--;
+
+            if (row_x0 <= row_x1) {
+                out.blend_run(y, row_x0, &coverage_row[row_x0 - x_lo], row_x1 - row_x0 + 1);
+
+                touched_x0 = std::min(touched_x0, row_x0);
+                touched_x1 = std::max(touched_x1, row_x1);
+                touched_y0 = std::min(touched_y0, y);
+                touched_y1 = y;
+                std::fill(coverage_row.begin() + (row_x0 - x_lo), coverage_row.begin() + (row_x1 - x_lo + 1), (Uint8)0);
+            }
+        }
+    });
+
+    if (touched_x0 <= touched_x1) {
+        touched = {touched_x0, touched_y0, touched_x1 - touched_x0 + 1, touched_y1 - touched_y0 + 1};
+    }
+    return touched;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Strokes one segment (a polyline of two points).
+ */
+SDL_Rect Stroker::stroke_line(SDL_Surface* surface, float x0, float y0, float x1, float y1, Uint32 color, const Style& style) {
+    static thread_local std::vector<SDL_FPoint> points(2);
+    points[0] = {x0, y0};
+    points[1] = {x1, y1};
+    return Stroker::stroke_polyline(surface, points, color, style, false);
+}
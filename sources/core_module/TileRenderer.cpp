@@ -0,0 +1,285 @@
+// INCLUDES
+#include "TileRenderer.h"
+
+
+// CONSTRUCTOR IMPLEMENTATION
+/**
+ * @brief
+ * Creates the renderer and its worker threads.
+ *
+ * @param thread_count
+ * Number of threads that rasterize tiles, the calling thread included.
+ * Zero (or less) uses one thread per logical CPU.
+ */
+TileRenderer::TileRenderer(int thread_count) {
+    this->thread_count = 0;
+    this->tile_size = 0;
+    this->work_ready = SDL_CreateSemaphore(0);
+    this->work_done = SDL_CreateSemaphore(0);
+    this->quit = false;
+    this->surface = nullptr;
+    this->background = 0;
+    this->draw_item = nullptr;
+    SDL_AtomicSet(&this->next_tile, 0);
+    SDL_AtomicSet(&this->items_drawn, 0);
+
+    this->set_thread_count(thread_count);
+}
+
+
+// DESTRUCTOR IMPLEMENTATION
+TileRenderer::~TileRenderer() {
+    this->stop_workers();
+
+    for (Worker& worker : this->workers) {
+        if (worker.view) SDL_FreeSurface(worker.view);
+    }
+
+    SDL_DestroySemaphore(this->work_ready);
+    SDL_DestroySemaphore(this->work_done);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Changes the number of threads. The pool is stopped and started again, so
+ * this must not be called while render() is running.
+ *
+ * @param thread_count
+ * Number of threads, the calling thread included. Zero (or less) uses one
+ * thread per logical CPU; 1 renders every tile on the calling thread.
+ */
+void TileRenderer::set_thread_count(int thread_count) {
+    if (thread_count <= 0) thread_count = SDL_GetCPUCount();
+    thread_count = std::max(1, std::min(thread_count, 64));
+    if (thread_count == this->thread_count) return;
+
+    this->stop_workers();
+
+    for (size_t i = thread_count; i < this->workers.size(); ++i) {
+        if (this->workers[i].view) SDL_FreeSurface(this->workers[i].view);
+    }
+
+    // The threads keep a pointer to their Worker: the vector is resized before they start.
+    this->workers.resize(thread_count, {this, nullptr, nullptr});
+    this->thread_count = thread_count;
+
+    this->start_workers();
+}
+
+
+// METHOD IMPLEMENTATION
+int TileRenderer::get_thread_count() const {
+    return this->thread_count;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Sets the side of the square tiles, in pixels. Zero (or less) sizes the
+ * tiles from the thread count and the area of each render() call.
+ */
+void TileRenderer::set_tile_size(int tile_size) {
+    this->tile_size = tile_size <= 0 ? 0 : std::max(16, tile_size);
+}
+
+
+// METHOD IMPLEMENTATION
+int TileRenderer::get_tile_size() const {
+    return this->tile_size;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Side of the tiles used to render 'area': the fixed size if one was set,
+ * otherwise about tiles_per_thread tiles per thread.
+ */
+int TileRenderer::get_tile_size_for(const SDL_Rect& area) const {
+    if (this->tile_size > 0) return this->tile_size;
+
+    const int whole = std::max(1, std::max(area.w, area.h));
+    if (this->thread_count == 1) return whole;
+
+    const double tile_area = (double)area.w * area.h / (TileRenderer::tiles_per_thread * this->thread_count);
+    return std::min(whole, std::max(TileRenderer::min_tile_size, (int)std::ceil(std::sqrt(tile_area))));
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Rasterizes one rectangle of a surface: every tile is cleared to the
+ * background color and then receives the items that overlap it, in order.
+ *
+ * @param surface
+ * Destination surface (32-bit). Its clip rectangle is not used.
+ *
+ * @param rect
+ * Area to render, in surface coordinates.
+ *
+ * @param background
+ * Background color, in the surface format.
+ *
+ * @param bounds
+ * Area touched by each item. Items are drawn in the order of this vector.
+ *
+ * @param draw_item
+ * Draws one item. It is called from several threads at once, on different
+ * tiles, so it must not modify shared state.
+ *
+ * @return
+ * Number of (item, tile) draws performed.
+ */
+int TileRenderer::render(SDL_Surface* surface, const SDL_Rect& rect, Uint32 background, const std::vector<SDL_Rect>& bounds, const DrawItem& draw_item) {
+    if (!surface || surface->format->BytesPerPixel != 4) return 0;
+
+    SDL_Rect full = {0, 0, surface->w, surface->h};
+    SDL_Rect area;
+    if (!SDL_IntersectRect(&rect, &full, &area)) return 0;
+
+    // Tiles follow a grid starting at the corner of the area, so an item's tiles come
+    // from a division.
+    const int size = this->get_tile_size_for(area);
+    const int cols = (area.w + size - 1) / size;
+    const int rows = (area.h + size - 1) / size;
+
+    this->tiles.clear();
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            const int x = col * size, y = row * size;
+            this->tiles.push_back({area.x + x, area.y + y, std::min(size, area.w - x), std::min(size, area.h - y)});
+        }
+    }
+
+    this->bins.resize(this->tiles.size());
+    for (std::vector<int>& bin : this->bins) bin.clear();
+
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        SDL_Rect visible;
+        if (!SDL_IntersectRect(&bounds[i], &area, &visible)) continue;
+
+        const int col0 = (visible.x - area.x) / size, col1 = (visible.x - area.x + visible.w - 1) / size;
+        const int row0 = (visible.y - area.y) / size, row1 = (visible.y - area.y + visible.h - 1) / size;
+
+        for (int row = row0; row <= row1; ++row) {
+            for (int col = col0; col <= col1; ++col) {
+                this->bins[row * cols + col].push_back((int)i);
+            }
+        }
+    }
+
+    this->update_views(surface);
+    this->surface = surface;
+    this->background = background;
+    this->draw_item = &draw_item;
+    SDL_AtomicSet(&this->next_tile, 0);
+    SDL_AtomicSet(&this->items_drawn, 0);
+
+    // Only as many pool threads as there are tiles left for them.
+    const int helpers = std::min(this->thread_count - 1, (int)this->tiles.size() - 1);
+
+    for (int i = 0; i < helpers; ++i) SDL_SemPost(this->work_ready);
+    this->run_tiles(this->workers[0]);
+    for (int i = 0; i < helpers; ++i) SDL_SemWait(this->work_done);
+
+    this->draw_item = nullptr;
+    return SDL_AtomicGet(&this->items_drawn);
+}
+
+
+// METHOD IMPLEMENTATION
+void TileRenderer::start_workers() {
+    for (size_t i = 1; i < this->workers.size(); ++i) {
+        this->workers[i].thread = SDL_CreateThread(TileRenderer::worker_main, "TileRenderer", &this->workers[i]);
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+void TileRenderer::stop_workers() {
+    this->quit = true;
+
+    for (size_t i = 1; i < this->workers.size(); ++i) {
+        if (this->workers[i].thread) SDL_SemPost(this->work_ready);
+    }
+
+    for (size_t i = 1; i < this->workers.size(); ++i) {
+        if (this->workers[i].thread) SDL_WaitThread(this->workers[i].thread, nullptr);
+        this->workers[i].thread = nullptr;
+    }
+
+    this->quit = false;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Each worker draws through its own surface header sharing the pixels of the
+ * destination, since the clip rectangle lives in the SDL_Surface. The headers
+ * are rebuilt only when the destination surface changes.
+ */
+void TileRenderer::update_views(SDL_Surface* surface) {
+    for (Worker& worker : this->workers) {
+        SDL_Surface* view = worker.view;
+
+        if (view && view->pixels == surface->pixels && view->w == surface->w && view->h == surface->h &&
+            view->pitch == surface->pitch && view->format->format == surface->format->format) {
+            continue;
+        }
+
+        if (view) SDL_FreeSurface(view);
+        worker.view = SDL_CreateRGBSurfaceWithFormatFrom(surface->pixels, surface->w, surface->h,
+                                                         surface->format->BitsPerPixel, surface->pitch, surface->format->format);
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Takes tiles from the shared counter until none is left.
+ */
+void TileRenderer::run_tiles(Worker& worker) {
+    if (!worker.view) return;
+
+    for (;;) {
+        const int index = SDL_AtomicAdd(&this->next_tile, 1);
+        if (index >= (int)this->tiles.size()) break;
+
+        const SDL_Rect& tile = this->tiles[index];
+        const std::vector<int>& bin = this->bins[index];
+
+        TRACE_SCOPE("tile");
+        SDL_SetClipRect(worker.view, &tile);
+        SpanWriter::fill_rect(worker.view, tile, this->background);
+
+        for (int item : bin) {
+            (*this->draw_item)(worker.view, (size_t)item);
+        }
+
+        SDL_AtomicAdd(&this->items_drawn, (int)bin.size());
+    }
+}
+
+
+// METHOD IMPLEMENTATION
+int SDLCALL TileRenderer::worker_main(void* data) {
+    Worker* worker = (Worker*)data;
+    TileRenderer* owner = worker->owner;
+    TraceRecorder::set_thread_name("tile worker");
+
+    for (;;) {
+        SDL_SemWait(owner->work_ready);
+        if (owner->quit) break;
+
+        owner->run_tiles(*worker);
+        SDL_SemPost(owner->work_done);
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+// INCLUDES
+#include "App.h"
+
+
+// ATTRIBUTE INITIALIZATION
+bool TraceRecorder::enabled = false;
+std::string TraceRecorder::path;
+Uint64 TraceRecorder::origin = 0;
+std::vector<TraceRecorder::Buffer*> TraceRecorder::buffers;
+SDL_SpinLock TraceRecorder::buffers_lock = 0;
+
+
+// CONSTRUCTOR IMPLEMENTATION
+/**
+ * @param name Event name (a string literal), or nullptr to record nothing.
+ * @param size Optional "size" argument of the event (pixels, shapes...).
+ */
+TraceRecorder::Scope::Scope(const char* name, Sint64 size) {
+    this->name = TraceRecorder::enabled ? name : nullptr;
+    this->size = size;
+    this->start = this->name ? SDL_GetPerformanceCounter() : 0;
+}
+
+
+// DESTRUCTOR IMPLEMENTATION
+TraceRecorder::Scope::~Scope() {
+    if (this->name) TraceRecorder::record(this->name, this->start, SDL_GetPerformanceCounter(), this->size);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Enables tracing. Must be called before the traced threads start.
+ *
+ * @param path JSON file written by flush().
+ */
+void TraceRecorder::start(const std::string& path) {
+    TraceRecorder::path = path;
+    TraceRecorder::origin = SDL_GetPerformanceCounter();
+    TraceRecorder::enabled = true;
+}
+
+
+// METHOD IMPLEMENTATION
+bool TraceRecorder::get_enabled() {
+    return TraceRecorder::enabled;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Names the calling thread in the trace viewer.
+ */
+void TraceRecorder::set_thread_name(const char* name) {
+    if (!TraceRecorder::enabled) return;
+    TraceRecorder::get_thread_buffer()->thread_name = name;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Appends a complete event to the ring of the calling thread, over its oldest
+ * event when the ring is full.
+ */
+void TraceRecorder::record(const char* name, Uint64 start, Uint64 end, Sint64 size) {
+    Buffer* buffer = TraceRecorder::get_thread_buffer();
+    const Uint32 count = (Uint32)SDL_AtomicGet(&buffer->count);
+
+    buffer->events[count % TraceRecorder::buffer_capacity] = {name, start, end, size};
+    SDL_AtomicSet(&buffer->count, (int)(count + 1));   // Publishes the event to flush().
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Writes the most recent events of every thread to the trace file (replacing
+ * it). Events keep being recorded during and after the flush.
+ *
+ * @return false if tracing is off or the file cannot be written.
+ */
+bool TraceRecorder::flush() {
+    if (!TraceRecorder::enabled) return false;
+
+    FILE* file = fopen(TraceRecorder::path.c_str(), "w");
+    if (!file) return false;
+
+    std::vector<Buffer*> snapshot;
+    SDL_AtomicLock(&TraceRecorder::buffers_lock);
+    snapshot = TraceRecorder::buffers;
+    SDL_AtomicUnlock(&TraceRecorder::buffers_lock);
+
+    const double us_per_tick = 1000000.0 / (double)SDL_GetPerformanceFrequency();
+    bool first = true;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    std::vector<Event> events;
+
+    for (Buffer* buffer : snapshot) {
+        // Copies the ring, oldest event first.
+        const Uint32 end = (Uint32)SDL_AtomicGet(&buffer->count);
+        const Uint32 kept = std::min(end, (Uint32)TraceRecorder::buffer_capacity);
+
+        events.clear();
+        for (Uint32 i = end - kept; i != end; ++i) {
+            events.push_back(buffer->events[i % TraceRecorder::buffer_capacity]);
+        }
+
+        // The owning thread kept recording during the copy: the copied events whose slot
+        // it has reached since (or is writing now) may be torn, so they are skipped.
+        const Uint32 recorded_since = (Uint32)SDL_AtomicGet(&buffer->count) - end;
+        const Sint64 torn = (Sint64)recorded_since + kept - TraceRecorder::buffer_capacity + 1;
+        const size_t skipped = (size_t)std::min<Sint64>(std::max<Sint64>(torn, 0), kept);
+        const Uint32 overwritten = end - kept + (Uint32)skipped;
+
+        fprintf(file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",", buffer->thread_id, buffer->thread_name);
+        first = false;
+
+        if (overwritten > 0) {
+            fprintf(file, ",\n{\"name\":\"overwritten events\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":0,\"args\":{\"overwritten\":%u}}",
+                    buffer->thread_id, (unsigned)overwritten);
+        }
+
+        for (size_t i = skipped; i < events.size(); ++i) {
+            const Event& event = events[i];
+            const double ts = (double)(Sint64)(event.start - TraceRecorder::origin) * us_per_tick;
+            const double dur = (double)(event.end - event.start) * us_per_tick;
+
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+                    event.name, buffer->thread_id, ts, dur);
+
+            if (event.size >= 0) {
+                fprintf(file, ",\"args\":{\"size\":%lld}", (long long)event.size);
+            }
+
+            fputc('}', file);
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Returns the buffer of the calling thread, registering it on first use.
+ * Buffers are never freed, so events of threads that ended are still flushed.
+ */
+TraceRecorder::Buffer* TraceRecorder::get_thread_buffer() {
+    static thread_local Buffer* buffer = nullptr;
+    if (buffer) return buffer;
+
+    buffer = new Buffer();
+    buffer->events.resize(TraceRecorder::buffer_capacity);
+    SDL_AtomicSet(&buffer->count, 0);
+    buffer->thread_name = "thread";
+
+    SDL_AtomicLock(&TraceRecorder::buffers_lock);
+    buffer->thread_id = (int)TraceRecorder::buffers.size() + 1;
+    TraceRecorder::buffers.push_back(buffer);
+    SDL_AtomicUnlock(&TraceRecorder::buffers_lock);
+
+    return buffer;
+}
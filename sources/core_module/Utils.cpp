@@ -5,7 +5,8 @@
 /**
  * @brief
  * This method checks if the specified coordinates lie inside the dimensions
- * of the provided SDL surface. If the point is out of bounds, an error is logged.
+ * of the provided SDL surface. Nothing is logged: the rasterizers clip their
+ * geometry before drawing, so an out of bounds point here is not an error.
  *
  * @param surface
  * Pointer to the SDL surface to check against.
@@ -19,10 +20,9 @@
  * @return int Returns 1 if the point is within bounds, 0 otherwise.
  */
 int Utils::verify_limits(SDL_Surface* surface, int x, int y) {
-    /*if (surface->w < x || surface->h < y || x < 0 || y < 0){
-        ErrorHandler::log_error("Point out of bounds.");
+    if (!surface || x < 0 || y < 0 || x >= surface->w || y >= surface->h) {
         return 0;
-    }*/
+    }
 
     return 1;
 }
@@ -93,6 +93,22 @@ Point Utils::universe_to_canvas(Point u,int canvas_w, int canvas_h,int universe_
     return p;
 }
 
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Same transform as universe_to_canvas, but without snapping to a pixel: the
+ * result keeps 1/256 px of precision, so a shape moves smoothly while dragged.
+ * The canvas is continuous here (pixel (x, y) is the square [x, x+1) x [y, y+1)),
+ * and y still grows downwards from the top edge of the canvas.
+ *
+ * @return FixedPoint::Vertex Canvas position in 24.8 fixed point.
+ */
+FixedPoint::Vertex Utils::universe_to_canvas_fixed(const Point& u, int canvas_w, int canvas_h, int universe_w, int universe_h) {
+    const double x = u.get_x() * double(canvas_w) / double(universe_w);
+    const double y_from_bottom = u.get_y() * double(canvas_h) / double(universe_h);
+    return FixedPoint::vertex(x, double(canvas_h) - y_from_bottom);
+}
+
 // dois pontos no canvas (drag) -> retngulo normalizado no universo
 Utils::UniverseRect Utils::canvas_drag_to_universe(Point a, Point b, int canvas_w, int canvas_h,int universe_w, int universe_h) {
     Point ua = canvas_to_universe(a, canvas_w, canvas_h, universe_w, universe_h);
@@ -104,3 +120,33 @@ Utils::UniverseRect Utils::canvas_drag_to_universe(Point a, Point b, int canvas_
     r.h = std::fabs(ub.get_y() - ua.get_y());
     return r;
 }
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief
+ * Computes the canvas rectangle covered by a set of universe points, grown by
+ * a padding in pixels. Used by the shapes to report the area they rasterize.
+ *
+ * @param points Array of pointers to the points in universe coordinates.
+ * @param count Number of points in the array.
+ * @param padding Extra pixels added on every side.
+ * @return SDL_Rect Bounding rectangle in canvas coordinates (not clipped to the canvas).
+ */
+SDL_Rect Utils::canvas_bounds(Point* const* points, int count, int padding, int canvas_w, int canvas_h, int universe_w, int universe_h) {
+    if (count <= 0) return {0, 0, 0, 0};
+
+    int min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+
+    for (int i = 0; i < count; ++i) {
+        Point c = Utils::universe_to_canvas(*points[i], canvas_w, canvas_h, universe_w, universe_h);
+        int x = (int)c.get_x();
+        int y = (int)c.get_y();
+
+        if (i == 0 || x < min_x) min_x = x;
+        if (i == 0 || x > max_x) max_x = x;
+        if (i == 0 || y < min_y) min_y = y;
+        if (i == 0 || y > max_y) max_y = y;
+    }
+
+    return {min_x - padding, min_y - padding, max_x - min_x + 1 + 2 * padding, max_y - min_y + 1 + 2 * padding};
+}
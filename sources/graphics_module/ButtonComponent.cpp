@@ -14,32 +14,20 @@ ButtonComponent::ButtonComponent(int x, int y, int w, int h, Uint32 color, const
 void ButtonComponent::draw(SDL_Surface* surface) {
     if (!surface) return;
 
-    int radius = 6; // Rounded corner radius
+    // Skips the button when it lies outside the area being recomposed (clip rectangle).
+    SDL_Rect bounds = { x, y, w, h };
+    if (!SDL_HasIntersection(&bounds, &surface->clip_rect)) return;
 
-    // Draw central areas
-    SDL_Rect rect = { x + radius, y, w - 2*radius, h };
-    SDL_FillRect(surface, &rect, color);
-    rect = { x, y + radius, w, h - 2*radius };
-    SDL_FillRect(surface, &rect, color);
+    int radius = 6; // Rounded corner radius
 
-    // Draw rounded corners
-    Primitives::draw_circle(surface, x + radius, y + radius, radius, color, true, true);                 // top-left
-    Primitives::draw_circle(surface, x + w - radius - 1, y + radius, radius, color, true, true);       // top-right
-    Primitives::draw_circle(surface, x + radius, y + h - radius - 1, radius, color, true, true);       // bottom-left
-    Primitives::draw_circle(surface, x + w - radius - 1, y + h - radius - 1, radius, color, true, true); // bottom-right
+    // Draw the background (color is in the surface format)
+    Primitives::draw_rounded_rect(surface, bounds, radius, Colors::uint32_to_sdlcolor(surface, color));
 
     // Draw text
     if (font && !text.empty()) {
-        SDL_Surface* textSurface = TTF_RenderText_Blended(font, text.c_str(), text_color);
-        if (textSurface) {
-            SDL_Rect textRect;
-            textRect.w = textSurface->w;
-            textRect.h = textSurface->h;
-            textRect.x = x + (w - textRect.w) / 2;
-            textRect.y = y + (h - textRect.h) / 2;
-            SDL_BlitSurface(textSurface, NULL, surface, &textRect);
-            SDL_FreeSurface(textSurface);
-        }
+        int text_w = 0, text_h = 0;
+        GlyphAtlas::size_text(font, text, &text_w, &text_h);
+        GlyphAtlas::draw_text(surface, font, text, x + (w - text_w) / 2, y + (h - text_h) / 2, text_color);
     }
 }
 
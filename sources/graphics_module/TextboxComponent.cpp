@@ -60,64 +60,28 @@ void TextboxComponent::render(SDL_Surface* targetSurface) {
     const int border_thickness = 2;
     const int outer_radius = 10;
 
-    // Mapeia cores para o formato da surface
-    Uint32 border32 = SDL_MapRGB(targetSurface->format, borderColor.r, borderColor.g, borderColor.b);
-    Uint32 bg32     = SDL_MapRGB(targetSurface->format, bgColor.r, bgColor.g, bgColor.b);
+    // 1) Fundo arredondado
+    Primitives::draw_rounded_rect(targetSurface, rect, outer_radius, bgColor);
 
-    // 1) Preencher retângulo externo com a cor da borda (forma base da borda)
-    SDL_Rect outer = rect;
-    SDL_FillRect(targetSurface, &outer, border32);
+    // 2) Borda arredondada por cima (o raio interno acompanha a espessura)
+    Primitives::draw_rounded_rect(targetSurface, rect, outer_radius, borderColor, border_thickness);
 
-    // 2) Desenhar círculos externos (bordas arredondadas)
-    //Primitives::draw_circle(targetSurface, rect.x + outer_radius, rect.y + outer_radius, outer_radius, border32, true, true); // sup. esquerdo
-    //Primitives::draw_circle(targetSurface, rect.x + rect.w - outer_radius, rect.y + outer_radius, outer_radius, border32, true, true); // sup. direito
-    //Primitives::draw_circle(targetSurface, rect.x + outer_radius, rect.y + rect.h - outer_radius, outer_radius, border32, true, true); // inf. esquerdo
-    //Primitives::draw_circle(targetSurface, rect.x + rect.w - outer_radius, rect.y + rect.h - outer_radius, outer_radius, border32, true, true); // inf. direito
-
-    // 3) Preencher interior (fundo) com bgColor (deslocado pela espessura da borda)
-    SDL_Rect inner;
-    inner.x = rect.x + border_thickness;
-    inner.y = rect.y + border_thickness;
-    inner.w = rect.w - 2 * border_thickness;
-    inner.h = rect.h - 2 * border_thickness;
-
-    if (inner.w > 0 && inner.h > 0) {
-        SDL_FillRect(targetSurface, &inner, bg32);
-
-        // desenhar círculos internos (para manter cantos arredondados do fundo)
-        int inner_radius = outer_radius - border_thickness;
-        if (inner_radius > 0) {
-            //Primitives::draw_circle(targetSurface, inner.x + inner_radius, inner.y + inner_radius, inner_radius, bg32, true, true);
-            //Primitives::draw_circle(targetSurface, inner.x + inner.w - inner_radius, inner.y + inner_radius, inner_radius, bg32, true, true);
-            //Primitives::draw_circle(targetSurface, inner.x + inner_radius, inner.y + inner.h - inner_radius, inner_radius, bg32, true, true);
-            //Primitives::draw_circle(targetSurface, inner.x + inner.w - inner_radius, inner.y + inner.h - inner_radius, inner_radius, bg32, true, true);
-        }
-    }
-
-    // 4) Renderizar texto (centralizado verticalmente)
+    // 3) Renderizar texto (centralizado verticalmente)
     if (!text.empty() && font) {
-        SDL_Surface* textSurface = TTF_RenderText_Blended(font, text.c_str(), textColor);
-        if (textSurface) {
-            SDL_Rect dst;
-            dst.x = rect.x + 8; // padding esquerdo
-            dst.y = rect.y + (rect.h - textSurface->h) / 2;
-            dst.w = textSurface->w;
-            dst.h = textSurface->h;
-            SDL_BlitSurface(textSurface, nullptr, targetSurface, &dst);
-            SDL_FreeSurface(textSurface);
-        }
+        int tw = 0, th = 0;
+        GlyphAtlas::size_text(font, text, &tw, &th);
+        GlyphAtlas::draw_text(targetSurface, font, text, rect.x + 8, rect.y + (rect.h - th) / 2, textColor); // padding esquerdo: 8
     }
 
-    // 5) Desenhar caret (cursor) quando ativa
+    // 4) Desenhar caret (cursor) quando ativa
     if (active && font) {
         // medir largura do texto para posicionar o caret
         int tw = 0, th = 0;
         if (text.empty()) {
-            // medir um caráter de referência (altura)
-            TTF_SizeText(font, "M", &tw, &th);
-            tw = 0;
+            // altura de uma linha vazia
+            th = TTF_FontHeight(font);
         } else {
-            TTF_SizeText(font, text.c_str(), &tw, &th);
+            GlyphAtlas::size_text(font, text, &tw, &th);
         }
         int caret_x = rect.x + 8 + tw;
         int caret_y = rect.y + (rect.h - th) / 2;
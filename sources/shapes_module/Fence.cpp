@@ -159,85 +159,65 @@ void Fence::scale(double scale_x, double scale_y){
 
 
 
-void Fence::draw(SDL_Surface* surface) {
-    if (!surface) return;
-
-    const int device_width  = surface->w;
-    const int device_height = surface->h;
+void Fence::compile(DisplayList& list, int canvas_w, int canvas_h) {
+    const int device_width  = canvas_w;
+    const int device_height = canvas_h;
 
     const int universe_width  = App::universe_width;
     const int universe_height = App::universe_height;
 
     // --- Converte todos os pontos para canvas ---
-    Point v1_bl = Utils::universe_to_canvas(this->vert_plank1_bottom_left,  device_width, device_height, universe_width, universe_height);
-    Point v1_br = Utils::universe_to_canvas(this->vert_plank1_bottom_right, device_width, device_height, universe_width, universe_height);
-    Point v1_tr = Utils::universe_to_canvas(this->vert_plank1_top_right,    device_width, device_height, universe_width, universe_height);
-    Point v1_tl = Utils::universe_to_canvas(this->vert_plank1_top_left,     device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex v1_bl = Utils::universe_to_canvas_fixed(this->vert_plank1_bottom_left,  device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex v1_br = Utils::universe_to_canvas_fixed(this->vert_plank1_bottom_right, device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex v1_tr = Utils::universe_to_canvas_fixed(this->vert_plank1_top_right,    device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex v1_tl = Utils::universe_to_canvas_fixed(this->vert_plank1_top_left,     device_width, device_height, universe_width, universe_height);
 
-    Point v2_bl = Utils::universe_to_canvas(this->vert_plank2_bottom_left,  device_width, device_height, universe_width, universe_height);
-    Point v2_br = Utils::universe_to_canvas(this->vert_plank2_bottom_right, device_width, device_height, universe_width, universe_height);
-    Point v2_tr = Utils::universe_to_canvas(this->vert_plank2_top_right,    device_width, device_height, universe_width, universe_height);
-    Point v2_tl = Utils::universe_to_canvas(this->vert_plank2_top_left,     device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex v2_bl = Utils::universe_to_canvas_fixed(this->vert_plank2_bottom_left,  device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex v2_br = Utils::universe_to_canvas_fixed(this->vert_plank2_bottom_right, device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex v2_tr = Utils::universe_to_canvas_fixed(this->vert_plank2_top_right,    device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex v2_tl = Utils::universe_to_canvas_fixed(this->vert_plank2_top_left,     device_width, device_height, universe_width, universe_height);
 
-    Point h1_bl = Utils::universe_to_canvas(this->hor_plank1_bottom_left,   device_width, device_height, universe_width, universe_height);
-    Point h1_br = Utils::universe_to_canvas(this->hor_plank1_bottom_right,  device_width, device_height, universe_width, universe_height);
-    Point h1_tr = Utils::universe_to_canvas(this->hor_plank1_top_right,     device_width, device_height, universe_width, universe_height);
-    Point h1_tl = Utils::universe_to_canvas(this->hor_plank1_top_left,      device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex h1_bl = Utils::universe_to_canvas_fixed(this->hor_plank1_bottom_left,   device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex h1_br = Utils::universe_to_canvas_fixed(this->hor_plank1_bottom_right,  device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex h1_tr = Utils::universe_to_canvas_fixed(this->hor_plank1_top_right,     device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex h1_tl = Utils::universe_to_canvas_fixed(this->hor_plank1_top_left,      device_width, device_height, universe_width, universe_height);
 
-    Point h2_bl = Utils::universe_to_canvas(this->hor_plank2_bottom_left,   device_width, device_height, universe_width, universe_height);
-    Point h2_br = Utils::universe_to_canvas(this->hor_plank2_bottom_right,  device_width, device_height, universe_width, universe_height);
-    Point h2_tr = Utils::universe_to_canvas(this->hor_plank2_top_right,     device_width, device_height, universe_width, universe_height);
-    Point h2_tl = Utils::universe_to_canvas(this->hor_plank2_top_left,      device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex h2_bl = Utils::universe_to_canvas_fixed(this->hor_plank2_bottom_left,   device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex h2_br = Utils::universe_to_canvas_fixed(this->hor_plank2_bottom_right,  device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex h2_tr = Utils::universe_to_canvas_fixed(this->hor_plank2_top_right,     device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex h2_tl = Utils::universe_to_canvas_fixed(this->hor_plank2_top_left,      device_width, device_height, universe_width, universe_height);
 
-    Point t1    = Utils::universe_to_canvas(this->top1, device_width, device_height, universe_width, universe_height);
-    Point t2    = Utils::universe_to_canvas(this->top2, device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex t1    = Utils::universe_to_canvas_fixed(this->top1, device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex t2    = Utils::universe_to_canvas_fixed(this->top2, device_width, device_height, universe_width, universe_height);
 
     // --- DESENHO APENAS COM TRIÂNGULOS E RETÂNGULOS PREENCHIDOS ---
 
     // Verticais (tábuas)
-    Primitives::draw_rectangle(surface,
-        (int)v1_bl.get_x(), (int)v1_bl.get_y(),
-        (int)v1_br.get_x(), (int)v1_br.get_y(),
-        (int)v1_tr.get_x(), (int)v1_tr.get_y(),
-        (int)v1_tl.get_x(), (int)v1_tl.get_y(),
-        this->plank_color);
-
-    Primitives::draw_rectangle(surface,
-        (int)v2_bl.get_x(), (int)v2_bl.get_y(),
-        (int)v2_br.get_x(), (int)v2_br.get_y(),
-        (int)v2_tr.get_x(), (int)v2_tr.get_y(),
-        (int)v2_tl.get_x(), (int)v2_tl.get_y(),
-        this->plank_color);
+    list.add_rectangle(v1_bl, v1_br, v1_tr, v1_tl, this->plank_color);
+
+    list.add_rectangle(v2_bl, v2_br, v2_tr, v2_tl, this->plank_color);
 
     // Horizontais (travessas)
-    Primitives::draw_rectangle(surface,
-        (int)h1_bl.get_x(), (int)h1_bl.get_y(),
-        (int)h1_br.get_x(), (int)h1_br.get_y(),
-        (int)h1_tr.get_x(), (int)h1_tr.get_y(),
-        (int)h1_tl.get_x(), (int)h1_tl.get_y(),
-        this->plank_color);
-
-    Primitives::draw_rectangle(surface,
-        (int)h2_bl.get_x(), (int)h2_bl.get_y(),
-        (int)h2_br.get_x(), (int)h2_br.get_y(),
-        (int)h2_tr.get_x(), (int)h2_tr.get_y(),
-        (int)h2_tl.get_x(), (int)h2_tl.get_y(),
-        this->plank_color);
+    list.add_rectangle(h1_bl, h1_br, h1_tr, h1_tl, this->plank_color);
+
+    list.add_rectangle(h2_bl, h2_br, h2_tr, h2_tl, this->plank_color);
 
     // Topos (triângulos)
     // Cada topo é um triângulo preenchido ligando as duas quinas superiores da tábua vertical ao vértice top.
-    Primitives::draw_triangle(surface,
-        (int)v1_tl.get_x(), (int)v1_tl.get_y(),
-        (int)v1_tr.get_x(), (int)v1_tr.get_y(),
-        (int)t1.get_x(),    (int)t1.get_y(),
-        this->top_color);
-
-    Primitives::draw_triangle(surface,
-        (int)v2_tl.get_x(), (int)v2_tl.get_y(),
-        (int)v2_tr.get_x(), (int)v2_tr.get_y(),
-        (int)t2.get_x(),    (int)t2.get_y(),
-        this->top_color);
+    list.add_triangle(v1_tl, v1_tr, t1, this->top_color);
+
+    list.add_triangle(v2_tl, v2_tr, t2, this->top_color);
+
+    // Contornos (opcionais): tábuas verticais com o topo e travessas.
+    this->stroke_outline(list, {v1_bl, v1_br, v1_tr, t1, v1_tl});
+    this->stroke_outline(list, {v2_bl, v2_br, v2_tr, t2, v2_tl});
+    this->stroke_outline(list, {h1_bl, h1_br, h1_tr, h1_tl});
+    this->stroke_outline(list, {h2_bl, h2_br, h2_tr, h2_tl});
 }
 
 
 
+
+SDL_Rect Fence::get_canvas_bounds(int canvas_w, int canvas_h) {
+    return Utils::canvas_bounds(this->pts.data(), (int)this->pts.size(), 1 + this->outline_padding(), canvas_w, canvas_h, App::universe_width, App::universe_height);
+}
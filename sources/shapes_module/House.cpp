@@ -1,171 +1,172 @@
-#include "House.h"
-#include "Utils.h"
-#include "Primitives.h"
-#include <SDL.h>
-#include <math.h>
-
-House::House(int width, int height, int universe_x_origin, int universe_y_origin, Uint32 color_walls, Uint32 color_door, Uint32 color_roof) {
-    this->width       = width;
-    this->height      = height;
-    this->x_origin    = universe_x_origin;
-    this->y_origin    = universe_y_origin;
-    this->walls_color = color_walls;
-    this->door_color  = color_door;
-    this->roof_color  = color_roof;
-
-    this->colors[0] = color_walls;
-    this->colors[1] = color_door;
-    this->colors[2] = color_roof;
-
-    this->pts = {
-        &this->wall_top_left, &this->wall_top_right, &this->wall_bottom_right, &this->wall_bottom_left,
-        &this->door_top_left, &this->door_top_right, &this->door_bottom_right, &this->door_bottom_left,
-        &this->roof_peak, &this->wall_fill, &this->wall_fill2, &this->wall_fill3,
-        &this->door_fill,
-        &this->roof_fill, &this->roof_fill2, &this->roof_fill3, &this->roof_fill4
-        // se tiver pontos de fill, pode adicion-los aqui tambm
-    };
-
-    this->generate_points();
-    //reset_transform();
-}
-
-void House::generate_points() {
-    this->wall_top_left     = Point(this->x_origin + 0.0 * this->width, this->y_origin + 0.5 * this->height);
-    this->wall_bottom_right = Point(this->x_origin + 1.0 * this->width, this->y_origin + 0.0 * this->height);
-    this->wall_top_right    = Point(this->wall_bottom_right.get_x(),this->wall_top_left.get_y());
-    this->wall_bottom_left  = Point(this->wall_top_left.get_x(), this->wall_bottom_right.get_y());
-
-    this->door_top_left     = Point(this->x_origin + 0.4 * this->width, this->y_origin + 0.25 * this->height);
-    this->door_top_right    = Point(this->x_origin + 0.6 * this->width, this->y_origin + 0.25 * this->height);
-    this->door_bottom_left  = Point(this->door_top_left.get_x(), this->y_origin + 0.0 * this->height);
-    this->door_bottom_right = Point(this->door_top_right.get_x(), this->y_origin + 0.0 * this->height);
-
-    this->roof_peak         = Point(this->x_origin + 0.5 * this->width, this->y_origin + 1.0 * this->height);
-
-    this->wall_fill = Point(this->x_origin + 0.1 * this->width, this->y_origin + 0.4 * this->height);
-    this->wall_fill2 = Point(this->x_origin + 0.9 * this->width, this->y_origin + 0.4 * this->height);
-    this->wall_fill3 = Point(this->x_origin + 0.5 * this->width, this->y_origin + 0.4 * this->height);
-    this->door_fill = Point(this->x_origin + 0.5 * this->width, this->y_origin + 0.22 * this->height);
-    this->roof_fill = Point(this->x_origin + 0.5 * this->width, this->y_origin + 0.65  * this->height);
-    this->roof_fill2 = Point(this->x_origin + 0.25 * this->width, this->y_origin + 0.52  * this->height);
-    this->roof_fill3 = Point(this->x_origin + 0.75 * this->width, this->y_origin + 0.52  * this->height);
-    this->roof_fill4 = Point(this->x_origin + 0.5 * this->width, this->y_origin + 0.95  * this->height);
-}
-
-void House::rotate_figure(double angle)
-{
-    angle *= -1;
-    double x, y, radians, cosTheta, sinTheta, dx, dy;
-
-    dx = (double)this->wall_bottom_left.get_x();
-    dy = (double)this->wall_bottom_left.get_y();
-
-    translate(-dx, -dy);
-
-    radians  = Utils::to_radians(angle);
-    cosTheta = cos(radians);
-    sinTheta = sin(radians);
-
-    for(Point* p : pts) {
-        x = (double)p->get_x();
-        y = (double)p->get_y();
-        p->set_x(x * cosTheta - y * sinTheta);
-        p->set_y(x * sinTheta + y * cosTheta);
-    }
-
-    translate(dx, dy);
-}
-
-void House::translate(double dx, double dy){
-    double x, y;
-
-    for(Point* p : pts) {
-        x = (double)p->get_x();
-        y = (double)p->get_y();
-        p->set_x(x + dx);
-        p->set_y(y + dy);
-    }
-}
-
-void House::scale(double sx, double sy){
-    double dx, dy, x, y;
-    dx = (double)this->wall_bottom_left.get_x();
-    dy = (double)this->wall_bottom_left.get_y();
+#include "House.h"
+#include "Utils.h"
+#include "Primitives.h"
+#include <SDL.h>
+#include <math.h>
+
+House::House(int width, int height, int universe_x_origin, int universe_y_origin, Uint32 color_walls, Uint32 color_door, Uint32 color_roof) {
+    this->width       = width;
+    this->height      = height;
+    this->x_origin    = universe_x_origin;
+    this->y_origin    = universe_y_origin;
+    this->walls_color = color_walls;
+    this->door_color  = color_door;
+    this->roof_color  = color_roof;
+
+    this->colors[0] = color_walls;
+    this->colors[1] = color_door;
+    this->colors[2] = color_roof;
+
+    this->pts = {
+        &this->wall_top_left, &this->wall_top_right, &this->wall_bottom_right, &this->wall_bottom_left,
+        &this->door_top_left, &this->door_top_right, &this->door_bottom_right, &this->door_bottom_left,
+        &this->roof_peak, &this->wall_fill, &this->wall_fill2, &this->wall_fill3,
+        &this->door_fill,
+        &this->roof_fill, &this->roof_fill2, &this->roof_fill3, &this->roof_fill4
+        // se tiver pontos de fill, pode adicion-los aqui tambm
+    };
+
+    this->generate_points();
+    //reset_transform();
+}
+
+void House::generate_points() {
+    this->wall_top_left     = Point(this->x_origin + 0.0 * this->width, this->y_origin + 0.5 * this->height);
+    this->wall_bottom_right = Point(this->x_origin + 1.0 * this->width, this->y_origin + 0.0 * this->height);
+    this->wall_top_right    = Point(this->wall_bottom_right.get_x(),this->wall_top_left.get_y());
+    this->wall_bottom_left  = Point(this->wall_top_left.get_x(), this->wall_bottom_right.get_y());
+
+    this->door_top_left     = Point(this->x_origin + 0.4 * this->width, this->y_origin + 0.25 * this->height);
+    this->door_top_right    = Point(this->x_origin + 0.6 * this->width, this->y_origin + 0.25 * this->height);
+    this->door_bottom_left  = Point(this->door_top_left.get_x(), this->y_origin + 0.0 * this->height);
+    this->door_bottom_right = Point(this->door_top_right.get_x(), this->y_origin + 0.0 * this->height);
+
+    this->roof_peak         = Point(this->x_origin + 0.5 * this->width, this->y_origin + 1.0 * this->height);
+
+    this->wall_fill = Point(this->x_origin + 0.1 * this->width, this->y_origin + 0.4 * this->height);
+    this->wall_fill2 = Point(this->x_origin + 0.9 * this->width, this->y_origin + 0.4 * this->height);
+    this->wall_fill3 = Point(this->x_origin + 0.5 * this->width, this->y_origin + 0.4 * this->height);
+    this->door_fill = Point(this->x_origin + 0.5 * this->width, this->y_origin + 0.22 * this->height);
+    this->roof_fill = Point(this->x_origin + 0.5 * this->width, this->y_origin + 0.65  * this->height);
+    this->roof_fill2 = Point(this->x_origin + 0.25 * this->width, this->y_origin + 0.52  * this->height);
+    this->roof_fill3 = Point(this->x_origin + 0.75 * this->width, this->y_origin + 0.52  * this->height);
+    this->roof_fill4 = Point(this->x_origin + 0.5 * this->width, this->y_origin + 0.95  * this->height);
+}
+
+void House::rotate_figure(double angle)
+{
+    angle *= -1;
+    double x, y, radians, cosTheta, sinTheta, dx, dy;
+
+    dx = (double)this->wall_bottom_left.get_x();
+    dy = (double)this->wall_bottom_left.get_y();
+
+    translate(-dx, -dy);
+
+    radians  = Utils::to_radians(angle);
+    cosTheta = cos(radians);
+    sinTheta = sin(radians);
+
+    for(Point* p : pts) {
+        x = (double)p->get_x();
+        y = (double)p->get_y();
+        p->set_x(x * cosTheta - y * sinTheta);
+        p->set_y(x * sinTheta + y * cosTheta);
+    }
+
+    translate(dx, dy);
+}
+
+void House::translate(double dx, double dy){
+    double x, y;
+
+    for(Point* p : pts) {
+        x = (double)p->get_x();
+        y = (double)p->get_y();
+        p->set_x(x + dx);
+        p->set_y(y + dy);
+    }
+}
+
+void House::scale(double sx, double sy){
+    double dx, dy, x, y;
+    dx = (double)this->wall_bottom_left.get_x();
+    dy = (double)this->wall_bottom_left.get_y();
+
     this->translate(-dx,-dy);
-
-
-    for(Point* p : pts) {
-        x = (double)p->get_x();
-        y = (double)p->get_y();
-        p->set_x(x * sx);
-        p->set_y(y * sy);
-    }
-
-    this->translate(dx,dy);
-
-    this->width  = (int)lround(this->width  * sx);
-    this->height = (int)lround(this->height * sy);
-}
-
-void House::draw(SDL_Surface* surface) {
-    const int device_width  = surface->w;
-    const int device_height = surface->h;
-
-    const int universe_width  = App::universe_width;
-    const int universe_height = App::universe_height;
-
-    Point wall_top_left      = Utils::universe_to_canvas(this->wall_top_left,      device_width, device_height, universe_width, universe_height);
-    Point wall_top_right     = Utils::universe_to_canvas(this->wall_top_right,     device_width, device_height, universe_width, universe_height);
-    Point wall_bottom_right  = Utils::universe_to_canvas(this->wall_bottom_right,  device_width, device_height, universe_width, universe_height);
-    Point wall_bottom_left   = Utils::universe_to_canvas(this->wall_bottom_left,   device_width, device_height, universe_width, universe_height);
-
-    Point door_top_left      = Utils::universe_to_canvas(this->door_top_left,      device_width, device_height, universe_width, universe_height);
-    Point door_top_right     = Utils::universe_to_canvas(this->door_top_right,     device_width, device_height, universe_width, universe_height);
-    Point door_bottom_left   = Utils::universe_to_canvas(this->door_bottom_left,   device_width, device_height, universe_width, universe_height);
-    Point door_bottom_right  = Utils::universe_to_canvas(this->door_bottom_right,  device_width, device_height, universe_width, universe_height);
-
-    Point roof_peak          = Utils::universe_to_canvas(this->roof_peak,          device_width, device_height, universe_width, universe_height);
-
-    Point wall_fill          = Utils::universe_to_canvas(this->wall_fill,          device_width, device_height, universe_width, universe_height);
-    Point wall_fill2          = Utils::universe_to_canvas(this->wall_fill2,          device_width, device_height, universe_width, universe_height);
-    Point wall_fill3          = Utils::universe_to_canvas(this->wall_fill3,          device_width, device_height, universe_width, universe_height);
-
-    Point door_fill          = Utils::universe_to_canvas(this->door_fill,          device_width, device_height, universe_width, universe_height);
-    Point roof_fill          = Utils::universe_to_canvas(this->roof_fill,          device_width, device_height, universe_width, universe_height);
-    Point roof_fill2          = Utils::universe_to_canvas(this->roof_fill2,          device_width, device_height, universe_width, universe_height);
-    Point roof_fill3          = Utils::universe_to_canvas(this->roof_fill3,          device_width, device_height, universe_width, universe_height);
-    Point roof_fill4          = Utils::universe_to_canvas(this->roof_fill4,          device_width, device_height, universe_width, universe_height);
-
-    /*
-    Primitives::draw_line(surface, wall_bottom_left.get_x(),  wall_bottom_left.get_y(),  wall_top_left.get_x(),    wall_top_left.get_y(),    walls_color, false);
-    Primitives::draw_line(surface, wall_top_left.get_x(), wall_top_left.get_y(), wall_top_right.get_x(),   wall_top_right.get_y(),   walls_color, false);
-    Primitives::draw_line(surface, wall_top_right.get_x(), wall_top_right.get_y(), wall_bottom_right.get_x(),wall_bottom_right.get_y(),walls_color, false);
-    Primitives::draw_line(surface, wall_bottom_right.get_x(), wall_bottom_right.get_y(), wall_bottom_left.get_x(), wall_bottom_left.get_y(), walls_color, false);
-*/
-    Primitives::draw_rectangle(surface, wall_bottom_left.get_x(), wall_bottom_left.get_y(),
-                                  wall_bottom_right.get_x(), wall_bottom_right.get_y(),
-                                  wall_top_left.get_x(), wall_top_left.get_y(),
-                                  wall_top_right.get_x(), wall_top_right.get_y(),
-                                  this->walls_color);
-    // telhado (arestas at o pico)
-    /*
-    Primitives::draw_line(surface, wall_top_left.get_x(),  wall_top_left.get_y(),  roof_peak.get_x(), roof_peak.get_y(), roof_color, true);
-    Primitives::draw_line(surface, wall_top_right.get_x(), wall_top_right.get_y(), roof_peak.get_x(), roof_peak.get_y(), roof_color, true);
-    */
-    Primitives::draw_triangle(surface, wall_top_left.get_x(), wall_top_left.get_y(), wall_top_right.get_x(), wall_top_right.get_y(), roof_peak.get_x(), roof_peak.get_y(), roof_color);
-
-    // desenho da porta (polgono)
-    /*
-    Primitives::draw_line(surface, door_bottom_left.get_x(),  door_bottom_left.get_y(), door_top_left.get_x(),   door_top_left.get_y(), door_color, false);
-    Primitives::draw_line(surface, door_top_left.get_x(),     door_top_left.get_y(), door_top_right.get_x(),  door_top_right.get_y(), door_color, false);
-    Primitives::draw_line(surface, door_top_right.get_x(),    door_top_right.get_y(), door_bottom_right.get_x(),door_bottom_right.get_y(), door_color,false);
-    Primitives::draw_line(surface, door_bottom_right.get_x(), door_bottom_right.get_y(), door_bottom_left.get_x(), door_bottom_left.get_y(), door_color, false);
-    */
-    Primitives::draw_rectangle(surface, door_bottom_left.get_x(), door_bottom_left.get_y(),
-                                  door_top_left.get_x(), door_top_left.get_y(),
-                                  door_top_right.get_x(), door_top_right.get_y(),
-                                  door_bottom_right.get_x(), door_bottom_right.get_y(),
-                                  this->door_color);
-}
-
+
+
+    for(Point* p : pts) {
+        x = (double)p->get_x();
+        y = (double)p->get_y();
+        p->set_x(x * sx);
+        p->set_y(y * sy);
+    }
+
+    this->translate(dx,dy);
+
+    this->width  = (int)lround(this->width  * sx);
+    this->height = (int)lround(this->height * sy);
+}
+
+void House::compile(DisplayList& list, int canvas_w, int canvas_h) {
+    const int device_width  = canvas_w;
+    const int device_height = canvas_h;
+
+    const int universe_width  = App::universe_width;
+    const int universe_height = App::universe_height;
+
+    FixedPoint::Vertex wall_top_left      = Utils::universe_to_canvas_fixed(this->wall_top_left,      device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex wall_top_right     = Utils::universe_to_canvas_fixed(this->wall_top_right,     device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex wall_bottom_right  = Utils::universe_to_canvas_fixed(this->wall_bottom_right,  device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex wall_bottom_left   = Utils::universe_to_canvas_fixed(this->wall_bottom_left,   device_width, device_height, universe_width, universe_height);
+
+    FixedPoint::Vertex door_top_left      = Utils::universe_to_canvas_fixed(this->door_top_left,      device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex door_top_right     = Utils::universe_to_canvas_fixed(this->door_top_right,     device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex door_bottom_left   = Utils::universe_to_canvas_fixed(this->door_bottom_left,   device_width, device_height, universe_width, universe_height);
+    FixedPoint::Vertex door_bottom_right  = Utils::universe_to_canvas_fixed(this->door_bottom_right,  device_width, device_height, universe_width, universe_height);
+
+    FixedPoint::Vertex roof_peak          = Utils::universe_to_canvas_fixed(this->roof_peak,          device_width, device_height, universe_width, universe_height);
+
+    Point wall_fill          = Utils::universe_to_canvas(this->wall_fill,          device_width, device_height, universe_width, universe_height);
+    Point wall_fill2          = Utils::universe_to_canvas(this->wall_fill2,          device_width, device_height, universe_width, universe_height);
+    Point wall_fill3          = Utils::universe_to_canvas(this->wall_fill3,          device_width, device_height, universe_width, universe_height);
+
+    Point door_fill          = Utils::universe_to_canvas(this->door_fill,          device_width, device_height, universe_width, universe_height);
+    Point roof_fill          = Utils::universe_to_canvas(this->roof_fill,          device_width, device_height, universe_width, universe_height);
+    Point roof_fill2          = Utils::universe_to_canvas(this->roof_fill2,          device_width, device_height, universe_width, universe_height);
+    Point roof_fill3          = Utils::universe_to_canvas(this->roof_fill3,          device_width, device_height, universe_width, universe_height);
+    Point roof_fill4          = Utils::universe_to_canvas(this->roof_fill4,          device_width, device_height, universe_width, universe_height);
+
+    /*
+    Primitives::draw_line(surface, wall_bottom_left.get_x(),  wall_bottom_left.get_y(),  wall_top_left.get_x(),    wall_top_left.get_y(),    walls_color, false);
+    Primitives::draw_line(surface, wall_top_left.get_x(), wall_top_left.get_y(), wall_top_right.get_x(),   wall_top_right.get_y(),   walls_color, false);
+    Primitives::draw_line(surface, wall_top_right.get_x(), wall_top_right.get_y(), wall_bottom_right.get_x(),wall_bottom_right.get_y(),walls_color, false);
+    Primitives::draw_line(surface, wall_bottom_right.get_x(), wall_bottom_right.get_y(), wall_bottom_left.get_x(), wall_bottom_left.get_y(), walls_color, false);
+*/
+    list.add_rectangle(wall_bottom_left, wall_bottom_right, wall_top_left, wall_top_right, this->walls_color);
+    // telhado (arestas at o pico)
+    /*
+    Primitives::draw_line(surface, wall_top_left.get_x(),  wall_top_left.get_y(),  roof_peak.get_x(), roof_peak.get_y(), roof_color, true);
+    Primitives::draw_line(surface, wall_top_right.get_x(), wall_top_right.get_y(), roof_peak.get_x(), roof_peak.get_y(), roof_color, true);
+    */
+    list.add_triangle(wall_top_left, wall_top_right, roof_peak, roof_color);
+
+    // desenho da porta (polgono)
+    /*
+    Primitives::draw_line(surface, door_bottom_left.get_x(),  door_bottom_left.get_y(), door_top_left.get_x(),   door_top_left.get_y(), door_color, false);
+    Primitives::draw_line(surface, door_top_left.get_x(),     door_top_left.get_y(), door_top_right.get_x(),  door_top_right.get_y(), door_color, false);
+    Primitives::draw_line(surface, door_top_right.get_x(),    door_top_right.get_y(), door_bottom_right.get_x(),door_bottom_right.get_y(), door_color,false);
+    Primitives::draw_line(surface, door_bottom_right.get_x(), door_bottom_right.get_y(), door_bottom_left.get_x(), door_bottom_left.get_y(), door_color, false);
+    */
+    list.add_rectangle(door_bottom_left, door_top_left, door_top_right, door_bottom_right, this->door_color);
+
+    // Contornos (opcionais): paredes com o telhado e a porta.
+    this->stroke_outline(list, {wall_bottom_left, wall_top_left, roof_peak, wall_top_right, wall_bottom_right});
+    this->stroke_outline(list, {door_bottom_left, door_top_left, door_top_right, door_bottom_right});
+}
+
+
+SDL_Rect House::get_canvas_bounds(int canvas_w, int canvas_h) {
+    return Utils::canvas_bounds(this->pts.data(), (int)this->pts.size(), 1 + this->outline_padding(), canvas_w, canvas_h, App::universe_width, App::universe_height);
+}
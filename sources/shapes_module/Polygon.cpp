@@ -51,7 +51,7 @@ void Polygon::draw(SDL_Surface* surface) {
 
     // Setting a default color if fill_color was not provided.
     if (this->filled == true && this->fill_color_set == false) {
-        this->fill_color = SDL_MapRGB(surface->format, 0, 0, 0);
+        this->fill_color = CanvasFormat::opaque_black;
         // TODO: Set a well-positioned default paint point.
     }
 
@@ -1 +1,49 @@
+// INCLUDES
+#include "App.h"
 
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Draws the shape on its own: compiles it into a scratch display list and
+ * replays it. The App keeps a compiled list of all shapes instead.
+ */
+void Shape::draw(SDL_Surface* surface) {
+    if (!surface) return;
+    TRACE_SCOPE("Shape::draw");
+
+    // One list per thread (TileRenderer), reused between calls.
+    static thread_local DisplayList list;
+    list.clear();
+    this->compile(list, surface->w, surface->h);
+    list.execute(surface);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Records the stroke of the closed outline through the given canvas points,
+ * with mitered corners. Does nothing while outline_width is 0.
+ */
+void Shape::stroke_outline(DisplayList& list, const std::vector<FixedPoint::Vertex>& corners) {
+    if (this->outline_width <= 0.0f) return;
+
+    // The stroker puts pixel centers on integer coordinates; the canvas puts them at +0.5.
+    static thread_local std::vector<SDL_FPoint> outline;
+    outline.clear();
+    for (const FixedPoint::Vertex& corner : corners) {
+        outline.push_back({FixedPoint::to_float(corner.x) - 0.5f, FixedPoint::to_float(corner.y) - 0.5f});
+    }
+
+    Stroker::Style style = Stroker::default_style(this->outline_width);
+    style.join = Stroker::Join::MITER;
+    list.add_stroke(outline, this->outline_color, style, true);
+}
+
+
+// METHOD IMPLEMENTATION
+/**
+ * @brief Extra padding of the canvas bounds needed by the outline.
+ */
+int Shape::outline_padding() const {
+    return this->outline_width > 0.0f ? (int)std::ceil(this->outline_width * 0.5f) + 1 : 0;
+}
@@ -100,11 +100,9 @@ void Sun::scale(double sx, double sy){
 #include <cmath>
 #include <vector>
 
-void Sun::draw(SDL_Surface* surface) {
-    if (!surface) return;
-
-    const int device_width   = surface->w;
-    const int device_height  = surface->h;
+void Sun::compile(DisplayList& list, int canvas_w, int canvas_h) {
+    const int device_width   = canvas_w;
+    const int device_height  = canvas_h;
     const int universe_width = App::universe_width;
     const int universe_height= App::universe_height;
 
@@ -145,9 +143,6 @@ void Sun::draw(SDL_Surface* surface) {
     const double ray_len_x     = ruX * 0.85;
     const double ray_len_y     = ruY * 0.85;
 
-    std::vector<std::pair<int,int>> seeds;
-    seeds.reserve(RAY_COUNT);
-
     for (int i = 0; i < RAY_COUNT; ++i) {
         const double th = rot0 + (2.0 * PI * i) / RAY_COUNT;
 
@@ -165,31 +160,31 @@ void Sun::draw(SDL_Surface* surface) {
             this->sun_center.get_y() + base_radius_y * std::sin(th + base_half_angle)
         );
 
-        // canvas (px)
-        Point tip = Utils::universe_to_canvas(tip_u, device_width, device_height, universe_width, universe_height);
-        Point b1  = Utils::universe_to_canvas(b1_u,  device_width, device_height, universe_width, universe_height);
-        Point b2  = Utils::universe_to_canvas(b2_u,  device_width, device_height, universe_width, universe_height);
+        // canvas (ponto fixo 24.8, sem arredondar para o pixel)
+        FixedPoint::Vertex tip = Utils::universe_to_canvas_fixed(tip_u, device_width, device_height, universe_width, universe_height);
+        FixedPoint::Vertex b1  = Utils::universe_to_canvas_fixed(b1_u,  device_width, device_height, universe_width, universe_height);
+        FixedPoint::Vertex b2  = Utils::universe_to_canvas_fixed(b2_u,  device_width, device_height, universe_width, universe_height);
+
+        // raio preenchido por triangulo (independe do clip_rect, ao contrario do flood fill)
+        list.add_triangle(b1, b2, tip, this->sunrays_color);
 
         // arestas (a base ser coberta pela elipse)
-        Primitives::draw_line(surface, (int)b1.get_x(), (int)b1.get_y(),
-                              (int)tip.get_x(), (int)tip.get_y(),
-                              this->sunrays_color, /*aa=*/false);
-        Primitives::draw_line(surface, (int)b2.get_x(), (int)b2.get_y(),
-                              (int)tip.get_x(), (int)tip.get_y(),
-                              this->sunrays_color, /*aa=*/false);
-
-        // seed para flood fill (puxado ao pice)
-        const double sx = 0.40*tip.get_x() + 0.30*b1.get_x() + 0.30*b2.get_x();
-        const double sy = 0.40*tip.get_y() + 0.30*b1.get_y() + 0.30*b2.get_y();
-        seeds.emplace_back((int)std::lround(sx), (int)std::lround(sy));
+        list.add_line(b1, tip, this->sunrays_color);
+        list.add_line(b2, tip, this->sunrays_color);
     }
 
     // ---------- Elipse central com rx/ry em PX ----------
-    Primitives::draw_ellipse(surface, (int)std::lround(C.get_x()), (int)std::lround(C.get_y()),
-                             rx_px, ry_px, this->sun_color, false, true);
+    list.add_ellipse((int)std::lround(C.get_x()), (int)std::lround(C.get_y()),
+                     rx_px, ry_px, this->sun_color, false, true);
+}
+
+SDL_Rect Sun::get_canvas_bounds(int canvas_w, int canvas_h) {
+    // Ponta dos raios: (0.96 + 0.85) * 0.28 do tamanho, em qualquer rotacao.
+    const double reach_u = 0.28 * 1.81 * std::max(std::fabs(this->width), std::fabs(this->height));
+    const double px_per_u = std::max((double)canvas_w / App::universe_width, (double)canvas_h / App::universe_height);
+    const int padding = (int)std::ceil(reach_u * px_per_u) + 2;
 
-    // ---------- Flood fill em cada raio ----------
-    for (const auto& p : seeds)
-        Primitives::flood_fill(surface, p.first, p.second, this->sunrays_color);
+    Point* center = &this->sun_center;
+    return Utils::canvas_bounds(&center, 1, padding, canvas_w, canvas_h, App::universe_width, App::universe_height);
 }
 
@@ -106,28 +106,9 @@ void Tree::scale(double sx, double sy){
 }
 
 
-// Funo auxiliar: ponto de Bzier cbica (De Casteljau)
-static std::pair<int,int> bezierPoint(double t,
-                                      int x0,int y0,int x1,int y1,
-                                      int x2,int y2,int x3,int y3)
-{
-    double u   = 1.0 - t;
-    double uu  = u * u;
-    double tt  = t * t;
-    double uuu = uu * u;
-    double ttt = tt * t;
-
-    double x = uuu * x0 + 3 * uu * t * x1 + 3 * u * tt * x2 + ttt * x3;
-    double y = uuu * y0 + 3 * uu * t * y1 + 3 * u * tt * y2 + ttt * y3;
-
-    return std::pair<int,int>((int)std::lround(x), (int)std::lround(y));
-}
-
-void Tree::draw(SDL_Surface* surface) {
-    if (!surface) return;
-
-    const int device_width = surface->w;
-    const int device_height = surface->h;
+void Tree::compile(DisplayList& list, int canvas_w, int canvas_h) {
+    const int device_width = canvas_w;
+    const int device_height = canvas_h;
     const int universe_width = App::universe_width;
     const int universe_height = App::universe_height;
 
@@ -164,47 +145,47 @@ const int Rx2 = c_bezier_l.get_x(), Ry2 = c_bezier_l.get_y();
 const int Rx3 = c_trunk_tr.get_x(), Ry3 = c_trunk_tr.get_y();
 
 
-// Passos suficientes + mnimo
-int steps = std::max(std::abs(Lx3 - Lx0), std::abs(Ly3 - Ly0)) * 4;
-if (steps < 24) steps = 24;
-
-// Inicializa vrtices compartilhados (evita re-arredondar o mesmo t)
-std::pair<int,int> L_prev = bezierPoint(0.0, Lx0,Ly0, Lx1,Ly1, Lx2,Ly2, Lx3,Ly3);
-std::pair<int,int> R_prev = bezierPoint(0.0, Rx0,Ry0, Rx1,Ry1, Rx2,Ry2, Rx3,Ry3);
-
-for (int i = 0; i < steps; ++i) {
-    double t1 = (double)(i + 1) / (double)steps;
-
-    std::pair<int,int> L_next = bezierPoint(t1, Lx0,Ly0, Lx1,Ly1, Lx2,Ly2, Lx3,Ly3);
-    std::pair<int,int> R_next = bezierPoint(t1, Rx0,Ry0, Rx1,Ry1, Rx2,Ry2, Rx3,Ry3);
-
-    const int L0x = L_prev.first, L0y = L_prev.second;
-    const int R0x = R_prev.first, R0y = R_prev.second;
-    const int L1x = L_next.first, L1y = L_next.second;
-    const int R1x = R_next.first, R1y = R_next.second;
-
-    // Triangulao principal (diagonal L0-R1)
-    Primitives::draw_triangle(surface, L0x, L0y, R0x, R0y, R1x, R1y, this->trunk_color);
-    Primitives::draw_triangle(surface, L0x, L0y, R1x, R1y, L1x, L1y, this->trunk_color);
-
-    // Triangulao redundante (diagonal R0-L1)  cobre possveis fendas
-    Primitives::draw_triangle(surface, L0x, L0y, R0x, R0y, L1x, L1y, this->trunk_color);
-    Primitives::draw_triangle(surface, R0x, R0y, R1x, R1y, L1x, L1y, this->trunk_color);
-
-    // Avana reaproveitando os vrtices j arredondados
-    L_prev = L_next;
-    R_prev = R_next;
+// Contorno do tronco: curva esquerda (base -> topo), borda de cima e curva direita
+// percorrida ao contrrio (topo -> base); a borda de baixo fecha o polgono.
+// O preenchimento usa os pontos sem arredondar para o pixel (ponto fixo 24.8).
+// Os buffers so reaproveitados (um por thread, por causa do TileRenderer).
+static thread_local std::vector<SDL_FPoint> trunk_outline;
+static thread_local std::vector<FixedPoint::Vertex> trunk_polygon;
+
+const FixedPoint::Vertex f_bl = Utils::universe_to_canvas_fixed(this->trunk_bottom_left, device_width, device_height, universe_width, universe_height);
+const FixedPoint::Vertex f_br = Utils::universe_to_canvas_fixed(this->trunk_bottom_right, device_width, device_height, universe_width, universe_height);
+const FixedPoint::Vertex f_tr = Utils::universe_to_canvas_fixed(this->trunk_top_right, device_width, device_height, universe_width, universe_height);
+const FixedPoint::Vertex f_tl = Utils::universe_to_canvas_fixed(this->trunk_top_left, device_width, device_height, universe_width, universe_height);
+const FixedPoint::Vertex f_bz_l = Utils::universe_to_canvas_fixed(this->trunk_left_bezier_point, device_width, device_height, universe_width, universe_height);
+const FixedPoint::Vertex f_bz_r = Utils::universe_to_canvas_fixed(this->trunk_right_bezier_point, device_width, device_height, universe_width, universe_height);
+
+trunk_outline.clear();
+CurveFlattener::flatten_cubic(trunk_outline,
+    FixedPoint::to_float(f_bl.x), FixedPoint::to_float(f_bl.y),
+    FixedPoint::to_float(f_bz_r.x), FixedPoint::to_float(f_bz_r.y),
+    FixedPoint::to_float(f_bz_r.x), FixedPoint::to_float(f_bz_r.y),
+    FixedPoint::to_float(f_tl.x), FixedPoint::to_float(f_tl.y));
+CurveFlattener::flatten_cubic(trunk_outline,
+    FixedPoint::to_float(f_tr.x), FixedPoint::to_float(f_tr.y),
+    FixedPoint::to_float(f_bz_l.x), FixedPoint::to_float(f_bz_l.y),
+    FixedPoint::to_float(f_bz_l.x), FixedPoint::to_float(f_bz_l.y),
+    FixedPoint::to_float(f_br.x), FixedPoint::to_float(f_br.y));
+
+trunk_polygon.clear();
+for (const SDL_FPoint& p : trunk_outline) {
+    trunk_polygon.push_back(FixedPoint::vertex(p.x, p.y));
 }
+list.add_polygon(trunk_polygon, this->trunk_color);
 
 // (Opcional) bordas para acabamento
-Primitives::draw_curve(surface, Lx0,Ly0, Lx1,Ly1, Lx2,Ly2, Lx3,Ly3, this->trunk_color, false);
-Primitives::draw_curve(surface, Rx0,Ry0, Rx1,Ry1, Rx2,Ry2, Rx3,Ry3, this->trunk_color, false);
-Primitives::draw_line(surface, c_trunk_bl.get_x(), c_trunk_bl.get_y(),
-                               c_trunk_br.get_x(), c_trunk_br.get_y(),
-                               this->trunk_color, false);
-Primitives::draw_line(surface, c_trunk_tl.get_x(), c_trunk_tl.get_y(),
-                               c_trunk_tr.get_x(), c_trunk_tr.get_y(),
-                               this->trunk_color, false);
+list.add_curve(Lx0,Ly0, Lx1,Ly1, Lx2,Ly2, Lx3,Ly3, this->trunk_color, false);
+list.add_curve(Rx0,Ry0, Rx1,Ry1, Rx2,Ry2, Rx3,Ry3, this->trunk_color, false);
+list.add_line(c_trunk_bl.get_x(), c_trunk_bl.get_y(),
+              c_trunk_br.get_x(), c_trunk_br.get_y(),
+              this->trunk_color, false);
+list.add_line(c_trunk_tl.get_x(), c_trunk_tl.get_y(),
+              c_trunk_tr.get_x(), c_trunk_tr.get_y(),
+              this->trunk_color, false);
 
     // --- FOLHAS ---
     double rx1_u = 0.38 * this->width, ry1_u = 0.22 * this->height;
@@ -221,7 +202,7 @@ Primitives::draw_line(surface, c_trunk_tl.get_x(), c_trunk_tl.get_y(),
     rx_px = (int)lround(hypot(tmp.get_x() - c_leaves1.get_x(), tmp.get_y() - c_leaves1.get_y()));
     ry_px = (int)lround(hypot(tmp2.get_x() - c_leaves1.get_x(), tmp2.get_y() - c_leaves1.get_y()));
     ang = atan2(tmp.get_y() - c_leaves1.get_y(), tmp.get_x() - c_leaves1.get_x());
-    Primitives::draw_rotated_ellipse(surface, c_leaves1.get_x(), c_leaves1.get_y(), rx_px, ry_px, ang, this->leaves_color, true);
+    list.add_rotated_ellipse(c_leaves1.get_x(), c_leaves1.get_y(), rx_px, ry_px, ang, this->leaves_color, true);
 
     // Elipse 2 (esquerda)
     // [CORREO] Usar o ponto original do universo (this->...) para o clculo.
@@ -230,7 +211,7 @@ Primitives::draw_line(surface, c_trunk_tl.get_x(), c_trunk_tl.get_y(),
     rx_px = (int)lround(hypot(tmp.get_x() - c_leaves2.get_x(), tmp.get_y() - c_leaves2.get_y()));
     ry_px = (int)lround(hypot(tmp2.get_x() - c_leaves2.get_x(), tmp2.get_y() - c_leaves2.get_y()));
     ang = atan2(tmp.get_y() - c_leaves2.get_y(), tmp.get_x() - c_leaves2.get_x());
-    Primitives::draw_rotated_ellipse(surface, c_leaves2.get_x(), c_leaves2.get_y(), rx_px, ry_px, ang, this->leaves_color, true);
+    list.add_rotated_ellipse(c_leaves2.get_x(), c_leaves2.get_y(), rx_px, ry_px, ang, this->leaves_color, true);
 
     // Elipse 3 (direita)
     // [CORREO] Usar o ponto original do universo (this->...) para o clculo.
@@ -239,7 +220,7 @@ Primitives::draw_line(surface, c_trunk_tl.get_x(), c_trunk_tl.get_y(),
     rx_px = (int)lround(hypot(tmp.get_x() - c_leaves3.get_x(), tmp.get_y() - c_leaves3.get_y()));
     ry_px = (int)lround(hypot(tmp2.get_x() - c_leaves3.get_x(), tmp2.get_y() - c_leaves3.get_y()));
     ang = atan2(tmp.get_y() - c_leaves3.get_y(), tmp.get_x() - c_leaves3.get_x());
-    Primitives::draw_rotated_ellipse(surface, c_leaves3.get_x(), c_leaves3.get_y(), rx_px, ry_px, ang, this->leaves_color, true);
+    list.add_rotated_ellipse(c_leaves3.get_x(), c_leaves3.get_y(), rx_px, ry_px, ang, this->leaves_color, true);
 
     /*
 */
@@ -253,8 +234,18 @@ Primitives::draw_line(surface, c_trunk_tl.get_x(), c_trunk_tl.get_y(),
 
     if (r_px <= 0) r_px = 1; // segurana
 
-    Primitives::draw_circle(surface, c_apple1.get_x(), c_apple1.get_y(), r_px, this->apple_color, true, true);
-    Primitives::draw_circle(surface, c_apple2.get_x(), c_apple2.get_y(), r_px, this->apple_color, true, true);
+    list.add_circle(c_apple1.get_x(), c_apple1.get_y(), r_px, this->apple_color, true, true);
+    list.add_circle(c_apple2.get_x(), c_apple2.get_y(), r_px, this->apple_color, true, true);
 
 }
 
+
+SDL_Rect Tree::get_canvas_bounds(int canvas_w, int canvas_h) {
+    // O tronco fica dentro do fecho convexo dos pontos de controle; as folhas
+    // (elipses rotacionadas) podem passar dos centros pelo maior raio.
+    const double leaves_u = std::max(0.38 * std::fabs(this->width), 0.22 * std::fabs(this->height));
+    const double px_per_u = std::max((double)canvas_w / App::universe_width, (double)canvas_h / App::universe_height);
+    const int padding = (int)std::ceil(leaves_u * px_per_u) + 4;
+
+    return Utils::canvas_bounds(this->pts.data(), (int)this->pts.size(), padding, canvas_w, canvas_h, App::universe_width, App::universe_height);
+}